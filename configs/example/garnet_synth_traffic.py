@@ -83,6 +83,23 @@ parser.add_option("--inj-vnet", type="int", default=-1,
                         0 and 1 are 1-flit, 2 is 5-flit.\
                         Set to -1 to inject randomly in all vnets.")
 
+parser.add_option("--task-graph-checkpoint", type="int", default=0,
+                  metavar="TICK",
+                  help="Drain the network at TICK, write a checkpoint of\
+                        the task graph simulation in --checkpoint-dir and\
+                        exit. Set to 0 to disable.")
+
+parser.add_option("--checkpoint-dir", type="string", default=None,
+                  help="Directory of the --task-graph-checkpoint\
+                        checkpoint, m5out/cpt.TICK by default.")
+
+parser.add_option("--task-graph-restore", type="string", default=None,
+                  metavar="DIR",
+                  help="Restore the task graph simulation from the\
+                        checkpoint in DIR. The VCs, --in-mem-size,\
+                        --out-mem-size and the iterations of the\
+                        applications may differ from the saved run.")
+
 #
 # Add the ruby specific and protocol specific options
 #
@@ -147,8 +164,21 @@ root.system.mem_mode = 'timing'
 # Not much point in this being higher than the L1 latency
 m5.ticks.setGlobalFrequency('1ns')
 
-# instantiate configuration
-m5.instantiate()
+# instantiate configuration, from a checkpoint if there is one
+m5.instantiate(options.task_graph_restore)
+
+if options.task_graph_checkpoint > 0:
+    exit_event = m5.simulate(options.task_graph_checkpoint - m5.curTick())
+    if exit_event.getCause() != "simulate() limit reached":
+        print('Exiting @ tick', m5.curTick(), 'because',
+              exit_event.getCause())
+        sys.exit(0)
+    cpt_dir = options.checkpoint_dir
+    if cpt_dir is None:
+        cpt_dir = os.path.join(m5.options.outdir, "cpt.%d" % m5.curTick())
+    m5.checkpoint(cpt_dir)
+    print('Checkpoint written to', cpt_dir, '@ tick', m5.curTick())
+    sys.exit(0)
 
 # simulate until program terminates
 exit_event = m5.simulate(options.abs_max_tick)
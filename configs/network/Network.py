@@ -35,6 +35,8 @@ from m5.objects import *
 from m5.defines import buildEnv
 from m5.util import addToPath, fatal
 
+from common import ObjectList
+
 def define_options(parser):
     # By default, ruby uses the simple timing cpu
     parser.set_defaults(cpu_type="TimingSimpleCPU")
@@ -50,6 +52,59 @@ def define_options(parser):
                       default=False, help="enable network task graph traffic")
     parser.add_option("--task-graph-file", type="string", default=" ",
                        help="name of task graph file")
+    parser.add_option("--task-graph-event-driven", action="store_true",
+                      default=False, help="""wake the task graph network
+                      interfaces only when a task, flit or token event is
+                      due instead of every cycle""")
+    parser.add_option("--task-graph-seed", type="int", default=0,
+                      help="""seed of the task graph random numbers, runs
+                      with the same non-zero seed are repeatable. 0 seeds
+                      from the wall clock""")
+    parser.add_option("--task-graph-quiet-load", action="store_true",
+                      default=False, help="""do not print the node
+                      configuration and the tasks of every core when
+                      loading the task graph""")
+    parser.add_option("--task-graph-stats-window", type="int", default=0,
+                      help="""keep the start/end times of only the last N
+                      iterations of every application and report the
+                      iteration delay through streaming stats, so that
+                      long runs use constant memory. N must cover the
+                      iterations in flight. 0 keeps every iteration""")
+    parser.add_option("--task-graph-sample-interval", type="int",
+                      default=10000, help="""cycles between two rows of
+                      task_graph_time_series.csv (per application
+                      throughput, flit latency, link utilization and NI
+                      queue depth). 0 disables it""")
+    parser.add_option("--task-graph-ci-precision", type="float", default=0.0,
+                      help="""stop the run once every application is in
+                      steady state: the warm-up is cut with MSER and the
+                      95% confidence half width of the batch means of the
+                      iteration delay and throughput is within this
+                      fraction of the mean (e.g. 0.05). The iteration
+                      counts of the task graph file stay upper bounds.
+                      0 runs every iteration""")
+    parser.add_option("--task-mapping-search-moves", type="int", default=0,
+                      help="""search the task to core mapping before the
+                      run: cores of the same kind and threads trade their
+                      tasks to lower the hops times the token size of the
+                      edges, with this many simulated annealing moves per
+                      thread. The best mapping is simulated and written to
+                      the output directory as <application>_mapped.stp
+                      with a task_mapping.cfg. 0 keeps the mapping of the
+                      task graph file""")
+    parser.add_option("--task-mapping-search-threads", type="int",
+                      default=1, help="""host threads of the mapping
+                      search, each one anneals its own mapping from the
+                      task graph seed and the best one is kept""")
+    parser.add_option("--analytical-network", action="store_true",
+                      default=False, help="""task graph pkts skip the
+                      routers and take the latency of an M/D/1 queue per
+                      link, for fast design space exploration""")
+    parser.add_option("--task-graph-dram", action="store_true",
+                      default=False, help="""the DDR cores of the
+                      architecture file take the time of their token
+                      reads and writes to a --mem-type controller each,
+                      instead of their mean/sigma execution times""")
     parser.add_option("--token-packet-length", type="int", default=8,
                        help="the token size in flits generated by task")
     parser.add_option("--architecture-file", type="string", default=" ",
@@ -83,7 +138,41 @@ def define_options(parser):
                       help="""routing algorithm in network.
                             0: weight-based table
                             1: XY (for Mesh. see garnet2.0/RoutingUnit.cc)
-                            2: Custom (see garnet2.0/RoutingUnit.cc""")
+                            2: Custom (see garnet2.0/RoutingUnit.cc
+                            3: West-first adaptive (for Mesh)
+                            4: Odd-even adaptive (for Mesh)
+                            5: Shortest direction with dateline VCs
+                               (for Ring)""")
+    parser.add_option("--switch-allocator", action="store", type="int",
+                      default=0,
+                      help="""switch allocator of the garnet routers.
+                            0: separable input-first round robin
+                            1: iSLIP (iterative, see
+                               garnet2.0/SwitchAllocator.cc)
+                            2: wavefront""")
+    parser.add_option("--lookahead-routing", action="store_true",
+                      default=False,
+                      help="""garnet2.0: route packets one router ahead,
+                      while they traverse the link, which removes the
+                      route computation stage of --router-latency""")
+    parser.add_option("--router-bypass", action="store_true",
+                      default=False,
+                      help="""garnet2.0: a flit that finds its input
+                      port and its output port free goes through the
+                      router in one cycle. Needs --lookahead-routing""")
+    parser.add_option("--smart-hpc-max", action="store", type="int",
+                      default=1,
+                      help="""garnet2.0 SMART: a flit going straight
+                      through idle routers covers up to this many hops in
+                      one cycle (HPC_max). 1 disables it. Needs
+                      --lookahead-routing""")
+    parser.add_option("--garnet-router-threads", action="store", type="int",
+                      default=1,
+                      help="""host threads evaluating the garnet routers
+                      of one cycle in parallel. The results do not depend
+                      on it, peak_live_credits is only sampled once a
+                      cycle above 1 or with --smart-hpc-max or
+                      --router-bypass. 1 evaluates them one by one""")
     parser.add_option("--network-fault-model", action="store_true",
                       default=False,
                       help="""enable network fault model:
@@ -124,6 +213,22 @@ def create_network(options, ruby):
 
     return (network, IntLinkClass, ExtLinkClass, RouterClass, InterfaceClass)
 
+def count_ddr_cores(architecture_file):
+    # the architecture file has the number of nodes, then for every node
+    # its id and number of cores, and the id, name and threads of each core
+    words = open(architecture_file).read().split()
+    num_nodes = int(words[0])
+    pos = 1
+    num_ddr_cores = 0
+    for i in range(num_nodes):
+        num_cores = int(words[pos + 1])
+        pos += 2
+        for j in range(num_cores):
+            if words[pos + 1].split('-')[0] == "DDR":
+                num_ddr_cores += 1
+            pos += 3
+    return num_ddr_cores
+
 def init_network(options, network, InterfaceClass):
 
     if options.network == "garnet2.0":
@@ -132,9 +237,38 @@ def init_network(options, network, InterfaceClass):
         network.vcs_for_allocation = options.vcs_for_allocation
         network.ni_flit_size = options.link_width_bits / 8
         network.routing_algorithm = options.routing_algorithm
+        network.switch_allocator = options.switch_allocator
+        network.lookahead_routing = options.lookahead_routing
+        network.router_bypass = options.router_bypass
+        network.smart_hpc_max = options.smart_hpc_max
+        network.router_threads = options.garnet_router_threads
         network.garnet_deadlock_threshold = options.garnet_deadlock_threshold
         network.task_graph_enable = options.network_task_graph_enable
         network.task_graph_file = options.task_graph_file
+        network.task_graph_event_driven = options.task_graph_event_driven
+        network.task_graph_seed = options.task_graph_seed
+        network.task_graph_quiet_load = options.task_graph_quiet_load
+        network.task_graph_stats_window = options.task_graph_stats_window
+        network.task_graph_sample_interval = \
+            options.task_graph_sample_interval
+        network.task_graph_ci_precision = options.task_graph_ci_precision
+        network.task_mapping_search_moves = \
+            options.task_mapping_search_moves
+        network.task_mapping_search_threads = \
+            options.task_mapping_search_threads
+        network.analytical_network = options.analytical_network
+        if options.task_graph_dram:
+            # the controllers are only reached through the ddr_port of
+            # the network, they hold no data and are out of the address map
+            mem_class = ObjectList.mem_list.get(options.mem_type)
+            num_ddr_cores = count_ddr_cores(options.architecture_file)
+            network.ddr_ctrls = [mem_class(range = AddrRange(options.mem_size),
+                                           null = True, in_addr_map = False,
+                                           kvm_map = False,
+                                           conf_table_reported = False)
+                                 for i in range(num_ddr_cores)]
+            for ctrl in network.ddr_ctrls:
+                network.ddr_port = ctrl.port
         network.token_packet_length = options.token_packet_length
         network.topology = options.topology
         network.architecture_file = options.architecture_file
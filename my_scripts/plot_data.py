@@ -75,6 +75,15 @@ class PlotFunction():
         if if_save:
             plt.savefig(dir+title+'.jpg')
 
+def read_time_series(dir_path):
+    """Columns of task_graph_time_series.csv, keyed by the header names
+    (cycle, <app>.throughput, avg_flit_latency, link<i>.utilization,
+    ni<i>.queue_depth)"""
+    data = np.loadtxt(dir_path + "/task_graph_time_series.csv", delimiter=",", skiprows=1, ndmin=2)
+    with open(dir_path + "/task_graph_time_series.csv") as csv_file:
+        header = csv_file.readline().strip().split(",")
+    return {name: data[:, i] for i, name in enumerate(header)}
+
 ############################################################################################################
 ##################################### Top Parameters Settings  #############################################
 if_plot_all = True
@@ -0,0 +1,107 @@
+#!/usr/bin/env python3
+### Multi-seed task graph sweep ###
+# Run N replicas of one task graph simulation with different
+# --task-graph-seed values on a pool of workers, then report the mean and
+# the 95% confidence interval of the ETE delay of every application.
+#
+# usage:
+#   run_seed_sweep.py --gem5 build/NULL/gem5.opt --outdir my_STATS/sweep \
+#       --replicas 16 --jobs 8 -- configs/example/garnet_synth_traffic.py \
+#       --topology=Ring --network=garnet2.0 --network-task-graph-enable ...
+#
+# Every replica writes to <outdir>/replica_<i>, with its own
+# application_delay_running_info.log and stats.txt.
+
+import argparse
+import math
+import os
+import subprocess
+import sys
+from concurrent.futures import ThreadPoolExecutor
+
+# two-sided 95% Student t quantiles, by degrees of freedom
+T_95 = [12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262,
+        2.228, 2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101,
+        2.093, 2.086, 2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052,
+        2.048, 2.045, 2.042]
+
+def t_95(dof):
+    if dof <= len(T_95):
+        return T_95[dof - 1]
+    return 1.960
+
+def run_replica(args, idx):
+    seed = args.seed_base + idx
+    outdir = os.path.join(args.outdir, "replica_%d" % idx)
+    os.makedirs(outdir, exist_ok=True)
+    cmd = [args.gem5, "--outdir", outdir] + args.config + \
+        ["--task-graph-seed=%d" % seed]
+    with open(os.path.join(outdir, "log"), "w") as log:
+        ret = subprocess.call(cmd, stdout=log, stderr=subprocess.STDOUT)
+    return idx, seed, ret, outdir
+
+def read_app_delay(outdir):
+    """Average ETE delay of each application in one replica"""
+    delays = {}
+    path = os.path.join(outdir, "application_delay_running_info.log")
+    with open(path) as f:
+        for line in f:
+            fields = line.split()
+            # Application Iteration Start_time End_time Execution_Delay
+            if len(fields) != 5 or not fields[4].lstrip('-').isdigit():
+                continue
+            delays.setdefault(fields[0], []).append(int(fields[4]))
+    return {app: float(sum(v)) / len(v) for app, v in delays.items()}
+
+def main():
+    parser = argparse.ArgumentParser(
+        description="multi-seed task graph sweep")
+    parser.add_argument("--gem5", required=True, help="gem5 binary")
+    parser.add_argument("--outdir", required=True)
+    parser.add_argument("--replicas", type=int, default=8)
+    parser.add_argument("--jobs", type=int, default=os.cpu_count())
+    parser.add_argument("--seed-base", type=int, default=1,
+                        help="replica i runs with seed seed_base + i")
+    parser.add_argument("config", nargs=argparse.REMAINDER,
+                        help="-- config script and its options")
+    args = parser.parse_args()
+    if args.config and args.config[0] == "--":
+        args.config = args.config[1:]
+    if not args.config:
+        parser.error("missing the config script")
+    if args.seed_base <= 0:
+        parser.error("seed 0 means a wall clock seed, use a positive base")
+
+    os.makedirs(args.outdir, exist_ok=True)
+    with ThreadPoolExecutor(max_workers=args.jobs) as pool:
+        results = list(pool.map(lambda i: run_replica(args, i),
+                                range(args.replicas)))
+
+    per_app = {}
+    for idx, seed, ret, outdir in results:
+        if ret != 0:
+            print("replica %d (seed %d) failed with %d, see %s/log" %
+                  (idx, seed, ret, outdir), file=sys.stderr)
+            continue
+        for app, delay in read_app_delay(outdir).items():
+            per_app.setdefault(app, []).append(delay)
+
+    summary = os.path.join(args.outdir, "ete_delay_summary.txt")
+    with open(summary, "w") as f:
+        f.write("Application\tReplicas\tMean_ETE_Delay\tCI95_Half_Width\n")
+        for app in sorted(per_app):
+            v = per_app[app]
+            n = len(v)
+            mean = sum(v) / n
+            half = 0.0
+            if n > 1:
+                var = sum((x - mean) ** 2 for x in v) / (n - 1)
+                half = t_95(n - 1) * math.sqrt(var / n)
+            f.write("%s\t%d\t%.2f\t%.2f\n" % (app, n, mean, half))
+    with open(summary) as f:
+        sys.stdout.write(f.read())
+
+    return 0 if all(r[2] == 0 for r in results) else 1
+
+if __name__ == "__main__":
+    sys.exit(main())
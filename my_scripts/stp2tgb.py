@@ -0,0 +1,109 @@
+#!/usr/bin/env python3
+### Task graph .stp to .tgb converter ###
+# Pre-compile task graph applications to the binary format GarnetNetwork
+# maps at startup (see src/mem/ruby/network/garnet2.0/TaskGraphBinary.hh).
+#
+# usage:
+#   stp2tgb.py Application_01.stp ...        writes Application_01.tgb ...
+#   stp2tgb.py multi_application_01.cfg ...  converts every application of
+#       the config and writes multi_application_01_tgb.cfg next to it, use
+#       that one as --task-graph-file
+
+import os
+import struct
+import sys
+
+MAGIC = b"GEM5TGB\0"
+VERSION = 1
+HEADER_LINES = 15
+NUM_EDGE_INT_FIELDS = 9
+
+def read_stp(filename):
+    with open(filename) as f:
+        lines = f.readlines()
+    tokens = " ".join(lines[HEADER_LINES:]).split()
+    pos = [0]
+
+    def next_int():
+        pos[0] += 1
+        return int(tokens[pos[0] - 1])
+
+    def next_float():
+        pos[0] += 1
+        return float(tokens[pos[0] - 1])
+
+    trace_type = next_int()
+    assert trace_type == 0, "%s: unknown trace type %d" % (filename, trace_type)
+    num_proc, num_task, num_edge = next_int(), next_int(), next_int()
+    head = [next_int() for i in range(next_int())]
+
+    tasks = []
+    for i in range(num_task):
+        tasks.append((next_int(), next_int(), next_int(),
+                      next_float(), next_float()))
+    edges = []
+    for i in range(num_edge):
+        edges.append(tuple(next_int() for j in range(NUM_EDGE_INT_FIELDS)) +
+                     (next_float(), next_float(), next_float()))
+    return num_proc, head, tasks, edges
+
+def write_tgb(filename, num_proc, head, tasks, edges):
+    out = bytearray(struct.pack("<8sIiiiiI", MAGIC, VERSION, num_proc,
+                                len(tasks), len(edges), len(head), 0))
+
+    def array(fmt, values):
+        out.extend(b"\0" * (-len(out) % 8))
+        out.extend(struct.pack("<%d%s" % (len(values), fmt), *values))
+
+    array("i", head)
+    for field in range(3):
+        array("i", [t[field] for t in tasks])
+    for field in range(3, 5):
+        array("f", [t[field] for t in tasks])
+    for field in range(NUM_EDGE_INT_FIELDS):
+        array("i", [e[field] for e in edges])
+    for field in range(NUM_EDGE_INT_FIELDS, NUM_EDGE_INT_FIELDS + 3):
+        array("f", [e[field] for e in edges])
+
+    with open(filename, "wb") as f:
+        f.write(out)
+
+def convert_stp(stp):
+    tgb = os.path.splitext(stp)[0] + ".tgb"
+    num_proc, head, tasks, edges = read_stp(stp)
+    write_tgb(tgb, num_proc, head, tasks, edges)
+    print("%s: %d tasks, %d edges -> %s" % (stp, len(tasks), len(edges), tgb))
+    return tgb
+
+def convert_cfg(cfg):
+    with open(cfg) as f:
+        tokens = f.read().split()
+    num_app, total_iters = int(tokens[0]), int(tokens[1])
+    dir_name = os.path.dirname(cfg)
+    apps = []
+    for i in range(num_app):
+        name, iters = tokens[2 + 2 * i], tokens[3 + 2 * i]
+        tgb = convert_stp(os.path.join(dir_name, name))
+        apps.append((os.path.basename(tgb), iters))
+
+    new_cfg = os.path.splitext(cfg)[0] + "_tgb.cfg"
+    with open(new_cfg, "w") as f:
+        f.write("%d %d\n" % (num_app, total_iters))
+        for name, iters in apps:
+            f.write("%s %s\n" % (name, iters))
+    print("%s -> %s" % (cfg, new_cfg))
+
+def main():
+    if len(sys.argv) < 2:
+        print("usage: %s [file.stp | multi_application.cfg] ..." %
+              sys.argv[0], file=sys.stderr)
+        return 2
+    for filename in sys.argv[1:]:
+        if filename.endswith(".cfg"):
+            convert_cfg(filename)
+        else:
+            convert_stp(filename)
+    return 0
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -96,7 +96,6 @@ GarnetSyntheticTraffic::GarnetSyntheticTraffic(const Params *p)
 {
     // set up counters
     noResponseCycles = 0;
-    schedule(tickEvent, 0);
 
     initTrafficType();
     if (trafficStringToEnum.count(trafficType) == 0) {
@@ -124,6 +123,13 @@ GarnetSyntheticTraffic::init()
     numPacketsSent = 0;
 }
 
+void
+GarnetSyntheticTraffic::startup()
+{
+    // not in the constructor, a restored checkpoint starts later than 0
+    schedule(tickEvent, curTick());
+}
+
 
 void
 GarnetSyntheticTraffic::completeRequest(PacketPtr pkt)
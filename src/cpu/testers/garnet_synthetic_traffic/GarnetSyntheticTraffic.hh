@@ -60,6 +60,7 @@ class GarnetSyntheticTraffic : public ClockedObject
     GarnetSyntheticTraffic(const Params *p);
 
     void init() override;
+    void startup() override;
 
     // main simulation loop (one cycle)
     void tick();
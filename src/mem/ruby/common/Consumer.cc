@@ -30,6 +30,59 @@
 
 using namespace std;
 
+Consumer::WakeupEvent::WakeupEvent(Consumer *_consumer)
+    : consumer(_consumer), nextFree(NULL)
+{
+    setFlags(Managed);
+}
+
+void
+Consumer::WakeupEvent::process()
+{
+    if (consumer != NULL)
+        consumer->wakeup();
+}
+
+void
+Consumer::WakeupEvent::releaseImpl()
+{
+    // the wakeup may have scheduled this event again
+    if (scheduled())
+        return;
+    if (consumer == NULL) {
+        delete this;
+        return;
+    }
+    nextFree = consumer->m_free_events;
+    consumer->m_free_events = this;
+}
+
+Consumer::~Consumer()
+{
+    // the events still in the event queue delete themselves once they
+    // are released, the others can go now
+    for (WakeupEvent *evt : m_events) {
+        if (evt->scheduled())
+            evt->consumer = NULL;
+        else
+            delete evt;
+    }
+}
+
+Consumer::WakeupEvent *
+Consumer::allocWakeupEvent()
+{
+    WakeupEvent *evt = m_free_events;
+    if (evt != NULL) {
+        m_free_events = evt->nextFree;
+        evt->nextFree = NULL;
+        return evt;
+    }
+    evt = new WakeupEvent(this);
+    m_events.push_back(evt);
+    return evt;
+}
+
 void
 Consumer::scheduleEvent(Cycles timeDelta)
 {
@@ -41,15 +94,12 @@ Consumer::scheduleEventAbsolute(Tick evt_time)
 {
     if (!alreadyScheduled(evt_time)) {
         // This wakeup is not redundant
-        auto *evt = new EventFunctionWrapper(
-            [this]{ wakeup(); }, "Consumer Event", true);
-
-        em->schedule(evt, evt_time);
+        em->schedule(allocWakeupEvent(), evt_time);
         insertScheduledWakeupTime(evt_time);
     }
 
     Tick t = em->clockEdge();
-    set<Tick>::iterator bit = m_scheduled_wakeups.begin();
-    set<Tick>::iterator eit = m_scheduled_wakeups.lower_bound(t);
-    m_scheduled_wakeups.erase(bit,eit);
+    vector<Tick>::iterator eit =
+        lower_bound(m_scheduled_wakeups.begin(), m_scheduled_wakeups.end(), t);
+    m_scheduled_wakeups.erase(m_scheduled_wakeups.begin(), eit);
 }
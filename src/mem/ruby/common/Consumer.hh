@@ -29,14 +29,15 @@
 /*
  * This is the virtual base class of all classes that can be the
  * targets of wakeup events.  There is only two methods, wakeup() and
- * print() and no data members.
+ * print(), the wakeup events themselves are pooled per consumer.
  */
 
 #ifndef __MEM_RUBY_COMMON_CONSUMER_HH__
 #define __MEM_RUBY_COMMON_CONSUMER_HH__
 
+#include <algorithm>
 #include <iostream>
-#include <set>
+#include <vector>
 
 #include "sim/clocked_object.hh"
 
@@ -44,13 +45,12 @@ class Consumer
 {
   public:
     Consumer(ClockedObject *_em)
-        : em(_em)
+        : em(_em), m_free_events(NULL)
     {
+        m_scheduled_wakeups.reserve(4);
     }
 
-    virtual
-    ~Consumer()
-    { }
+    virtual ~Consumer();
 
     virtual void wakeup() = 0;
     virtual void print(std::ostream& out) const = 0;
@@ -59,13 +59,18 @@ class Consumer
     bool
     alreadyScheduled(Tick time)
     {
-        return m_scheduled_wakeups.find(time) != m_scheduled_wakeups.end();
+        return std::binary_search(m_scheduled_wakeups.begin(),
+                                  m_scheduled_wakeups.end(), time);
     }
 
     void
     insertScheduledWakeupTime(Tick time)
     {
-        m_scheduled_wakeups.insert(time);
+        std::vector<Tick>::iterator it =
+            std::lower_bound(m_scheduled_wakeups.begin(),
+                             m_scheduled_wakeups.end(), time);
+        if (it == m_scheduled_wakeups.end() || *it != time)
+            m_scheduled_wakeups.insert(it, time);
     }
 
   //absolute time
@@ -76,8 +81,36 @@ class Consumer
     void scheduleEvent(Cycles timeDelta);
 
   private:
-    std::set<Tick> m_scheduled_wakeups;
+    /**
+     * Wakeup event owned by the consumer. It goes back to the free list
+     * of the consumer when the event queue releases it, so scheduling a
+     * wakeup does not allocate once the pool has grown to the number of
+     * wakeups pending at the same time.
+     */
+    class WakeupEvent : public Event
+    {
+      public:
+        WakeupEvent(Consumer *_consumer);
+
+        void process() override;
+        const char *description() const override { return "Consumer Event"; }
+
+        // NULL once the consumer is gone
+        Consumer *consumer;
+        WakeupEvent *nextFree;
+
+      protected:
+        void releaseImpl() override;
+    };
+
+    WakeupEvent *allocWakeupEvent();
+
+    // pending wakeup times, sorted, the ones before the current cycle are
+    // dropped on the next schedule
+    std::vector<Tick> m_scheduled_wakeups;
     ClockedObject *em;
+    std::vector<WakeupEvent *> m_events;
+    WakeupEvent *m_free_events;
 };
 
 inline std::ostream&
@@ -0,0 +1,98 @@
+#include "mem/ruby/network/garnet2.0/AnalyticalNetworkModel.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include "mem/ruby/network/garnet2.0/NetworkLink.hh"
+
+AnalyticalNetworkModel::AnalyticalNetworkModel(int num_nis)
+    : m_num_nis(num_nis), m_paths(num_nis * num_nis),
+      m_zero_load_latency(num_nis * num_nis, Cycles(0)),
+      m_window_start(0), m_peak_utilization(0), m_peak_link(-1)
+{
+}
+
+int
+AnalyticalNetworkModel::linkIndex(NetworkLink *link)
+{
+    std::map<NetworkLink *, int>::iterator it = m_link_index.find(link);
+    if (it != m_link_index.end())
+        return it->second;
+    int idx = m_links.size();
+    m_link_index[link] = idx;
+    m_links.push_back(link);
+    m_utilization.push_back(0);
+    m_mean_flits.push_back(0);
+    m_window_flits.push_back(0);
+    m_window_pkts.push_back(0);
+    return idx;
+}
+
+void
+AnalyticalNetworkModel::setPath(int src, int dst,
+    const std::vector<NetworkLink *> &links, Cycles router_latency)
+{
+    std::vector<int> &path = m_paths[src * m_num_nis + dst];
+    Cycles latency = router_latency;
+    path.clear();
+    for (int i = 0; i < links.size(); i++) {
+        path.push_back(linkIndex(links[i]));
+        latency += links[i]->getLatency();
+    }
+    m_zero_load_latency[src * m_num_nis + dst] = latency;
+}
+
+void
+AnalyticalNetworkModel::updateUtilization(Cycles now)
+{
+    if (now < m_window_start + Cycles(window_cycles))
+        return;
+    double elapsed = now - m_window_start;
+    for (int i = 0; i < m_links.size(); i++) {
+        m_utilization[i] =
+            (m_utilization[i] + m_window_flits[i] / elapsed) / 2;
+        //a link idle over the window keeps the pkt size it had
+        if (m_window_pkts[i] > 0) {
+            double mean = (double)m_window_flits[i] / m_window_pkts[i];
+            m_mean_flits[i] = m_mean_flits[i] == 0 ? mean :
+                (m_mean_flits[i] + mean) / 2;
+        }
+        m_window_flits[i] = 0;
+        m_window_pkts[i] = 0;
+        if (m_utilization[i] > m_peak_utilization) {
+            m_peak_utilization = m_utilization[i];
+            m_peak_link = m_links[i]->get_id();
+        }
+    }
+    m_window_start = now;
+}
+
+Cycles
+AnalyticalNetworkModel::send(int src, int dst, int num_flits, Cycles now,
+    int &hops)
+{
+    assert(src != dst);
+    updateUtilization(now);
+
+    const std::vector<int> &path = m_paths[src * m_num_nis + dst];
+    assert(!path.empty());
+    //an injection and an ejection link around the internal ones
+    hops = path.size() - 1;
+
+    double wait = 0;
+    for (int i = 0; i < path.size(); i++) {
+        int l = path[i];
+        //the M/D/1 wait grows without bound at rho = 1, a saturated link
+        //is held just below it
+        double rho = std::min(m_utilization[l], 0.95);
+        //the queue ahead is made of the pkts of the link, not of copies
+        //of this one
+        wait += rho * m_mean_flits[l] / (2 * (1 - rho));
+        m_window_flits[l] += num_flits;
+        m_window_pkts[l]++;
+        m_links[l]->addAnalyticalUtilization(num_flits);
+    }
+    return m_zero_load_latency[src * m_num_nis + dst] +
+        Cycles(num_flits - 1) + Cycles((uint64_t)round(wait));
+}
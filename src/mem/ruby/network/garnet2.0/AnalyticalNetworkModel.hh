@@ -0,0 +1,62 @@
+#ifndef __MEM_RUBY_NETWORK_GARNET2_0_ANALYTICAL_NETWORK_MODEL_HH__
+#define __MEM_RUBY_NETWORK_GARNET2_0_ANALYTICAL_NETWORK_MODEL_HH__
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "base/types.hh"
+
+class NetworkLink;
+
+// Latency of the task graph pkts without simulating the routers and VCs
+// (--analytical-network). A pkt goes along the shortest path of links
+// between two NIs and takes the zero load latency of the path (link
+// latencies, router pipelines, serialization of its flits) plus, on every
+// link, the M/D/1 wait rho * S / (2 * (1 - rho)) of a link of utilization
+// rho whose pkts take S flits on average. The utilization of a link is the
+// flits the model sent over it per cycle, and S the flits per pkt it
+// sent, both smoothed over windows of window_cycles.
+// Above utilization_limit the M/D/1 wait underestimates the wormhole
+// contention, runs that reach it deserve a cycle accurate run.
+class AnalyticalNetworkModel
+{
+  public:
+    AnalyticalNetworkModel(int num_nis);
+
+    static const int window_cycles = 1000;
+    static constexpr double utilization_limit = 0.6;
+
+    // the links from NI src to NI dst, and the pipeline cycles of the
+    // routers on the way
+    void setPath(int src, int dst, const std::vector<NetworkLink *> &links,
+        Cycles router_latency);
+
+    // cycles a pkt of num_flits flits sent now takes from NI src to NI
+    // dst, hops is set to the routers it goes through
+    Cycles send(int src, int dst, int num_flits, Cycles now, int &hops);
+
+    // highest utilization of a link over a window, and that link
+    double getPeakUtilization() const { return m_peak_utilization; }
+    int getPeakLink() const { return m_peak_link; }
+
+  private:
+    int linkIndex(NetworkLink *link);
+    void updateUtilization(Cycles now);
+
+    int m_num_nis;
+    std::vector<NetworkLink *> m_links;
+    std::map<NetworkLink *, int> m_link_index;
+    std::vector<double> m_utilization;
+    std::vector<double> m_mean_flits;
+    std::vector<uint64_t> m_window_flits;
+    std::vector<uint64_t> m_window_pkts;
+    //[src * m_num_nis + dst]
+    std::vector<std::vector<int> > m_paths;
+    std::vector<Cycles> m_zero_load_latency;
+    Cycles m_window_start;
+    double m_peak_utilization;
+    int m_peak_link;
+};
+
+#endif // __MEM_RUBY_NETWORK_GARNET2_0_ANALYTICAL_NETWORK_MODEL_HH__
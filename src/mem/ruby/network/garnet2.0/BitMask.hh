@@ -0,0 +1,104 @@
+#ifndef __MEM_RUBY_NETWORK_GARNET2_0_BIT_MASK_HH__
+#define __MEM_RUBY_NETWORK_GARNET2_0_BIT_MASK_HH__
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include "base/bitfield.hh"
+
+// Fixed size set of small integers (VCs, ports) kept as 64 bit words, so
+// that the allocators look at the members with find-first-set instead of
+// testing every index. A router rarely has more than 64 VCs or ports and
+// then everything stays in one word.
+class BitMask
+{
+  public:
+    BitMask() : m_size(0) {}
+    explicit BitMask(int size) { resize(size); }
+
+    void
+    resize(int size)
+    {
+        m_size = size;
+        m_words.assign((size + 63) / 64, 0);
+    }
+    int size() const { return m_size; }
+
+    void
+    set(int i)
+    {
+        assert(i >= 0 && i < m_size);
+        m_words[i >> 6] |= (uint64_t)1 << (i & 63);
+    }
+    void
+    clear(int i)
+    {
+        assert(i >= 0 && i < m_size);
+        m_words[i >> 6] &= ~((uint64_t)1 << (i & 63));
+    }
+    bool
+    test(int i) const
+    {
+        assert(i >= 0 && i < m_size);
+        return (m_words[i >> 6] >> (i & 63)) & 1;
+    }
+    void
+    clearAll()
+    {
+        for (int w = 0; w < m_words.size(); w++)
+            m_words[w] = 0;
+    }
+
+    bool
+    none() const
+    {
+        for (int w = 0; w < m_words.size(); w++)
+            if (m_words[w] != 0)
+                return false;
+        return true;
+    }
+    int
+    count() const
+    {
+        int n = 0;
+        for (int w = 0; w < m_words.size(); w++)
+            n += popCount(m_words[w]);
+        return n;
+    }
+
+    // lowest member in [begin, end), -1 if there is none
+    int
+    findFirstIn(int begin, int end) const
+    {
+        if (begin >= end)
+            return -1;
+        int w = begin >> 6;
+        int last = (end - 1) >> 6;
+        uint64_t word = m_words[w] & (~(uint64_t)0 << (begin & 63));
+        while (true) {
+            if (w == last && (end & 63) != 0)
+                word &= ~(~(uint64_t)0 << (end & 63));
+            if (word != 0)
+                return (w << 6) + __builtin_ctzll(word);
+            if (++w > last)
+                return -1;
+            word = m_words[w];
+        }
+    }
+
+    // first member at or after start going round the mask, which is how
+    // the round robin arbiters pick, -1 if the mask is empty
+    int
+    findNext(int start) const
+    {
+        int i = findFirstIn(start, m_size);
+        return (i >= 0) ? i : findFirstIn(0, start);
+    }
+
+  private:
+    int m_size;
+    std::vector<uint64_t> m_words;
+};
+
+#endif // __MEM_RUBY_NETWORK_GARNET2_0_BIT_MASK_HH__
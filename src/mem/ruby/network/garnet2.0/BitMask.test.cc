@@ -0,0 +1,97 @@
+#include <gtest/gtest.h>
+
+#include "mem/ruby/network/garnet2.0/BitMask.hh"
+
+TEST(BitMaskTest, SetClear)
+{
+    BitMask mask(70);
+    EXPECT_EQ(70, mask.size());
+    EXPECT_TRUE(mask.none());
+
+    mask.set(0);
+    mask.set(63);
+    mask.set(64);
+    mask.set(69);
+    EXPECT_FALSE(mask.none());
+    EXPECT_EQ(4, mask.count());
+    EXPECT_TRUE(mask.test(63));
+    EXPECT_TRUE(mask.test(64));
+    EXPECT_FALSE(mask.test(1));
+
+    mask.clear(63);
+    EXPECT_FALSE(mask.test(63));
+    EXPECT_EQ(3, mask.count());
+
+    mask.clearAll();
+    EXPECT_TRUE(mask.none());
+    EXPECT_EQ(0, mask.count());
+}
+
+TEST(BitMaskTest, FindFirstIn)
+{
+    BitMask mask(8);
+    EXPECT_EQ(-1, mask.findFirstIn(0, 8));
+
+    mask.set(2);
+    mask.set(5);
+    EXPECT_EQ(2, mask.findFirstIn(0, 8));
+    EXPECT_EQ(2, mask.findFirstIn(2, 8));
+    EXPECT_EQ(5, mask.findFirstIn(3, 8));
+    EXPECT_EQ(-1, mask.findFirstIn(6, 8));
+    // the end is excluded
+    EXPECT_EQ(-1, mask.findFirstIn(3, 5));
+    EXPECT_EQ(-1, mask.findFirstIn(4, 4));
+    EXPECT_EQ(-1, mask.findFirstIn(5, 3));
+}
+
+TEST(BitMaskTest, FindFirstInAcrossWords)
+{
+    BitMask mask(200);
+    mask.set(63);
+    mask.set(64);
+    mask.set(190);
+
+    EXPECT_EQ(63, mask.findFirstIn(0, 200));
+    EXPECT_EQ(64, mask.findFirstIn(64, 200));
+    // a whole empty word in the way
+    EXPECT_EQ(190, mask.findFirstIn(65, 200));
+    EXPECT_EQ(-1, mask.findFirstIn(65, 190));
+    EXPECT_EQ(190, mask.findFirstIn(130, 191));
+    // an end on a word boundary
+    EXPECT_EQ(63, mask.findFirstIn(10, 64));
+    EXPECT_EQ(-1, mask.findFirstIn(0, 63));
+}
+
+TEST(BitMaskTest, FindNextWrapsAround)
+{
+    BitMask mask(10);
+    EXPECT_EQ(-1, mask.findNext(0));
+
+    mask.set(1);
+    mask.set(7);
+    EXPECT_EQ(1, mask.findNext(0));
+    EXPECT_EQ(1, mask.findNext(1));
+    EXPECT_EQ(7, mask.findNext(2));
+    EXPECT_EQ(7, mask.findNext(7));
+    // nothing after the start, go round to the lowest member
+    EXPECT_EQ(1, mask.findNext(8));
+    EXPECT_EQ(1, mask.findNext(9));
+
+    mask.clear(1);
+    EXPECT_EQ(7, mask.findNext(8));
+    EXPECT_EQ(7, mask.findNext(0));
+}
+
+TEST(BitMaskTest, FindNextWrapsAcrossWords)
+{
+    BitMask mask(130);
+    mask.set(3);
+    mask.set(129);
+
+    EXPECT_EQ(129, mask.findNext(4));
+    EXPECT_EQ(129, mask.findNext(129));
+
+    mask.clear(129);
+    EXPECT_EQ(3, mask.findNext(4));
+    EXPECT_EQ(3, mask.findNext(100));
+}
@@ -44,14 +44,18 @@ enum VNET_type {CTRL_VNET_, DATA_VNET_, NULL_VNET_, NUM_VNET_TYPE_};
 enum flit_stage {I_, VA_, SA_, ST_, LT_, NUM_FLIT_STAGE_};
 enum link_type { EXT_IN_, EXT_OUT_, INT_, NUM_LINK_TYPES_ };
 enum RoutingAlgorithm { TABLE_ = 0, XY_ = 1, CUSTOM_ = 2,
+                        WEST_FIRST_ = 3, ODD_EVEN_ = 4, RING_ = 5,
                         NUM_ROUTING_ALGORITHM_};
+enum SwitchAllocatorType { SEPARABLE_ = 0, ISLIP_ = 1, WAVEFRONT_ = 2,
+                           NUM_SWITCH_ALLOCATOR_TYPE_};
 enum Thread_state {_IDLE_, _BUSY_ };
 
+// Plain ints only, so that the route is copied into every flit without
+// allocating. Table based routing looks the NetDest of dest_ni up in
+// GarnetNetwork::getNetDest().
 struct RouteInfo
 {
-    // destination format for table-based routing
     int vnet;
-    NetDest net_dest;
 
     // src and dest format for topology-specific routing
     int src_ni;
@@ -44,3 +44,24 @@ Credit::Credit(int vc, bool is_free_signal, Cycles curTime)
     m_is_free_signal = is_free_signal;
     m_time = curTime;
 }
+
+SlabPool &
+Credit::pool()
+{
+    static SlabPool *p = new SlabPool(sizeof(Credit));
+    return *p;
+}
+
+void *
+Credit::operator new(size_t size)
+{
+    assert(size == sizeof(Credit));
+    return pool().alloc();
+}
+
+void
+Credit::operator delete(void *p, size_t size)
+{
+    assert(size == sizeof(Credit));
+    pool().free(p);
+}
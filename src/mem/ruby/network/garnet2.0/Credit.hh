@@ -53,7 +53,20 @@ class Credit : public flit
 
     bool is_free_signal() { return m_is_free_signal; }
 
+    // one credit per flit and hop, recycled like the flits
+    static void *operator new(size_t size);
+    static void operator delete(void *p, size_t size);
+    static const SlabPool &getPool() { return pool(); }
+    // the routers create and delete credits, see SlabPool::setThreadSafe
+    static void setThreadSafe(bool thread_safe)
+    { pool().setThreadSafe(thread_safe); }
+    // the peak of live credits is sampled between router evaluations
+    static void holdPeak() { pool().holdPeak(); }
+    static void releasePeak() { pool().releasePeak(); }
+
   private:
+    static SlabPool &pool();
+
     bool m_is_free_signal;
 };
 
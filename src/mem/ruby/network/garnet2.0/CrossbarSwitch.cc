@@ -92,6 +92,16 @@ CrossbarSwitch::wakeup()
     }
 }
 
+bool
+CrossbarSwitch::isDrained()
+{
+    for (int inport = 0; inport < m_num_inports; inport++) {
+        if (!m_switch_buffer[inport]->isEmpty())
+            return false;
+    }
+    return true;
+}
+
 uint32_t
 CrossbarSwitch::functionalWrite(Packet *pkt)
 {
@@ -59,6 +59,7 @@ class CrossbarSwitch : public Consumer
     { m_switch_buffer[inport]->insert(t_flit); }
 
     inline double get_crossbar_activity() { return m_crossbar_activity; }
+    bool isDrained();
 
     uint32_t functionalWrite(Packet *pkt);
     void resetStats();
@@ -35,18 +35,33 @@
 
 #include <algorithm>
 #include <cassert>
+#include <climits>
+#include <cstdlib>
+#include <ctime>
+#include <sstream>
 
 #include "base/cast.hh"
+#include "base/cprintf.hh"
 #include "base/stl_helpers.hh"
 #include "mem/ruby/common/NetDest.hh"
 #include "mem/ruby/network/MessageBuffer.hh"
+#include "mem/ruby/network/garnet2.0/AnalyticalNetworkModel.hh"
 #include "mem/ruby/network/garnet2.0/CommonTypes.hh"
+#include "mem/ruby/network/garnet2.0/Credit.hh"
 #include "mem/ruby/network/garnet2.0/CreditLink.hh"
 #include "mem/ruby/network/garnet2.0/GarnetLink.hh"
 #include "mem/ruby/network/garnet2.0/NetworkInterface.hh"
 #include "mem/ruby/network/garnet2.0/NetworkLink.hh"
 #include "mem/ruby/network/garnet2.0/Router.hh"
+#include "mem/ruby/network/garnet2.0/RouterThreadPool.hh"
+#include "mem/ruby/network/garnet2.0/TaskGraphBinary.hh"
+#include "mem/ruby/network/garnet2.0/TaskGraphDefinition.hh"
+#include "mem/ruby/network/garnet2.0/TaskGraphMemory.hh"
+#include "mem/ruby/network/garnet2.0/TaskMappingOptimizer.hh"
 #include "mem/ruby/system/RubySystem.hh"
+#include "sim/core.hh"
+#include "sim/stats.hh"
+#include "sim/system.hh"
 
 using namespace std;
 using m5::stl_helpers::deletePointers;
@@ -58,7 +73,11 @@ using m5::stl_helpers::deletePointers;
  */
 
 GarnetNetwork::GarnetNetwork(const Params *p)
-    : Network(p), Consumer(this)
+    : Network(p), Consumer(this),
+      m_router_evaluation_event([this]{ evaluateRouters(); },
+                                name() + ".router_evaluation", false,
+                                Event::CPU_Tick_Pri),
+      m_drain_event([this]{ checkDrained(); }, name() + ".drain")
 {
     m_num_rows = p->num_rows;
     m_ni_flit_size = p->ni_flit_size;
@@ -67,7 +86,42 @@ GarnetNetwork::GarnetNetwork(const Params *p)
     m_buffers_per_data_vc = p->buffers_per_data_vc;
     m_buffers_per_ctrl_vc = p->buffers_per_ctrl_vc;
     m_routing_algorithm = p->routing_algorithm;
+    m_switch_allocator = p->switch_allocator;
+    m_lookahead_routing = p->lookahead_routing;
+    m_router_bypass = p->router_bypass;
+    if (m_router_bypass && !m_lookahead_routing)
+        fatal("--router-bypass needs --lookahead-routing !");
+    m_smart_hpc_max = p->smart_hpc_max;
+    if (m_smart_hpc_max > 1 && !m_lookahead_routing)
+        fatal("--smart-hpc-max needs --lookahead-routing !");
+    m_router_threads = p->router_threads;
+    m_router_pool = NULL;
     m_task_graph_enable = p->task_graph_enable;
+    m_analytical_network = p->analytical_network;
+    m_analytical_model = NULL;
+    if (m_analytical_network && !m_task_graph_enable)
+        fatal("--analytical-network models task graph traffic only !");
+    for (int i = 0; i < p->port_ddr_port_connection_count; i++)
+        m_ddr_memories.push_back(new TaskGraphMemory(
+            csprintf("%s.ddr_port[%d]", name(), i), this,
+            p->system->getMasterId(this, csprintf("ddr%d", i)),
+            p->system->cacheLineSize()));
+    if (!m_ddr_memories.empty() && !m_task_graph_enable)
+        fatal("--task-graph-dram drives the DDR cores of the task graph "
+            "only !");
+    m_task_graph_event_driven = p->task_graph_event_driven;
+    m_task_graph_seed = p->task_graph_seed;
+    m_task_graph_quiet_load = p->task_graph_quiet_load;
+    m_task_graph_stats_window = p->task_graph_stats_window;
+    m_task_graph_sample_interval = p->task_graph_sample_interval;
+    m_task_graph_ci_precision = p->task_graph_ci_precision;
+    m_task_mapping_search_moves = p->task_mapping_search_moves;
+    m_task_mapping_search_threads = p->task_mapping_search_threads;
+    if (m_task_mapping_search_threads == 0)
+        fatal("--task-mapping-search-threads must be at least 1 !");
+    if (m_task_graph_ci_precision < 0 || m_task_graph_ci_precision >= 1)
+        fatal("--task-graph-ci-precision must be in [0, 1) !");
+    m_task_graph_indexed = false;
     m_task_graph_file = p->task_graph_file;
     m_token_packet_length = p->token_packet_length;
     m_topology = p->topology;
@@ -114,6 +168,13 @@ GarnetNetwork::GarnetNetwork(const Params *p)
         assert((m_vcs_per_vnet % 2 == 0) && (m_vcs_for_allocation % 2 == 0) &&\
         (m_vcs_for_allocation < m_vcs_per_vnet));
     }
+    if (m_routing_algorithm == RING_ && m_topology != "Ring")
+        fatal("Routing algorithm %d is for the Ring topology only !",
+            m_routing_algorithm);
+    if ((m_routing_algorithm == WEST_FIRST_ ||
+         m_routing_algorithm == ODD_EVEN_) && m_num_rows <= 0)
+        fatal("Routing algorithm %d needs a Mesh (--mesh-rows) !",
+            m_routing_algorithm);
 }
 
 void
@@ -125,6 +186,20 @@ GarnetNetwork::init()
         m_nis[i]->addNode(m_toNetQueues[i], m_fromNetQueues[i]);
     }
 
+    // The destination of every NI in the format of the routing tables,
+    // the flits only carry the NI id
+    m_ni_net_dest.resize(m_nodes);
+    for (NodeID i = 0; i < m_nodes; i++) {
+        for (int m = 0; m < (int) MachineType_NUM; m++) {
+            if ((i >= MachineType_base_number((MachineType) m)) &&
+                i < MachineType_base_number((MachineType) (m+1))) {
+                m_ni_net_dest[i].add((MachineID) {(MachineType) m, (i -
+                    MachineType_base_number((MachineType) m))});
+                break;
+            }
+        }
+    }
+
     // The topology pointer should have already been initialized in the
     // parent network constructor
     assert(m_topology_ptr != NULL);
@@ -176,7 +251,7 @@ GarnetNetwork::init()
         *(app_delay_running_info->stream())<<"Application\tIteration\tStart_time\tEnd_time\tExecution_Delay"<<endl;
 
         network_performance_info = simout.open("network_performance.log",ios_base::out|ios_base::app, false, true);
-        *(network_performance_info->stream())<<"Application\tIteration\tAverage_Flit_Latency\tAverage_Flit_Network_Latency\tAverage_Flit_Queueing_Latency\tFlits_Received\tAverage_Flit_Hops"<<endl;
+        *(network_performance_info->stream())<<"Application\tIteration\tAverage_Flit_Latency\tAverage_Flit_Network_Latency\tAverage_Flit_Queueing_Latency\tFlits_Received\tAverage_Flit_Hops\tAverage_Flit_Smart_Hops"<<endl;
 
         task_waiting_time_info = simout.create("task_waiting_time_info.log", false, true);
 
@@ -190,34 +265,55 @@ GarnetNetwork::init()
         if (readApplicationConfig(m_task_graph_file))
             cout<<"info: Load Application Configuration -"<<m_task_graph_file\
                 <<" - successfully !"<<endl;
+        for (int i = 0; i < m_ddr_memories.size(); i++)
+            m_ddr_memories[i]->init();
         //Construct Nodes
         DPRINTF(TaskGraph, "Start Construct Nodes !\n");
         if (constructArchitecture(m_architecture_file))
             cout<<"info: Construct Node -"<<m_architecture_file<<\
             " - successfully !"<<endl;
 
-        //num_completed_tasks[num_apps][num_iters] records the num tasks in this iters
+        //one slot per iteration, or a window of them in streaming mode
+        m_num_iteration_slots.resize(m_num_application);
+        for(int i=0;i<m_num_application;i++){
+            m_num_iteration_slots[i] = m_applicaton_execution_iterations[i];
+            if (m_task_graph_stats_window > 0 &&
+                m_task_graph_stats_window < m_num_iteration_slots[i])
+                m_num_iteration_slots[i] = m_task_graph_stats_window;
+        }
+
+        //num_completed_tasks[num_apps][slot] records the num tasks in this iters
         current_execution_iterations = new int[m_num_application];
         num_completed_tasks = new int* [m_num_application];        
         for(int i=0;i<m_num_application;i++){
-            num_completed_tasks[i] = new int[m_applicaton_execution_iterations[i]];
+            num_completed_tasks[i] = new int[m_num_iteration_slots[i]];
         }
 
         for(int i=0;i<m_num_application;i++){
             current_execution_iterations[i] = 0;
-            for(int j=0;j<m_applicaton_execution_iterations[i];j++){
+            for(int j=0;j<m_num_iteration_slots[i];j++){
                 num_completed_tasks[i][j] = 0;
             }
         }        
 
         //Print Node Configuration Information
-        if (true){
+        if (!m_task_graph_quiet_load){
             cout<<"\n";
             for (int i=0;i<m_nodes/2;i++)
                 m_nis[i]->printNodeConfiguation();
             cout<<"\n";
         }
 
+        //every task and edge seeds its own stream from this seed, print
+        //it so that a wall clock seeded run can be repeated
+        if (m_task_graph_seed == 0)
+            m_task_graph_seed = time(NULL);
+        cout<<"info: Task graph seed - "<<m_task_graph_seed<<endl;
+        srand(m_task_graph_seed);
+
+        if (m_task_mapping_search_moves > 0)
+            searchTaskMapping();
+
         //load traffic by the task graph file.
         head_task.resize(m_num_application);
         DPRINTF(TaskGraph, "Start Load Traffic !\n");
@@ -230,20 +326,47 @@ GarnetNetwork::init()
             // m_nis[i]->initializeTaskBuffer();
         }
 
+        //the task lists do not move any more, index them
+        buildTaskGraphIndex();
+
         ETE_delay.resize(m_num_application);
         task_start_time.resize(m_num_application);
         task_end_time.resize(m_num_application);
+        m_slot_iteration.resize(m_num_application);
         for(int i=0;i<m_num_application;i++){
-            task_start_time[i].resize(m_applicaton_execution_iterations[i]);
-            task_end_time[i].resize(m_applicaton_execution_iterations[i]);
-            ETE_delay[i].resize(m_applicaton_execution_iterations[i]);
+            task_start_time[i].resize(m_num_iteration_slots[i], UINT64_MAX);
+            task_end_time[i].resize(m_num_iteration_slots[i], 0);
+            ETE_delay[i].resize(m_num_iteration_slots[i]);
+            m_slot_iteration[i].resize(m_num_iteration_slots[i], -1);
         }
-
-        for(int i=0;i<m_num_application;i++)
-            for(int j=0;j<m_applicaton_execution_iterations[i];j++){
-                task_start_time[i][j] = INT_MAX;
-                task_end_time[i][j] = INT_MIN;
-            }
+        m_app_delay_stats.resize(m_num_application);
+        m_app_delay_sketch.resize(m_num_application);
+        m_app_delay_steady.resize(m_num_application);
+        m_app_interval_steady.resize(m_num_application);
+        m_app_last_end.assign(m_num_application, 0);
+        m_app_converged.assign(m_num_application, false);
+
+        //the time series, one column per application, link and NI
+        time_series_info = NULL;
+        if (m_task_graph_sample_interval > 0){
+            time_series_info = simout.create("task_graph_time_series.csv", false, true);
+            ostringstream header;
+            header<<"cycle";
+            for (int i=0;i<m_num_application;i++)
+                header<<","<<m_application_name[i]<<".throughput";
+            header<<",avg_flit_latency";
+            for (int i=0;i<m_networklinks.size();i++)
+                header<<",link"<<i<<".utilization";
+            for (int i=0;i<m_nis.size();i++)
+                header<<",ni"<<i<<".queue_depth";
+            header<<"\n";
+            m_time_series_buffer = header.str();
+        }
+        m_last_sample_cycle = curCycle();
+        m_sampled_iterations.assign(m_num_application, 0);
+        m_sampled_link_utilization.assign(m_networklinks.size(), 0);
+        m_sampled_flit_latency = 0;
+        m_sampled_flits_received = 0;
 
         //initialize the latency matrix
         src_dst_latency = new int* [m_num_core];
@@ -255,12 +378,52 @@ GarnetNetwork::init()
                 src_dst_latency[i][j] = 0;
     }
 
-    scheduleWakeupAbsolute(curCycle() + Cycles(1));
+    // All the links are in, compile the routing tables. The routers
+    // break ties with the task graph seed, if there is one.
+    for (int i = 0; i < m_routers.size(); i++)
+        m_routers[i]->compileRoutingTable(m_nodes,
+            isTaskGraphEnabled() ? m_task_graph_seed : 0);
+
+    if (m_router_threads == 0)
+        fatal("--garnet-router-threads must be at least 1 !");
+    if (m_router_threads > 1) {
+        // a flit or credit sent on a cycle must not be seen by another
+        // router on the same cycle
+        for (int i = 0; i < m_networklinks.size(); i++)
+            if (m_networklinks[i]->getLatency() < Cycles(1))
+                fatal("Evaluating the routers on %d threads needs links "
+                      "of at least one cycle !", m_router_threads);
+        for (int i = 0; i < m_creditlinks.size(); i++)
+            if (m_creditlinks[i]->getLatency() < Cycles(1))
+                fatal("Evaluating the routers on %d threads needs links "
+                      "of at least one cycle !", m_router_threads);
+        Credit::setThreadSafe(true);
+        m_router_pool = new RouterThreadPool(m_router_threads);
+    }
+
+    if (m_analytical_network)
+        buildAnalyticalModel();
+}
+
+void
+GarnetNetwork::startup()
+{
+    Network::startup();
+
+    //the pending wakeups are not in a checkpoint, so the NIs and the
+    //network are woken up here, also after a restore
+    for (int i=0;i<m_nodes/2;i++){
+        m_nis[i]->scheduleEventAbsolute(curTick() + 1);
+    }
     //wake up the garnet network
+    scheduleEventAbsolute(curTick() + 1);
 }
 
 GarnetNetwork::~GarnetNetwork()
 {
+    delete m_router_pool;
+    delete m_analytical_model;
+    deletePointers(m_ddr_memories);
     deletePointers(m_routers);
     deletePointers(m_nis);
     deletePointers(m_networklinks);
@@ -282,6 +445,42 @@ GarnetNetwork::~GarnetNetwork()
     delete [] num_completed_tasks;
 }
 
+void
+GarnetNetwork::scheduleRouterEvaluation(Router *router)
+{
+    m_ready_routers.push_back(router);
+    if (!m_router_evaluation_event.scheduled())
+        schedule(m_router_evaluation_event, curTick());
+}
+
+// Evaluates the routers woken up on this cycle (see
+// isRouterEvaluationBatched), on the router threads if there are several.
+// Their wakeups and the ones of their links are held back meanwhile and
+// scheduled afterwards in router order, and the peak of live credits is
+// only sampled once they are all done, so the event queue and the stats
+// are the same whatever the number of threads.
+void
+GarnetNetwork::evaluateRouters()
+{
+    sort(m_ready_routers.begin(), m_ready_routers.end(),
+         [](Router *a, Router *b) { return a->get_id() < b->get_id(); });
+
+    for (int i = 0; i < m_ready_routers.size(); i++)
+        m_ready_routers[i]->defer_wakeups();
+    Credit::holdPeak();
+    if (m_router_pool != NULL) {
+        m_router_pool->run(m_ready_routers);
+    } else {
+        for (int i = 0; i < m_ready_routers.size(); i++)
+            m_ready_routers[i]->evaluate();
+    }
+    Credit::releasePeak();
+    for (int i = 0; i < m_ready_routers.size(); i++)
+        m_ready_routers[i]->flush_wakeups();
+
+    m_ready_routers.clear();
+}
+
 /*
  * This function creates a link from the Network Interface (NI)
  * into the Network.
@@ -309,11 +508,10 @@ GarnetNetwork::makeExtInLink(NodeID src, SwitchID dest, BasicLink* link,
 
     PortDirection dst_inport_dirn = "Local";
     m_routers[dest]->addInPort(dst_inport_dirn, net_link, credit_link);
+    if (m_lookahead_routing)
+        net_link->setLookaheadRouter(m_routers[dest],
+            m_routers[dest]->get_num_inports() - 1, dst_inport_dirn);
     m_nis[src]->addOutPort(net_link, credit_link, dest);
-
-    for (int i=0;i<m_nodes/2;i++){
-        m_nis[i]->scheduleEventAbsolute(Cycles(1));
-    }
 }
 
 /*
@@ -369,9 +567,17 @@ GarnetNetwork::makeInternalLink(SwitchID src, SwitchID dest, BasicLink* link,
     m_creditlinks.push_back(credit_link);
 
     m_routers[dest]->addInPort(dst_inport_dirn, net_link, credit_link);
+    if (m_lookahead_routing)
+        net_link->setLookaheadRouter(m_routers[dest],
+            m_routers[dest]->get_num_inports() - 1, dst_inport_dirn);
     m_routers[src]->addOutPort(src_outport_dirn, net_link,
                                routing_table_entry,
                                link->m_weight, credit_link);
+
+    m_router_neighbours.resize(m_routers.size());
+    m_router_neighbours[src].push_back(dest);
+    m_router_neighbour_links.resize(m_routers.size());
+    m_router_neighbour_links[src].push_back(net_link);
 }
 
 // Total routers in the network
@@ -514,6 +720,16 @@ GarnetNetwork::regStats()
     // Hops
     m_avg_hops.name(name() + ".average_hops");
     m_avg_hops = m_total_hops / sum(m_flits_received);
+    m_avg_smart_hops.name(name() + ".average_smart_hops");
+    m_avg_smart_hops = m_total_smart_hops / sum(m_flits_received);
+
+    // Slab pools
+    m_peak_live_flits
+        .name(name() + ".peak_live_flits")
+        .desc("peak number of flits allocated at the same time");
+    m_peak_live_credits
+        .name(name() + ".peak_live_credits")
+        .desc("peak number of credits allocated at the same time");
 
     // Links
     m_total_ext_in_link_utilization
@@ -534,7 +750,48 @@ GarnetNetwork::regStats()
     //add for TG
     m_total_task_execution_time
         .name(name() + ".total_task_execution_time");
+    m_max_generator_buffer_pending
+        .name(name() + ".max_generator_buffer_pending")
+        .desc("peak number of pkts pending in a core generator buffer");
+    m_peak_live_generator_entries
+        .name(name() + ".peak_live_generator_entries")
+        .desc("peak number of generator buffer entries of all the cores");
+
+    if (isTaskGraphEnabled()) {
+        m_app_completed_iterations
+            .init(m_num_application)
+            .name(name() + ".app_completed_iterations")
+            .desc("iterations completed by every application")
+            ;
+        m_app_throughput
+            .name(name() + ".app_throughput")
+            .desc("iterations per second of every application")
+            ;
+        m_app_throughput = m_app_completed_iterations / simSeconds;
+
+        m_window_app_iterations
+            .init(m_num_application)
+            .name(name() + ".window_app_iterations")
+            .desc("iterations completed in a time series window")
+            ;
+        for (int i = 0; i < m_num_application; i++) {
+            m_app_completed_iterations.subname(i, m_application_name[i]);
+            m_app_throughput.subname(i, m_application_name[i]);
+            m_window_app_iterations.subname(i, m_application_name[i]);
+        }
 
+        m_window_link_utilization
+            .init(0, 1, 0.05)
+            .name(name() + ".window_link_utilization")
+            .desc("flits per cycle of a link in a time series window")
+            ;
+        m_window_ni_queue_depth
+            .init(16)
+            .name(name() + ".window_ni_queue_depth")
+            .desc("pkts waiting to be injected at a NI, every time series "
+                  "window")
+            ;
+    }
 }
 
 void
@@ -563,10 +820,25 @@ GarnetNetwork::collateStats()
         }
     }
 
+    m_peak_live_flits = flit::getPool().getPeakLive();
+    m_peak_live_credits = Credit::getPool().getPeakLive();
+
     // Ask the routers to collate their statistics
     for (int i = 0; i < m_routers.size(); i++) {
         m_routers[i]->collateStats();
     }
+
+    if (isTaskGraphEnabled()) {
+        int peak = 0;
+        for (int i = 0; i < m_nis.size(); i++)
+            peak = std::max(peak, m_nis[i]->getGeneratorBufferPeak());
+        m_max_generator_buffer_pending = peak;
+        m_peak_live_generator_entries =
+            GeneratorBuffer::getPool().getPeakLive();
+
+        for (int i = 0; i < m_num_application; i++)
+            m_app_completed_iterations[i] = current_execution_iterations[i];
+    }
 }
 
 void
@@ -601,6 +873,227 @@ GarnetNetwork::functionalWrite(Packet *pkt)
     return num_functional_writes;
 }
 
+bool
+GarnetNetwork::isNetworkDrained()
+{
+    for (int i = 0; i < m_routers.size(); i++) {
+        if (!m_routers[i]->isDrained())
+            return false;
+    }
+    for (int i = 0; i < m_networklinks.size(); i++) {
+        if (!m_networklinks[i]->isDrained())
+            return false;
+    }
+    for (int i = 0; i < m_creditlinks.size(); i++) {
+        if (!m_creditlinks[i]->isDrained())
+            return false;
+    }
+    for (int i = 0; i < m_nis.size(); i++) {
+        if (!m_nis[i]->isDrained())
+            return false;
+    }
+    for (int i = 0; i < m_ddr_memories.size(); i++) {
+        if (!m_ddr_memories[i]->isDrained())
+            return false;
+    }
+    return true;
+}
+
+Port &
+GarnetNetwork::getPort(const std::string &if_name, PortID idx)
+{
+    if (if_name == "ddr_port" && idx >= 0 && idx < m_ddr_memories.size())
+        return m_ddr_memories[idx]->getPort();
+    return Network::getPort(if_name, idx);
+}
+
+DrainState
+GarnetNetwork::drain()
+{
+    // only the task graph traffic is held back by the NIs, the protocol
+    // traffic is drained by its controllers
+    if (!isTaskGraphEnabled() || isNetworkDrained())
+        return DrainState::Drained;
+
+    schedule(m_drain_event, clockEdge(Cycles(1)));
+    return DrainState::Draining;
+}
+
+void
+GarnetNetwork::checkDrained()
+{
+    if (isNetworkDrained())
+        signalDrainDone();
+    else
+        schedule(m_drain_event, clockEdge(Cycles(1)));
+}
+
+void
+GarnetNetwork::serialize(CheckpointOut &cp) const
+{
+    Network::serialize(cp);
+    if (!m_task_graph_enable)
+        return;
+
+    SERIALIZE_SCALAR(m_num_application);
+    for (int k = 0; k < m_num_application; k++) {
+        string base = csprintf("app%d", k);
+        paramOut(cp, base + ".current_execution_iterations",
+            current_execution_iterations[k]);
+
+        //the iterations still in a slot, they are placed again into the
+        //slots of the restoring run
+        vector<int> iteration, completed;
+        vector<uint64_t> start, end, delay;
+        for (int slot = 0; slot < m_num_iteration_slots[k]; slot++) {
+            if (m_slot_iteration[k][slot] < 0)
+                continue;
+            iteration.push_back(m_slot_iteration[k][slot]);
+            completed.push_back(num_completed_tasks[k][slot]);
+            start.push_back(task_start_time[k][slot]);
+            end.push_back(task_end_time[k][slot]);
+            delay.push_back(ETE_delay[k][slot]);
+        }
+        arrayParamOut(cp, base + ".iteration", iteration);
+        arrayParamOut(cp, base + ".num_completed_tasks", completed);
+        arrayParamOut(cp, base + ".task_start_time", start);
+        arrayParamOut(cp, base + ".task_end_time", end);
+        arrayParamOut(cp, base + ".ete_delay", delay);
+
+        m_app_delay_stats[k].serialize(base + ".delay", cp);
+        m_app_delay_sketch[k].serialize(base + ".delay_sketch", cp);
+        m_app_delay_steady[k].serialize(base + ".delay_steady", cp);
+        m_app_interval_steady[k].serialize(base + ".interval_steady", cp);
+        paramOut(cp, base + ".last_end", m_app_last_end[k]);
+        paramOut(cp, base + ".converged", (bool)m_app_converged[k]);
+    }
+
+    vector<int> latency;
+    for (int i = 0; i < m_num_core; i++)
+        latency.insert(latency.end(), src_dst_latency[i],
+            src_dst_latency[i] + m_num_core);
+    arrayParamOut(cp, "src_dst_latency", latency);
+
+    int num_edges = m_edges.size();
+    SERIALIZE_SCALAR(num_edges);
+    for (int i = 0; i < num_edges; i++) {
+        ScopedCheckpointSection sec(cp, csprintf("edge%d", i));
+        m_edges[i].serialize(cp);
+    }
+
+    int num_ddr_memories = m_ddr_memories.size();
+    SERIALIZE_SCALAR(num_ddr_memories);
+    for (int i = 0; i < num_ddr_memories; i++)
+        m_ddr_memories[i]->serialize(csprintf("ddr%d", i), cp);
+}
+
+void
+GarnetNetwork::unserialize(CheckpointIn &cp)
+{
+    Network::unserialize(cp);
+    if (!m_task_graph_enable)
+        return;
+
+    int num_application;
+    paramIn(cp, "m_num_application", num_application);
+    if (num_application != m_num_application)
+        fatal("The checkpoint has %d applications, %s has %d !",
+            num_application, m_task_graph_file, m_num_application);
+
+    for (int k = 0; k < m_num_application; k++) {
+        string base = csprintf("app%d", k);
+        paramIn(cp, base + ".current_execution_iterations",
+            current_execution_iterations[k]);
+        if (current_execution_iterations[k] >
+            m_applicaton_execution_iterations[k])
+            fatal("Application %s completed %d iterations in the "
+                "checkpoint, more than the %d to run !",
+                m_application_name[k], current_execution_iterations[k],
+                m_applicaton_execution_iterations[k]);
+
+        vector<int> iteration, completed;
+        vector<uint64_t> start, end, delay;
+        arrayParamIn(cp, base + ".iteration", iteration);
+        arrayParamIn(cp, base + ".num_completed_tasks", completed);
+        arrayParamIn(cp, base + ".task_start_time", start);
+        arrayParamIn(cp, base + ".task_end_time", end);
+        arrayParamIn(cp, base + ".ete_delay", delay);
+
+        //oldest first, a completed iteration may give its slot away as
+        //in claimIterationSlot
+        vector<int> order(iteration.size());
+        for (int i = 0; i < order.size(); i++)
+            order[i] = i;
+        sort(order.begin(), order.end(),
+            [&](int a, int b) { return iteration[a] < iteration[b]; });
+        for (int i = 0; i < order.size(); i++) {
+            int r = order[i];
+            if (iteration[r] >= m_applicaton_execution_iterations[k])
+                continue;
+            int slot = iteration[r] % m_num_iteration_slots[k];
+            int owner = m_slot_iteration[k][slot];
+            if (owner >= current_execution_iterations[k])
+                fatal("Application %s has more than %d iterations in "
+                    "flight in the checkpoint, raise "
+                    "--task-graph-stats-window !",
+                    m_application_name[k], m_num_iteration_slots[k]);
+            m_slot_iteration[k][slot] = iteration[r];
+            num_completed_tasks[k][slot] = completed[r];
+            task_start_time[k][slot] = start[r];
+            task_end_time[k][slot] = end[r];
+            ETE_delay[k][slot] = delay[r];
+        }
+
+        m_app_delay_stats[k].unserialize(base + ".delay", cp);
+        m_app_delay_sketch[k].unserialize(base + ".delay_sketch", cp);
+        m_app_delay_steady[k].unserialize(base + ".delay_steady", cp);
+        m_app_interval_steady[k].unserialize(base + ".interval_steady", cp);
+        paramIn(cp, base + ".last_end", m_app_last_end[k]);
+        bool converged;
+        paramIn(cp, base + ".converged", converged);
+        m_app_converged[k] = converged;
+    }
+
+    vector<int> latency;
+    arrayParamIn(cp, "src_dst_latency", latency);
+    if (latency.size() != m_num_core * m_num_core)
+        fatal("The checkpoint has a different number of cores !");
+    for (int i = 0; i < m_num_core; i++)
+        for (int j = 0; j < m_num_core; j++)
+            src_dst_latency[i][j] = latency[i * m_num_core + j];
+
+    int num_edges;
+    UNSERIALIZE_SCALAR(num_edges);
+    if (num_edges != m_edges.size())
+        fatal("The checkpoint has %d edges, %s has %d !",
+            num_edges, m_task_graph_file, m_edges.size());
+    for (int i = 0; i < num_edges; i++) {
+        ScopedCheckpointSection sec(cp, csprintf("edge%d", i));
+        m_edges[i].unserialize(cp);
+    }
+
+    //a checkpoint of other DDR memories leaves the regions of the tasks
+    //to start again
+    int num_ddr_memories = 0;
+    UNSERIALIZE_OPT_SCALAR(num_ddr_memories);
+    if (num_ddr_memories == m_ddr_memories.size()) {
+        for (int i = 0; i < num_ddr_memories; i++)
+            m_ddr_memories[i]->unserialize(csprintf("ddr%d", i), cp);
+    } else {
+        warn("The checkpoint has %d DDR memories, the run %d, their "
+            "accesses start again from the region bases.",
+            num_ddr_memories, m_ddr_memories.size());
+    }
+
+    //the links and stats start again from zero, so does the time series
+    m_last_sample_cycle = curCycle();
+    for (int k = 0; k < m_num_application; k++)
+        m_sampled_iterations[k] = current_execution_iterations[k];
+    m_sampled_link_utilization.assign(m_networklinks.size(), 0);
+    m_sampled_flit_latency = 0;
+    m_sampled_flits_received = 0;
+}
+
 // 
 vector<int> 
 GarnetNetwork::get_ratio_token(int *iterations){
@@ -660,177 +1153,43 @@ GarnetNetwork::loadTraffic(std::string filename){
     m_num_task = new int[m_num_application];
     m_num_edge = new int[m_num_application];
     m_num_head_task = new int[m_num_application];
-
-    FILE *fp;
-    size_t separator = filename.rfind("/");
-    //directory name with "/"
-    std::string dir_name = filename.substr(0, separator+1);
+    m_edge_index.assign(m_num_application, vector<int>());
+    m_edges.clear();
 
     for (int k=0;k<m_num_application;k++){
-        //the absolute path of the application file
-        std::string app_filename = dir_name+m_application_name[k];
-
-        fp = fopen(app_filename.c_str(), "r");
-        if (fp == NULL){
-            fatal("Error opening the %s.stp file!", app_filename.c_str());
-            return false;
-        }
+        std::string app_filename = getApplicationFilename(k);
 
-        int v[10];
-        float d[10];
-        //read the first line
-        //number of tasks, number of edges, number of PUs
-        int trace_type;
-
-        //get rid of headers
-        char ts[1000];
-        for (int i=0;i<15;i++)
-        {
-            fgets(ts,1000,fp);
-        }
+        //.tgb files are converted from the .stp by my_scripts/stp2tgb.py
+        if (TaskGraphBinary::isTaskGraphBinary(app_filename))
+            loadBinaryApplication(k, app_filename);
+        else
+            loadTextApplication(k, app_filename);
 
-        fscanf(fp, "%d", &trace_type);assert(0==trace_type);
-        fscanf(fp, "%d", &m_num_proc);
-        fscanf(fp, "%d", &m_num_task[k]);
-        fscanf(fp, "%d", &m_num_edge[k]);
-
-        assert( m_num_task[k]>0 && m_num_edge[k]>0 && m_num_proc>0 &&\
-        m_applicaton_execution_iterations[k]>0);
-        //get head task information
-        fscanf(fp, "%d", &m_num_head_task[k]);
-        int head_task_id;
-        for (int i=0; i<m_num_head_task[k]; i++){
-            fscanf(fp, "%d", &head_task_id);
-            head_task[k].push_back(head_task_id);
+        for (int i=0; i < m_nodes/2; i++) {
+            m_nis[i]->sort_task_list();
         }
+    }
 
-        // read the next number of tasks lines: task info
-        for (int i=0; i<m_num_task[k]; i++) {
-            fscanf(fp, "%d", &v[0]);    //task id
-            fscanf(fp, "%d", &v[1]);    //mapped proc id
-            fscanf(fp, "%d", &v[2]);    //shedule sequence number
-            fscanf(fp, "%f", &d[0]);    //mu & sigma for
-            fscanf(fp, "%f", &d[1]);    //task execution time distribution
-
-            // add the task to the processor
-            GraphTask t;
-            t.set_id(v[0]);
-            t.set_proc_id(v[1]);
-            t.set_schedule(v[2]);
-
-            t.set_statistical_execution_time(d[0], d[1]);
-            t.set_max_time(d[0]+2*d[1]);
-
-            t.set_required_times(m_applicaton_execution_iterations[k]);
-            //for multi-app
-            t.set_app_idx(k);
-            t.initial();
-
-            int current_node_id = getNodeIdbyCoreId(v[1]);
-
-            //head task not in the list
-            // std::vector<int>::iterator it = std::find(head_task[k].begin(), head_task[k].end(), v[0]);
-            // if (it!=head_task[k].end())
-                m_nis[current_node_id]->add_task(k, t, false);
-            // else
-            //     m_nis[current_node_id]->add_task(k, t, true);
-
+    unsigned int sum=0;
+    for (int i=0; i < m_nodes /2 ; i++){
+        int num_cores_in_node = m_nis[i]->get_num_cores();
+        for (int j=0;j<num_cores_in_node;j++){
+            for (int ii=0;ii<m_num_application;ii++)
+                sum = sum + m_nis[i]->get_task_list_length(j, ii);
         }
+    }
 
-        // read the next number of edges lines: communication info
-            for (int i=0; i<m_num_edge[k]; i++){
-
-                fscanf(fp, "%d", &v[0]);//edge id
-                fscanf(fp, "%d", &v[1]);//src task id
-                fscanf(fp, "%d", &v[2]);//dst task id
-                fscanf(fp, "%d", &v[3]);//src proc id
-                fscanf(fp, "%d", &v[4]);//dst proc id
-                fscanf(fp, "%d", &v[5]);//out_memory_start_address
-                fscanf(fp, "%d", &v[6]);//out_memory_size
-                fscanf(fp, "%d", &v[7]);//in_memory_start_address
-                fscanf(fp, "%d", &v[8]);//in_memory_size
-
-                //mu & sigma for token size distribution
-                fscanf(fp, "%f", &d[0]);
-                fscanf(fp, "%f", &d[1]);
-                //lambda for pk generation interval distribution
-                fscanf(fp, "%f", &d[2]);
-
-                // construct the edge
-                GraphEdge e;
-                e.set_id(v[0]);
-                e.set_src_task_id(v[1]);
-                e.set_dst_task_id(v[2]);
-                e.set_src_proc_id(v[3]);
-                e.set_dst_proc_id(v[4]);
-                //Note Here! We just consider the size of the out memory for the source task
-                //e.set_out_memory(v[5],v[6]);
-                //e.set_out_memory(v[5],10);
-                e.set_out_memory(v[5],m_out_mem_size);
-
-                // if (v[6]==-1)
-                //     e.set_out_memory(v[5],INT_MAX);
-                // else
-                //     e.set_out_memory(v[5],v[6]);
-
-                //e.set_in_memory(v[7],v[8]);
-                e.set_in_memory(v[7],m_in_mem_size);
-
-
-                e.set_statistical_token_size(d[0], d[1]);
-                e.set_max_token_size(d[0]+2*d[1]);
-                e.set_statistical_pkt_interval(d[2]);
-
-                e.set_app_idx(k);
-                e.initial();
-
-                int src_node_id = getNodeIdbyCoreId(e.get_src_proc_id());
-                GraphTask &src_task = m_nis[src_node_id]->\
-                    get_task_by_task_id(e.get_src_proc_id(), \
-                    k, e.get_src_task_id());
-
-                int dst_node_id = getNodeIdbyCoreId(e.get_dst_proc_id());
-                GraphTask &dst_task = m_nis[dst_node_id]->\
-                    get_task_by_task_id(e.get_dst_proc_id(), k, \
-                    e.get_dst_task_id());
-
-                src_task.add_outgoing_edge(e);
-                dst_task.add_incoming_edge(e);
-
-                // Set vc_choice based on m_vc_allocation_object and node ID and vc_allocation_object_position
-                int vc_choice;
-                if(m_vc_allocation_object != " " && m_vcs_for_allocation > 0){
-                    bool is_for_object = false;
-                    int num_object = vc_allocation_object_position.size();
-                    for (int i = 0; i < num_object; i++){
-                        if((src_node_id == vc_allocation_object_position[i])||(dst_node_id \
-                        == vc_allocation_object_position[i])){
-                            vc_choice = (dst_node_id >= src_node_id);
-                            is_for_object = true;
-                            break;
-                        }
-                    }
-                    if(is_for_object == false){
-                        vc_choice = (dst_node_id >= src_node_id) + 2;
-                    }
-                }
-                else if(m_vc_allocation_object == " " && m_vcs_for_allocation > 0){
-                    fatal("vc_allocation_object is not assigned! vcs_for_allocation can not be positive!");
-                }
-                else{
-                    vc_choice = (dst_node_id >= src_node_id);
-                }
-                e.set_vc_choice(vc_choice);
-            }
-
-        for (int i=0; i < m_nodes/2; i++) {
-            m_nis[i]->sort_task_list();
-        }
+    int verify_task_sum=0;
+    for (int i=0;i<m_num_application;i++)
+        verify_task_sum += m_num_task[i];
+    assert(sum==verify_task_sum);
 
-        fclose(fp);
+    if (m_task_graph_quiet_load){
+        printf("Loaded %d tasks and %lu edges of %d applications\n\n",
+            verify_task_sum, m_edges.size(), m_num_application);
+        return true;
     }
 
-    unsigned int sum=0;
     printf("**********************\n");
     printf("**********************\n");
     printf("Traffic Information\n");
@@ -855,7 +1214,6 @@ GarnetNetwork::loadTraffic(std::string filename){
                     printf("  \tTask %5d\tshedule %5d\n",\
                         t.get_id(), t.get_schedule());
                 }
-                sum = sum + task_list_len;
             }
         }
         printf("\n");
@@ -873,11 +1231,6 @@ GarnetNetwork::loadTraffic(std::string filename){
     printf("\n");
     printf("The Total task is %d\n\n", sum);
 
-    int verify_task_sum=0;
-    for (int i=0;i<m_num_application;i++)
-        verify_task_sum += m_num_task[i];
-    assert(sum==verify_task_sum);
-
     //Core[0] task schdule
     /*
     for (unsigned j=0; j<m_nis[0]->get_task_list_length(); j++){
@@ -890,22 +1243,460 @@ GarnetNetwork::loadTraffic(std::string filename){
     return true;
 }
 
+//the absolute path of the application file, next to the task graph file
+std::string
+GarnetNetwork::getApplicationFilename(int k){
+    size_t separator = m_task_graph_file.rfind("/");
+    //directory name with "/"
+    std::string dir_name = m_task_graph_file.substr(0, separator+1);
+    return dir_name+m_application_name[k];
+}
+
+//shortest paths over the internal links from router src: the hops to
+//every router, and the router and link each one is reached from
+void
+GarnetNetwork::routerShortestPaths(int src, vector<int> &distance,
+    vector<int> &prev, vector<NetworkLink *> &prev_link){
+    int num_routers = m_routers.size();
+    m_router_neighbours.resize(num_routers);
+    m_router_neighbour_links.resize(num_routers);
+    distance.assign(num_routers, INT_MAX);
+    prev.assign(num_routers, -1);
+    prev_link.assign(num_routers, NULL);
+
+    vector<int> queue(1, src);
+    distance[src] = 0;
+    for (int q=0;q<queue.size();q++){
+        int r = queue[q];
+        for (int n=0;n<m_router_neighbours[r].size();n++){
+            int next = m_router_neighbours[r][n];
+            if (distance[next] == INT_MAX){
+                distance[next] = distance[r] + 1;
+                prev[next] = r;
+                prev_link[next] = m_router_neighbour_links[r][n];
+                queue.push_back(next);
+            }
+        }
+    }
+}
+
+void
+GarnetNetwork::buildAnalyticalModel(){
+    int num_nis = m_nodes/2;
+    m_analytical_model = new AnalyticalNetworkModel(num_nis);
+    for (int i=0;i<num_nis;i++){
+        vector<int> distance, prev;
+        vector<NetworkLink *> prev_link;
+        routerShortestPaths(m_nis[i]->get_router_id(), distance, prev,
+            prev_link);
+        for (int j=0;j<num_nis;j++){
+            if (i == j)
+                continue;
+            int r = m_nis[j]->get_router_id();
+            if (distance[r] == INT_MAX)
+                fatal("Node %d cannot reach node %d !", i, j);
+
+            //ejection link, internal links back to the source router,
+            //injection link
+            vector<NetworkLink *> links(1, m_nis[j]->getInNetLink());
+            Cycles router_latency = m_routers[r]->get_pipe_stages();
+            for (; prev[r] != -1; r = prev[r]){
+                links.push_back(prev_link[r]);
+                router_latency += m_routers[prev[r]]->get_pipe_stages();
+            }
+            links.push_back(m_nis[i]->getOutNetLink());
+            reverse(links.begin(), links.end());
+            m_analytical_model->setPath(i, j, links, router_latency);
+        }
+    }
+}
+
+void
+GarnetNetwork::PrintAnalyticalSummary(){
+    double peak = m_analytical_model->getPeakUtilization();
+    printf("Analytical Network Peak Link Utilization: %.3f (link %d)\n",
+        peak, m_analytical_model->getPeakLink());
+    if (peak > AnalyticalNetworkModel::utilization_limit)
+        printf("Analytical Network: above %.2f the M/D/1 model underrates "
+            "the contention, confirm this configuration with a cycle "
+            "accurate run\n", AnalyticalNetworkModel::utilization_limit);
+    else
+        printf("Analytical Network: within the range of the M/D/1 model\n");
+}
+
+void
+GarnetNetwork::searchTaskMapping(){
+    //the PE-7 entrance core starts the applications, it keeps its tasks
+    TaskMappingOptimizer optimizer;
+    for (int i=0;i<m_nodes/2;i++){
+        for (int j=0;j<m_nis[i]->get_num_cores();j++){
+            int core_id = m_nis[i]->get_core_id_by_index(j);
+            optimizer.addCore(core_id, i,
+                m_nis[i]->get_core_name_by_index(j),
+                m_nis[i]->get_core_threads_by_index(j),
+                core_id == entrance_core);
+        }
+    }
+
+    //hops between the routers of the nodes, along the internal links
+    vector<vector<int> > hops(m_nodes/2, vector<int>(m_nodes/2, INT_MAX));
+    for (int i=0;i<m_nodes/2;i++){
+        vector<int> distance, prev;
+        vector<NetworkLink *> prev_link;
+        routerShortestPaths(m_nis[i]->get_router_id(), distance, prev,
+            prev_link);
+        for (int j=0;j<m_nodes/2;j++){
+            hops[i][j] = distance[m_nis[j]->get_router_id()];
+            if (hops[i][j] == INT_MAX)
+                fatal("Node %d cannot reach node %d !", i, j);
+        }
+    }
+    optimizer.setNodeHops(hops);
+
+    for (int k=0;k<m_num_application;k++)
+        optimizer.addApplication(getApplicationFilename(k),
+            m_applicaton_execution_iterations[k]);
+
+    optimizer.search(m_task_mapping_search_threads,
+        m_task_mapping_search_moves, m_task_graph_seed);
+    cout<<"info: Task mapping search - hop weighted traffic "<<\
+        optimizer.getInitialCost()<<" -> "<<optimizer.getBestCost()<<endl;
+
+    //the applications with the best mapping, and a task graph file that
+    //runs them
+    OutputStream *cfg = simout.create("task_mapping.cfg", false, true);
+    *(cfg->stream())<<m_num_application<<" "<<\
+        m_total_execution_iterations<<"\n";
+    for (int k=0;k<m_num_application;k++){
+        string name = m_application_name[k];
+        name = name.substr(0, name.rfind(".")) + "_mapped.stp";
+        OutputStream *app = simout.create(name, false, true);
+        optimizer.writeApplication(k, *(app->stream()));
+        simout.close(app);
+        *(cfg->stream())<<name<<" "<<\
+            m_applicaton_execution_iterations[k]<<"\n";
+    }
+    simout.close(cfg);
+
+    //this run simulates the best mapping
+    for (map<int,int>::iterator iter=m_core_id_node_id.begin();\
+        iter!=m_core_id_node_id.end();iter++){
+        int core_id = iter->first;
+        m_task_core_map[core_id] = optimizer.getMappedCore(core_id);
+        if (m_task_core_map[core_id] != core_id && !m_task_graph_quiet_load)
+            cout<<"info: Tasks of core "<<core_id<<" moved to core "<<\
+                m_task_core_map[core_id]<<endl;
+    }
+}
+
+void
+GarnetNetwork::loadTextApplication(int k, const std::string &app_filename){
+    FILE *fp = fopen(app_filename.c_str(), "r");
+    if (fp == NULL)
+        fatal("Error opening the %s.stp file!", app_filename.c_str());
+
+    int v[10];
+    float d[10];
+    //read the first line
+    //number of tasks, number of edges, number of PUs
+    int trace_type;
+
+    //get rid of headers
+    char ts[1000];
+    for (int i=0;i<15;i++)
+    {
+        fgets(ts,1000,fp);
+    }
+
+    fscanf(fp, "%d", &trace_type);assert(0==trace_type);
+    fscanf(fp, "%d", &m_num_proc);
+    fscanf(fp, "%d", &m_num_task[k]);
+    fscanf(fp, "%d", &m_num_edge[k]);
+
+    assert( m_num_task[k]>0 && m_num_edge[k]>0 && m_num_proc>0 &&\
+    m_applicaton_execution_iterations[k]>0);
+    //get head task information
+    fscanf(fp, "%d", &m_num_head_task[k]);
+    int head_task_id;
+    for (int i=0; i<m_num_head_task[k]; i++){
+        fscanf(fp, "%d", &head_task_id);
+        head_task[k].push_back(head_task_id);
+    }
+
+    // read the next number of tasks lines: task info
+    for (int i=0; i<m_num_task[k]; i++) {
+        fscanf(fp, "%d", &v[0]);    //task id
+        fscanf(fp, "%d", &v[1]);    //mapped proc id
+        fscanf(fp, "%d", &v[2]);    //shedule sequence number
+        fscanf(fp, "%f", &d[0]);    //mu & sigma for
+        fscanf(fp, "%f", &d[1]);    //task execution time distribution
+
+        addGraphTask(k, v[0], v[1], v[2], d[0], d[1]);
+    }
+
+    // read the next number of edges lines: communication info
+    vector<GraphTask *> tasks;
+    collectGraphTasks(k, tasks);
+    m_edges.reserve(m_edges.size() + m_num_edge[k]);
+    for (int i=0; i<m_num_edge[k]; i++){
+
+        fscanf(fp, "%d", &v[0]);//edge id
+        fscanf(fp, "%d", &v[1]);//src task id
+        fscanf(fp, "%d", &v[2]);//dst task id
+        fscanf(fp, "%d", &v[3]);//src proc id
+        fscanf(fp, "%d", &v[4]);//dst proc id
+        fscanf(fp, "%d", &v[5]);//out_memory_start_address
+        fscanf(fp, "%d", &v[6]);//out_memory_size
+        fscanf(fp, "%d", &v[7]);//in_memory_start_address
+        fscanf(fp, "%d", &v[8]);//in_memory_size
+
+        //mu & sigma for token size distribution
+        fscanf(fp, "%f", &d[0]);
+        fscanf(fp, "%f", &d[1]);
+        //lambda for pk generation interval distribution
+        fscanf(fp, "%f", &d[2]);
+
+        addGraphEdge(k, v, d, tasks);
+    }
+
+    fclose(fp);
+}
+
+void
+GarnetNetwork::loadBinaryApplication(int k, const std::string &app_filename){
+    TaskGraphBinary tgb;
+    tgb.load(app_filename);
+    const TaskGraphBinaryHeader &h = tgb.getHeader();
+
+    m_num_proc = h.num_proc;
+    m_num_task[k] = h.num_task;
+    m_num_edge[k] = h.num_edge;
+    m_num_head_task[k] = h.num_head_task;
+    assert(m_applicaton_execution_iterations[k]>0);
+    head_task[k].assign(tgb.head_task, tgb.head_task + h.num_head_task);
+
+    for (int i=0; i<h.num_task; i++)
+        addGraphTask(k, tgb.task_id[i], tgb.task_proc[i],
+            tgb.task_schedule[i], tgb.task_mu[i], tgb.task_sigma[i]);
+
+    vector<GraphTask *> tasks;
+    collectGraphTasks(k, tasks);
+    m_edges.reserve(m_edges.size() + h.num_edge);
+    int v[TaskGraphBinary::NUM_EDGE_FIELDS];
+    float d[3];
+    for (int i=0; i<h.num_edge; i++){
+        for (int f=0; f<TaskGraphBinary::NUM_EDGE_FIELDS; f++)
+            v[f] = tgb.edge_field[f][i];
+        d[0] = tgb.token_mu[i];
+        d[1] = tgb.token_sigma[i];
+        d[2] = tgb.pkt_lambda[i];
+        addGraphEdge(k, v, d, tasks);
+    }
+}
+
+// add the task to the processor
+void
+GarnetNetwork::addGraphTask(int k, int id, int proc_id, int schedule,
+    float mu, float sigma){
+    GraphTask t;
+    t.set_edge_store(&m_edges);
+    t.set_id(id);
+    proc_id = getMappedCore(proc_id);
+    t.set_proc_id(proc_id);
+    t.set_schedule(schedule);
+
+    t.set_statistical_execution_time(mu, sigma);
+    t.set_max_time(mu+2*sigma);
+
+    t.set_required_times(m_applicaton_execution_iterations[k],
+        m_task_graph_stats_window);
+    //for multi-app
+    t.set_app_idx(k);
+    t.seed_random_stream(m_task_graph_seed);
+    t.initial();
+
+    int current_node_id = getNodeIdbyCoreId(proc_id);
+
+    //head task not in the list
+    // std::vector<int>::iterator it = std::find(head_task[k].begin(), head_task[k].end(), v[0]);
+    // if (it!=head_task[k].end())
+        m_nis[current_node_id]->add_task(k, t, false);
+    // else
+    //     m_nis[current_node_id]->add_task(k, t, true);
+}
+
+// The tasks of application k by id. The task lists of k are complete, so
+// the pointers stay valid while its edges are added.
+void
+GarnetNetwork::collectGraphTasks(int k, vector<GraphTask *> &tasks){
+    tasks.assign(m_num_task[k], NULL);
+    for (int i=0; i < m_nodes/2; i++){
+        int num_cores_in_node = m_nis[i]->get_num_cores();
+        for (int j=0;j<num_cores_in_node;j++){
+            int core_id = m_nis[i]->get_core_id_by_index(j);
+            int task_list_len = m_nis[i]->get_task_list_length(j, k);
+            for (int l=0;l<task_list_len;l++){
+                GraphTask &t = m_nis[i]->get_task_by_offset(core_id, k, l);
+                if (t.get_id() >= tasks.size())
+                    tasks.resize(t.get_id() + 1, NULL);
+                if (tasks[t.get_id()] != NULL)
+                    fatal("Task %d of application %s is mapped twice !",
+                        t.get_id(), m_application_name[k]);
+                tasks[t.get_id()] = &t;
+            }
+        }
+    }
+}
+
+// v and d are the fields of an edge line of the .stp file
+void
+GarnetNetwork::addGraphEdge(int k, const int *v, const float *d,
+    vector<GraphTask *> &tasks){
+    // construct the edge
+    GraphEdge e(m_in_mem_size);
+    e.set_id(v[0]);
+    e.set_src_task_id(v[1]);
+    e.set_dst_task_id(v[2]);
+    e.set_src_proc_id(getMappedCore(v[3]));
+    e.set_dst_proc_id(getMappedCore(v[4]));
+    //Note Here! We just consider the size of the out memory for the source task
+    //e.set_out_memory(v[5],v[6]);
+    //e.set_out_memory(v[5],10);
+    e.set_out_memory(v[5],m_out_mem_size);
+
+    // if (v[6]==-1)
+    //     e.set_out_memory(v[5],INT_MAX);
+    // else
+    //     e.set_out_memory(v[5],v[6]);
+
+    //e.set_in_memory(v[7],v[8]);
+    e.set_in_memory(v[7],m_in_mem_size);
+
+
+    e.set_statistical_token_size(d[0], d[1]);
+    e.set_max_token_size(d[0]+2*d[1]);
+    e.set_statistical_pkt_interval(d[2]);
+
+    e.set_app_idx(k);
+    e.seed_random_stream(m_task_graph_seed);
+    e.initial();
+
+    if (e.get_src_task_id() >= tasks.size() ||
+        tasks[e.get_src_task_id()] == NULL ||
+        tasks[e.get_src_task_id()]->get_proc_id() != e.get_src_proc_id() ||
+        e.get_dst_task_id() >= tasks.size() ||
+        tasks[e.get_dst_task_id()] == NULL ||
+        tasks[e.get_dst_task_id()]->get_proc_id() != e.get_dst_proc_id())
+        fatal(" Error in finding task by task id ! ");
+
+    int src_node_id = getNodeIdbyCoreId(e.get_src_proc_id());
+    GraphTask &src_task = *tasks[e.get_src_task_id()];
+
+    int dst_node_id = getNodeIdbyCoreId(e.get_dst_proc_id());
+    GraphTask &dst_task = *tasks[e.get_dst_task_id()];
+
+    // Set vc_choice based on m_vc_allocation_object and node ID and vc_allocation_object_position
+    int vc_choice;
+    if(m_vc_allocation_object != " " && m_vcs_for_allocation > 0){
+        bool is_for_object = false;
+        int num_object = vc_allocation_object_position.size();
+        for (int i = 0; i < num_object; i++){
+            if((src_node_id == vc_allocation_object_position[i])||(dst_node_id \
+            == vc_allocation_object_position[i])){
+                vc_choice = (dst_node_id >= src_node_id);
+                is_for_object = true;
+                break;
+            }
+        }
+        if(is_for_object == false){
+            vc_choice = (dst_node_id >= src_node_id) + 2;
+        }
+    }
+    else if(m_vc_allocation_object == " " && m_vcs_for_allocation > 0){
+        fatal("vc_allocation_object is not assigned! vcs_for_allocation can not be positive!");
+    }
+    else{
+        vc_choice = (dst_node_id >= src_node_id);
+    }
+    e.set_vc_choice(vc_choice);
+
+    vector<int> &edges = m_edge_index[k];
+    if (e.get_id() >= edges.size())
+        edges.resize(e.get_id() + 1, -1);
+    if (edges[e.get_id()] != -1)
+        fatal("Edge %d of application %s is defined twice !",
+            e.get_id(), m_application_name[k]);
+    edges[e.get_id()] = m_edges.size();
+
+    src_task.add_outgoing_edge(m_edges.size());
+    dst_task.add_incoming_edge(m_edges.size());
+    m_edges.push_back(e);
+}
+
+// Record where every task lives, so that the NIs can find them by
+// (app_idx, id) without scanning the task lists. The edge index is
+// filled while the edges are loaded.
+void
+GarnetNetwork::buildTaskGraphIndex(){
+    m_task_index.assign(m_num_application, vector<task_index_type>());
+
+    for (int i=0; i < m_nodes/2; i++){
+        int num_cores_in_node = m_nis[i]->get_num_cores();
+        for (int j=0;j<num_cores_in_node;j++){
+            int core_id = m_nis[i]->get_core_id_by_index(j);
+            for (int app_idx=0;app_idx<m_num_application;app_idx++){
+                int task_list_len = m_nis[i]->get_task_list_length(j, app_idx);
+                for (int k=0;k<task_list_len;k++){
+                    GraphTask &t = m_nis[i]->get_task_by_offset(core_id, app_idx, k);
+
+                    vector<task_index_type> &tasks = m_task_index[app_idx];
+                    if (t.get_id() >= tasks.size())
+                        tasks.resize(t.get_id() + 1, task_index_type{-1, -1, -1, NULL});
+                    if (tasks[t.get_id()].task != NULL)
+                        fatal("Task %d of application %s is mapped twice !",
+                            t.get_id(), m_application_name[app_idx]);
+                    tasks[t.get_id()] = task_index_type{i, j, k, &t};
+                }
+            }
+        }
+    }
+
+    m_task_graph_indexed = true;
+}
+
 void
 GarnetNetwork::wakeup(){
     if (isTaskGraphEnabled()){
 
-        if (curCycle()%10000==0){
+        if (m_task_graph_sample_interval > 0 &&
+            curCycle() % m_task_graph_sample_interval == 0 &&
+            curCycle() != m_last_sample_cycle){
             *(throughput_info->stream())<<curCycle()<<"\t"<<current_execution_iterations[0]<<"\t"<<\
                 double(current_execution_iterations[0])*1000000000/curCycle()<<endl;
+            sampleTimeSeries();
         }
 
-        if (! checkApplicationFinish())
-        //each cycle would check finish
-            scheduleEvent(Cycles(1));
-        else {
+        if (! checkApplicationFinish()) {
+            //each cycle would check finish, in event-driven mode a
+            //completed iteration wakes the network instead and only the
+            //time series sample is left to schedule
+            if (!m_task_graph_event_driven)
+                scheduleEvent(Cycles(1));
+            else if (m_task_graph_sample_interval > 0)
+                scheduleEvent(Cycles(m_task_graph_sample_interval -
+                    curCycle() % m_task_graph_sample_interval));
+        } else {
+            //the last, partial window
+            if (time_series_info != NULL){
+                sampleTimeSeries();
+                flushTimeSeries();
+                simout.close(time_series_info);
+            }
             //collect simulation data
             PrintAppDelay();
             PrintTaskWaitingInfo();
+            if (m_analytical_network)
+                PrintAnalyticalSummary();
 /*
             for (int i = 0; i < m_nodes / 2; i++)
             {
@@ -1035,6 +1826,20 @@ GarnetNetwork::checkApplicationFinish(){
     for(int i=0;i<m_num_application;i++){
         if(current_execution_iterations[i]==m_applicaton_execution_iterations[i]){
             continue;
+        } else if (m_task_graph_ci_precision > 0) {
+            //once converged, an application keeps loading the network
+            //until the others are done
+            if (!m_app_converged[i] &&
+                m_app_delay_steady[i].converged(m_task_graph_ci_precision) &&
+                m_app_interval_steady[i].converged(
+                    m_task_graph_ci_precision)) {
+                m_app_converged[i] = true;
+                inform("Application %s reached steady state after %d "
+                    "iterations", m_application_name[i],
+                    current_execution_iterations[i]);
+            }
+            if (!m_app_converged[i])
+                return false;
         } else {
             return false;
         }
@@ -1058,6 +1863,7 @@ GarnetNetwork::constructArchitecture(std::string filename){
     int node_id;
     int num_cores_in_node;
     int sum_cores = 0;
+    int num_ddr_cores = 0;
     for (int i=0;i<num_nodes;i++){
         fscanf(fp, "%d", &node_id);
         fscanf(fp, "%d", &num_cores_in_node);
@@ -1101,12 +1907,27 @@ GarnetNetwork::constructArchitecture(std::string filename){
             core_id, core_name, core_thread, m_num_application))
             return false;
 
+        //with --task-graph-dram the DDR cores take the time of their
+        //accesses to a memory controller
+        for (int j=0;j<num_cores_in_node && !m_ddr_memories.empty();j++){
+            if (core_name[j].substr(0, core_name[j].find('-')) != "DDR")
+                continue;
+            if (num_ddr_cores == m_ddr_memories.size())
+                fatal("%s has more DDR cores than the %d memory "
+                    "controllers !", filename, m_ddr_memories.size());
+            m_nis[node_id]->setDdrMemory(core_id[j],
+                m_ddr_memories[num_ddr_cores++]);
+        }
+
         delete [] core_id;
         delete [] core_name;
         delete [] core_thread;
     }
 
     assert(m_core_id_node_id.size()==sum_cores);
+    if (num_ddr_cores < m_ddr_memories.size())
+        fatal("%s has %d DDR cores for %d memory controllers !", filename,
+            num_ddr_cores, m_ddr_memories.size());
     m_num_core = sum_cores;
 
     //print core map to node
@@ -1136,89 +1957,78 @@ GarnetNetwork::getNodeIdbyCoreId(int core_id){
 void
 GarnetNetwork::PrintAppDelay(){
     for (int app_idx=0;app_idx<m_num_application;app_idx++){
-        int Average_ETE_delay=0;
-        for (int i=0;i<m_applicaton_execution_iterations[app_idx];i++){
-/*           
-            if (m_print_task_execution_info)
-              *(task_start_time_vs_id_iters->stream())<<"Execution\n";
-            int max_time=-1;
-            int min_time=INT_MAX;
-            int max_time_core_id=-1;
-            int max_time_task_id=-1;
-            int min_time_core_id=-1;
-            int min_time_task_id=-1;
-            for (int j=0;j<m_nodes/2;j++){
-                int num_cores_in_node = m_nis[j]->get_num_cores();
-                for (int k=0;k<num_cores_in_node;k++){
-                    int task_list_len = m_nis[j]->\
-                        get_task_list_length(k, app_idx);
-                    int core_id = m_nis[j]->get_core_id_by_index(k);
-                    for (int l=0;l<task_list_len;l++){
-                        GraphTask& temp_task = m_nis[j]->\
-                            get_task_by_offset(core_id, app_idx, l);
-                        if (min_time > temp_task.get_start_time(i)){
-                            min_time_core_id = core_id;
-                            min_time_task_id = temp_task.get_id();
-                        }
-                        if (max_time < temp_task.get_end_time(i)){
-                            max_time_core_id = core_id;
-                            max_time_task_id = temp_task.get_id();
-                        }
-                        min_time = min(temp_task.get_start_time(i), min_time);
-                        max_time = max(temp_task.get_end_time(i), max_time);
-                        if (m_print_task_execution_info)
-                            *(task_start_time_vs_id_iters->stream())<<\
-                            temp_task.get_start_time(i)<<"\t"<<\
-                            core_id<<"\t"<<temp_task.get_id()<<"\n";
-                    }
-                }
-            }
-            if (m_print_task_execution_info){
-                *(task_start_end_time_vs_id->stream())<<"min\t"<<\
-                    min_time<<"\t"<<min_time_core_id<<"\t"\
-                    <<min_time_task_id<<"\n";
-                *(task_start_end_time_vs_id->stream())<<"max\t"<<\
-                    max_time<<"\t"<<max_time_core_id<<"\t"\
-                    <<max_time_task_id<<"\n";
-            }
-*/
-            Average_ETE_delay=Average_ETE_delay+ETE_delay[app_idx][i];
-        }
-        Average_ETE_delay = Average_ETE_delay / m_applicaton_execution_iterations[app_idx];
+        const RunningStats &delay = m_app_delay_stats[app_idx];
+        const QuantileSketch &sketch = m_app_delay_sketch[app_idx];
+        //fewer than the task graph file asks for once converged
+        int num_iters = current_execution_iterations[app_idx];
+        assert(delay.count() == num_iters);
 
         cout<<"info: Application - "<<m_application_name[app_idx]<<" - has executed successfully !\n";
-        printf("Execution iterations: %3d\n", m_applicaton_execution_iterations[app_idx]);
-        printf("Average Iteration Delay: %d\n", Average_ETE_delay);
-
-        for (int i=0; i<m_applicaton_execution_iterations[app_idx];i++){
-            int s=task_start_time[app_idx][i];
-            int e=task_end_time[app_idx][i];
-            printf("\tIteration %3d \tApplication Start time %10d \t\
-            Application End time %10d \t Applcation Execution Delay: \
-            %d\n", i, s, e, ETE_delay[app_idx][i]);
+        printf("Execution iterations: %3d\n", num_iters);
+        printf("Average Iteration Delay: %lu\n", uint64_t(delay.mean()));
+        printf("Iteration Delay Std Dev: %.2f\n", delay.stddev());
+        printf("Iteration Delay Min/Max: %lu / %lu\n",
+            uint64_t(delay.min()), uint64_t(delay.max()));
+        printf("Iteration Delay P50/P99: %.0f / %.0f\n",
+            sketch.quantile(0.5), sketch.quantile(0.99));
+        if (m_task_graph_ci_precision > 0)
+            PrintSteadyState(app_idx);
+
+        //only the iterations still in the window in streaming mode
+        int first = std::max(0, num_iters - m_num_iteration_slots[app_idx]);
+        if (first > 0)
+            printf("Last %d iterations:\n", m_num_iteration_slots[app_idx]);
+        for (int i=first; i<num_iters;i++){
+            int slot = i % m_num_iteration_slots[app_idx];
+            uint64_t s=task_start_time[app_idx][slot];
+            uint64_t e=task_end_time[app_idx][slot];
+            printf("\tIteration %3d \tApplication Start time %10lu \t\
+            Application End time %10lu \t Applcation Execution Delay: \
+            %lu\n", i, s, e, ETE_delay[app_idx][slot]);
         }
     }
 }
 
+void
+GarnetNetwork::PrintSteadyState(int app_idx)
+{
+    const SteadyStateDetector &delay = m_app_delay_steady[app_idx];
+    const SteadyStateDetector &interval = m_app_interval_steady[app_idx];
+    if (!delay.ready() || !interval.ready() || interval.mean() <= 0) {
+        printf("Steady State: not reached\n");
+        return;
+    }
+
+    double cycle_seconds =
+        double(cyclesToTicks(Cycles(1))) / SimClock::Frequency;
+    double throughput = 1 / (interval.mean() * cycle_seconds);
+    printf("Warm-up Truncated (delay/throughput): %lu / %lu iterations\n",
+        delay.warmup(), interval.warmup());
+    printf("Steady-state Iteration Delay: %.2f +- %.2f (95%% CI)\n",
+        delay.mean(), delay.halfWidth());
+    printf("Steady-state Throughput: %.2f +- %.2f iterations/s (95%% CI)\n",
+        throughput, throughput * interval.halfWidth() / interval.mean());
+}
+
 void
 GarnetNetwork::PrintTaskWaitingInfo(){
 
-    int **node_waiting_time;
-    int **core_waiting_time;
+    uint64_t **node_waiting_time;
+    uint64_t **core_waiting_time;
     string *core_waiting_name;
-    int *total_node_waiting_time;
-    int *total_core_waiting_time;
+    uint64_t *total_node_waiting_time;
+    uint64_t *total_core_waiting_time;
 
     //new
-    node_waiting_time = new int* [m_num_application];
-    core_waiting_time = new int* [m_num_application];
+    node_waiting_time = new uint64_t* [m_num_application];
+    core_waiting_time = new uint64_t* [m_num_application];
     core_waiting_name = new string [m_num_core];
-    total_core_waiting_time = new int [m_num_core];
-    total_node_waiting_time = new int [m_nodes/2];
+    total_core_waiting_time = new uint64_t [m_num_core];
+    total_node_waiting_time = new uint64_t [m_nodes/2];
     //initial
     for (int i=0;i<m_num_application;i++){
-        core_waiting_time[i] = new int [m_num_core];
-        node_waiting_time[i] = new int [m_nodes/2];
+        core_waiting_time[i] = new uint64_t [m_num_core];
+        node_waiting_time[i] = new uint64_t [m_nodes/2];
     }
 
     for (int i=0;i<m_num_application;i++){
@@ -1239,20 +2049,19 @@ GarnetNetwork::PrintTaskWaitingInfo(){
         for (int j = 0; j < m_nodes / 2; j++){
 
             int num_cores_in_node = m_nis[j]->get_num_cores();
-            int node_task_waiting_time = 0;
+            uint64_t node_task_waiting_time = 0;
 
             for (int k = 0; k < num_cores_in_node; k++){
 
                 int task_list_len = m_nis[j]->get_task_list_length(k, app_idx);
                 int core_id = m_nis[j]->get_core_id_by_index(k);
                 string core_name = m_nis[j]->get_core_name_by_index(k);
-                int core_task_waiting_time = 0;
+                uint64_t core_task_waiting_time = 0;
 
                 for (int l = 0; l < task_list_len; l++){
 
                     GraphTask &temp_task = m_nis[j]->get_task_by_offset(core_id, app_idx, l);
-                    for (int m = 0; m < m_applicaton_execution_iterations[app_idx]; m++)
-                        core_task_waiting_time += temp_task.get_task_waiting_time(m);
+                    core_task_waiting_time += temp_task.get_total_waiting_time();
                 }
 
                 core_waiting_time[app_idx][core_id] = core_task_waiting_time;
@@ -1323,19 +2132,121 @@ GarnetNetwork::PrintTaskWaitingInfo(){
 void
 GarnetNetwork::output_ete_delay(int app_idx, int ex_iters)
 {
-    ETE_delay[app_idx][ex_iters] = task_end_time[app_idx][ex_iters] - task_start_time[app_idx][ex_iters];
+    int slot = ex_iters % m_num_iteration_slots[app_idx];
+    ETE_delay[app_idx][slot] = task_end_time[app_idx][slot] - task_start_time[app_idx][slot];
+    m_app_delay_stats[app_idx].sample(ETE_delay[app_idx][slot]);
+    m_app_delay_sketch[app_idx].sample(ETE_delay[app_idx][slot]);
+    if (m_task_graph_ci_precision > 0) {
+        //the iterations end in order of completion but not quite of end
+        //time, an early end only closes a zero interval
+        uint64_t end = std::max(task_end_time[app_idx][slot],
+            m_app_last_end[app_idx]);
+        m_app_delay_steady[app_idx].sample(ETE_delay[app_idx][slot]);
+        m_app_interval_steady[app_idx].sample(end - m_app_last_end[app_idx]);
+        m_app_last_end[app_idx] = end;
+    }
 
-    *(app_delay_running_info->stream())<<m_application_name[app_idx]<<"\t"<<ex_iters<<"\t"<<task_start_time[app_idx][ex_iters]<<\
-        "\t"<<task_end_time[app_idx][ex_iters]<<"\t"<<ETE_delay[app_idx][ex_iters]<<endl;
+    *(app_delay_running_info->stream())<<m_application_name[app_idx]<<"\t"<<ex_iters<<"\t"<<task_start_time[app_idx][slot]<<\
+        "\t"<<task_end_time[app_idx][slot]<<"\t"<<ETE_delay[app_idx][slot]<<endl;
 
     *(network_performance_info->stream())<<m_application_name[app_idx]<<"\t"<<ex_iters<<"\t"<<m_avg_flit_latency.total()<<"\t"<<m_avg_flit_network_latency.total()<<\
-        "\t"<<m_avg_flit_queueing_latency.total()<<"\t"<<m_flits_received.total()<<"\t"<<m_avg_hops.total()<<endl;
+        "\t"<<m_avg_flit_queueing_latency.total()<<"\t"<<m_flits_received.total()<<"\t"<<m_avg_hops.total()<<\
+        "\t"<<m_avg_smart_hops.total()<<endl;
     
     // *(start_time_info->stream())<<task_start_time[app_idx][ex_iters]<<endl;
     // *(end_time_info->stream())<<task_end_time[app_idx][ex_iters]<<endl;
     // *(ete_info->stream())<<ETE_delay[app_idx][ex_iters]<<endl;
 }
 
+void
+GarnetNetwork::sampleTimeSeries()
+{
+    //rows are collected and written out in large blocks
+    const size_t flush_size = 1 << 20;
+
+    Cycles window = curCycle() - m_last_sample_cycle;
+    if (window == 0)
+        return;
+    double window_seconds =
+        double(cyclesToTicks(window)) / SimClock::Frequency;
+
+    ostringstream row;
+    row<<curCycle();
+
+    for (int i=0;i<m_num_application;i++){
+        int iters = current_execution_iterations[i] - m_sampled_iterations[i];
+        m_sampled_iterations[i] = current_execution_iterations[i];
+        m_window_app_iterations[i].sample(iters);
+        row<<","<<iters / window_seconds;
+    }
+
+    //the stats may have been reset since the last sample
+    double latency = m_flit_network_latency.total() +
+        m_flit_queueing_latency.total();
+    double received = m_flits_received.total();
+    if (received < m_sampled_flits_received){
+        m_sampled_flit_latency = 0;
+        m_sampled_flits_received = 0;
+    }
+    double window_flits = received - m_sampled_flits_received;
+    row<<","<<((window_flits > 0) ?
+        (latency - m_sampled_flit_latency) / window_flits : 0);
+    m_sampled_flit_latency = latency;
+    m_sampled_flits_received = received;
+
+    for (int i=0;i<m_networklinks.size();i++){
+        unsigned int activity = m_networklinks[i]->getLinkUtilization();
+        if (activity < m_sampled_link_utilization[i])
+            m_sampled_link_utilization[i] = 0;
+        double utilization =
+            double(activity - m_sampled_link_utilization[i]) / window;
+        m_sampled_link_utilization[i] = activity;
+        m_window_link_utilization.sample(utilization);
+        row<<","<<utilization;
+    }
+
+    for (int i=0;i<m_nis.size();i++){
+        int depth = m_nis[i]->getInjectionQueueDepth();
+        m_window_ni_queue_depth.sample(depth);
+        row<<","<<depth;
+    }
+    row<<"\n";
+
+    m_time_series_buffer += row.str();
+    m_last_sample_cycle = curCycle();
+    if (m_time_series_buffer.size() >= flush_size)
+        flushTimeSeries();
+}
+
+void
+GarnetNetwork::flushTimeSeries()
+{
+    if (time_series_info == NULL || m_time_series_buffer.empty())
+        return;
+    time_series_info->stream()->write(m_time_series_buffer.data(),
+        m_time_series_buffer.size());
+    m_time_series_buffer.clear();
+}
+
+int
+GarnetNetwork::claimIterationSlot(int app_idx, int ex_iters)
+{
+    int slot = ex_iters % m_num_iteration_slots[app_idx];
+    int &owner = m_slot_iteration[app_idx][slot];
+    if (owner != ex_iters) {
+        assert(owner < ex_iters);
+        if (owner >= current_execution_iterations[app_idx])
+            fatal("Application %s has more than %d iterations in flight, "
+                "raise --task-graph-stats-window !",
+                m_application_name[app_idx], m_num_iteration_slots[app_idx]);
+        owner = ex_iters;
+        task_start_time[app_idx][slot] = UINT64_MAX;
+        task_end_time[app_idx][slot] = 0;
+        num_completed_tasks[app_idx][slot] = 0;
+    }
+    return slot;
+}
+
 bool
 GarnetNetwork::back_pressure(int m_id){
     /*
@@ -1351,12 +2262,4 @@ GarnetNetwork::back_pressure(int m_id){
     return false;
 }
 
-void
-GarnetNetwork::update_in_memory_info(int core_id, int app_idx, int src_task_id, int edge_id){
-    int node_id = getNodeIdbyCoreId(core_id);
-    GraphTask &src_task = m_nis[node_id]->get_task_by_task_id(core_id, app_idx, src_task_id);
-    GraphEdge &out_edge = src_task.get_outgoing_edge_by_eid(edge_id);
-
-    assert(out_edge.update_in_memory_read_pointer());
-}
 
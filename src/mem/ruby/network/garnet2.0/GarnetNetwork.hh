@@ -34,7 +34,9 @@
 #ifndef __MEM_RUBY_NETWORK_GARNET2_0_GARNETNETWORK_HH__
 #define __MEM_RUBY_NETWORK_GARNET2_0_GARNETNETWORK_HH__
 
+#include <algorithm>
 #include <iostream>
+#include <string>
 #include <vector>
 
 #include "base/output.hh"
@@ -44,16 +46,29 @@
 #include "mem/ruby/network/fault_model/FaultModel.hh"
 #include "mem/ruby/network/garnet2.0/CommonTypes.hh"
 #include "mem/ruby/network/garnet2.0/GraphTask.hh"
+#include "mem/ruby/network/garnet2.0/TaskGraphStats.hh"
 #include "params/GarnetNetwork.hh"
 #include "sim/sim_exit.hh"
 
+class AnalyticalNetworkModel;
 class FaultModel;
 class NetworkInterface;
 class Router;
+class RouterThreadPool;
+class TaskGraphMemory;
 class NetDest;
 class NetworkLink;
 class CreditLink;
 
+//dense index of the task graph, built once the traffic is loaded
+struct task_index_type
+{
+    int node_id;    //NI the task is mapped to
+    int core_idx;   //index of the core in the NI
+    int offset;     //offset in the task list of the core
+    GraphTask *task;
+};
+
 class GarnetNetwork : public Network, public Consumer
 {
   public:
@@ -62,6 +77,17 @@ class GarnetNetwork : public Network, public Consumer
 
     ~GarnetNetwork();
     void init();
+    void startup() override;
+
+    // The network is drained before a checkpoint, the NIs hold their
+    // pkts back meanwhile. Only the task graph state is saved then, so
+    // the routers, VCs and links start empty on a restore.
+    DrainState drain() override;
+    void serialize(CheckpointOut &cp) const override;
+    void unserialize(CheckpointIn &cp) override;
+    //ddr_port[i] goes to the memory controller of the i-th DDR core
+    Port &getPort(const std::string &if_name,
+        PortID idx=InvalidPortID) override;
     //add for task graph
     void wakeup();
     void scheduleWakeupAbsolute(Cycles time);
@@ -78,17 +104,92 @@ class GarnetNetwork : public Network, public Consumer
     uint32_t getBuffersPerDataVC() { return m_buffers_per_data_vc; }
     uint32_t getBuffersPerCtrlVC() { return m_buffers_per_ctrl_vc; }
     int getRoutingAlgorithm() const { return m_routing_algorithm; }
+    int getSwitchAllocator() const { return m_switch_allocator; }
+    bool isLookaheadRouting() const { return m_lookahead_routing; }
+    bool isRouterBypass() const { return m_router_bypass; }
+    int getSmartHpcMax() const { return m_smart_hpc_max; }
+    int getRouterThreads() const { return m_router_threads; }
+    // with router threads, SMART or the bypass, the wakeups of the routers
+    // only gather them, the routers of the cycle are evaluated together
+    // once all of them are in
+    bool isRouterEvaluationBatched() const
+    {
+        return m_router_threads > 1 || m_smart_hpc_max > 1 ||
+            m_router_bypass;
+    }
+    void scheduleRouterEvaluation(Router *router);
+    void evaluateRouters();
 
     bool isFaultModelEnabled() const { return m_enable_fault_model; }
     FaultModel* fault_model;
 
     //for Task Graph
     bool isTaskGraphEnabled() { return m_task_graph_enable; }
+    bool isTaskGraphEventDriven() { return m_task_graph_event_driven; }
+    //0 runs every application for the iterations of the task graph file
+    double getTaskGraphCIPrecision() const
+    { return m_task_graph_ci_precision; }
     std::string getTaskGraphFilename() { return m_task_graph_file; }
     int getTokenLenInPkt() { return m_token_packet_length; }
+    //task graph pkts skip the routers and take the latency of the
+    //analytical model
+    bool isAnalyticalNetwork() const { return m_analytical_network; }
+    AnalyticalNetworkModel *
+    getAnalyticalModel()
+    {
+        assert(m_analytical_model != NULL);
+        return m_analytical_model;
+    }
+    NetworkInterface *getNetworkInterface(int ni) { return m_nis[ni]; }
+    //the core running the tasks the task graph file maps to core_id
+    int
+    getMappedCore(int core_id)
+    {
+        if (m_task_core_map.empty())
+            return core_id;
+        return m_task_core_map[core_id];
+    }
 
     bool loadTraffic(std::string filename);
+    std::string getApplicationFilename(int k);
+    //moves the tasks of the cores with --task-mapping-search-moves and
+    //writes the remapped applications to the output directory
+    void searchTaskMapping();
+    void routerShortestPaths(int src, std::vector<int> &distance,
+        std::vector<int> &prev, std::vector<NetworkLink *> &prev_link);
+    //the paths of the analytical network, once the links are in
+    void buildAnalyticalModel();
+    void PrintAnalyticalSummary();
+    //an application file is either a .stp text or a .tgb binary
+    void loadTextApplication(int k, const std::string &app_filename);
+    void loadBinaryApplication(int k, const std::string &app_filename);
+    void addGraphTask(int k, int id, int proc_id, int schedule,
+        float mu, float sigma);
+    void collectGraphTasks(int k, std::vector<GraphTask *> &tasks);
+    void addGraphEdge(int k, const int *v, const float *d,
+        std::vector<GraphTask *> &tasks);
+    //O(1) lookup of tasks and edges by (app_idx, id)
+    void buildTaskGraphIndex();
+    std::vector<GraphEdge> &get_edge_store() { return m_edges; }
+    bool isTaskGraphIndexed() { return m_task_graph_indexed; }
+    const task_index_type &
+    get_task_index(int app_idx, int tid)
+    {
+        assert(tid >= 0 && tid < m_task_index[app_idx].size());
+        assert(m_task_index[app_idx][tid].task != NULL);
+        return m_task_index[app_idx][tid];
+    }
+    GraphEdge &
+    get_edge(int app_idx, int eid)
+    {
+        assert(eid >= 0 && eid < m_edge_index[app_idx].size());
+        assert(m_edge_index[app_idx][eid] >= 0);
+        return m_edges[m_edge_index[app_idx][eid]];
+    }
     bool checkApplicationFinish();
+    //one row of the time series every m_task_graph_sample_interval cycles
+    void sampleTimeSeries();
+    void flushTimeSeries();
     //for construct architecture in task graph mode
     bool constructArchitecture(std::string filename);
     int getNodeIdbyCoreId(int core_id);
@@ -98,6 +199,8 @@ class GarnetNetwork : public Network, public Consumer
     bool IsPrintTaskExecuInfo(){return m_print_task_execution_info;}
 
     void PrintAppDelay();
+    //warm-up and confidence intervals with --task-graph-ci-precision
+    void PrintSteadyState(int app_idx);
     void PrintTaskWaitingInfo();
 
     //for Ring Topology
@@ -113,6 +216,7 @@ class GarnetNetwork : public Network, public Consumer
     }
     int getNumRouters();
     int get_router_id(int ni);
+    const NetDest &getNetDest(int ni) { return m_ni_net_dest[ni]; }
     //record PE-7 position for initial task judgement in NI
     int get_entrance_NI(){ return entrance_NI; }
     int get_entrance_core(){ return entrance_core; }
@@ -176,6 +280,12 @@ class GarnetNetwork : public Network, public Consumer
         m_total_hops += hops;
     }
 
+    void
+    increment_total_smart_hops(int hops)
+    {
+        m_total_smart_hops += hops;
+    }
+
     void
     add_execution_time_to_total(int ex_time)
     {
@@ -194,27 +304,37 @@ class GarnetNetwork : public Network, public Consumer
     void
     add_num_completed_tasks(int app_idx, int ex_iters){
         //Note here! ex_iters should minus 1
-        num_completed_tasks[app_idx][ex_iters-1]++;
-        if(num_completed_tasks[app_idx][ex_iters-1] == m_num_task[app_idx]){
+        int slot = (ex_iters-1) % m_num_iteration_slots[app_idx];
+        assert(m_slot_iteration[app_idx][slot] == ex_iters-1);
+        num_completed_tasks[app_idx][slot]++;
+        if(num_completed_tasks[app_idx][slot] == m_num_task[app_idx]){
             //if num_tasks satisfied, then we can ensure the iteration had done.
             current_execution_iterations[app_idx]++;
             assert(ex_iters==current_execution_iterations[app_idx]);
             output_ete_delay(app_idx, ex_iters-1);
+            //the network only has to check for completion now
+            if (m_task_graph_event_driven)
+                scheduleEvent(Cycles(1));
         }
     }
 
     //update start, end time
     void
-    update_start_end_time(int app_idx, int ex_iters, int start, int end){
+    update_start_end_time(int app_idx, int ex_iters, uint64_t start,
+        uint64_t end){
         //compare the task start time and end time
-        task_start_time[app_idx][ex_iters] = (start<task_start_time[app_idx][ex_iters])?\
-            start:task_start_time[app_idx][ex_iters];
-        task_end_time[app_idx][ex_iters] = (end>task_end_time[app_idx][ex_iters])?\
-            end:task_end_time[app_idx][ex_iters];
+        int slot = claimIterationSlot(app_idx, ex_iters);
+        task_start_time[app_idx][slot] =
+            std::min(start, task_start_time[app_idx][slot]);
+        task_end_time[app_idx][slot] =
+            std::max(end, task_end_time[app_idx][slot]);
     }
 
     //print ete-delay for certain iteration of one application
     void output_ete_delay(int app_idx, int ex_iters);
+    //the slot of the iteration, taken over from the iteration it held
+    //before, which must have completed
+    int claimIterationSlot(int app_idx, int ex_iters);
 
     //for debug
     OutputStream *task_start_time_vs_id;
@@ -230,10 +350,11 @@ class GarnetNetwork : public Network, public Consumer
     OutputStream *network_performance_info;
     //for the task waiting time
     OutputStream *task_waiting_time_info;
+    //windowed throughput, latency, link utilization and NI queue depth
+    OutputStream *time_series_info;
     //
     bool back_pressure(int m_id);
     // update the in memory remianed information for the src task in src core when record pkt
-    void update_in_memory_info(int core_id, int app_idx, int src_task_id, int edge_id);
 
     // find greatest common divisor, for ratio token in NI
     int gcd(int a, int b){
@@ -250,8 +371,38 @@ class GarnetNetwork : public Network, public Consumer
     uint32_t m_buffers_per_ctrl_vc;
     uint32_t m_buffers_per_data_vc;
     int m_routing_algorithm;
+    int m_switch_allocator;
+    bool m_lookahead_routing;
+    bool m_router_bypass;
+    int m_smart_hpc_max;
+    int m_router_threads;
+    RouterThreadPool *m_router_pool;
+    std::vector<Router *> m_ready_routers;
+    EventFunctionWrapper m_router_evaluation_event;
+    //no flit or credit left in the routers, links and NIs
+    bool isNetworkDrained();
+    void checkDrained();
+    EventFunctionWrapper m_drain_event;
     bool m_enable_fault_model;
     bool m_task_graph_enable;
+    bool m_task_graph_event_driven;
+    uint32_t m_task_graph_seed;
+    bool m_task_graph_quiet_load;
+    uint32_t m_task_graph_stats_window;
+    uint32_t m_task_graph_sample_interval;
+    double m_task_graph_ci_precision;
+    uint32_t m_task_mapping_search_moves;
+    uint32_t m_task_mapping_search_threads;
+    //core id in the task graph file -> core id running its tasks, empty
+    //without a mapping search
+    std::map<int, int> m_task_core_map;
+    //routers reached by the internal links of every router
+    std::vector<std::vector<int> > m_router_neighbours;
+    std::vector<std::vector<NetworkLink *> > m_router_neighbour_links;
+    bool m_analytical_network;
+    AnalyticalNetworkModel *m_analytical_model;
+    //the memory of every DDR core, in the order of the architecture file
+    std::vector<TaskGraphMemory *> m_ddr_memories;
     std::string m_task_graph_file;
     int m_token_packet_length;
     std::string m_topology;
@@ -265,10 +416,32 @@ class GarnetNetwork : public Network, public Consumer
     int* m_num_task;
     int* m_num_edge;
     int* m_num_head_task;
-    std::vector<std::vector<int> > task_start_time;
-    std::vector<std::vector<int> > task_end_time;
-    std::vector<std::vector<int> > ETE_delay;
+    //iteration i of an application is in slot i % its number of slots,
+    //one per iteration, or --task-graph-stats-window ones in streaming mode
+    std::vector<int> m_num_iteration_slots;
+    std::vector<std::vector<int> > m_slot_iteration;
+    std::vector<std::vector<uint64_t> > task_start_time;
+    std::vector<std::vector<uint64_t> > task_end_time;
+    std::vector<std::vector<uint64_t> > ETE_delay;
+    //iteration delays of every application, including the iterations that
+    //left the window
+    std::vector<RunningStats> m_app_delay_stats;
+    std::vector<QuantileSketch> m_app_delay_sketch;
+    //with --task-graph-ci-precision, the steady state of the iteration
+    //delay and of the time between two iteration ends (1 / throughput);
+    //an application is done once both converged
+    std::vector<SteadyStateDetector> m_app_delay_steady;
+    std::vector<SteadyStateDetector> m_app_interval_steady;
+    std::vector<uint64_t> m_app_last_end;
+    std::vector<bool> m_app_converged;
     std::vector<std::vector<int> > head_task;
+    //[app_idx][task_id] and [app_idx][edge_id]
+    bool m_task_graph_indexed;
+    std::vector<std::vector<task_index_type> > m_task_index;
+    std::vector<std::vector<int> > m_edge_index;
+    //all the edges of all the applications, shared by the source and
+    //the dest task, which only keep the index of the edge
+    std::vector<GraphEdge> m_edges;
     //for construct architecture in task graph mode
     std::map<int, int> m_core_id_node_id; //core_id -> node_id
     //for multi-application traffic
@@ -320,9 +493,31 @@ class GarnetNetwork : public Network, public Consumer
 
     Stats::Scalar  m_total_hops;
     Stats::Formula m_avg_hops;
+    Stats::Scalar  m_total_smart_hops;
+    Stats::Formula m_avg_smart_hops;
+
+    Stats::Scalar m_peak_live_flits;
+    Stats::Scalar m_peak_live_credits;
 
     //add for TG
     Stats::Scalar m_total_task_execution_time;
+    Stats::Scalar m_max_generator_buffer_pending;
+    Stats::Scalar m_peak_live_generator_entries;
+    Stats::Vector m_app_completed_iterations;
+    Stats::Formula m_app_throughput;
+    //one sample per time series window
+    Stats::VectorStandardDeviation m_window_app_iterations;
+    Stats::Distribution m_window_link_utilization;
+    Stats::Histogram m_window_ni_queue_depth;
+
+    //counters at the last sample, the rows hold the differences
+    Cycles m_last_sample_cycle;
+    std::vector<int> m_sampled_iterations;
+    std::vector<unsigned int> m_sampled_link_utilization;
+    double m_sampled_flit_latency;
+    double m_sampled_flits_received;
+    //rows not written out yet
+    std::string m_time_series_buffer;
 
     int m_in_mem_size;
     int m_out_mem_size;
@@ -336,6 +531,7 @@ class GarnetNetwork : public Network, public Consumer
     std::vector<NetworkLink *> m_networklinks; // All flit links in the network
     std::vector<CreditLink *> m_creditlinks; // All credit links in the network
     std::vector<NetworkInterface *> m_nis;   // All NI's in Network
+    std::vector<NetDest> m_ni_net_dest; // NetDest of every NI
 };
 
 inline std::ostream&
@@ -43,12 +43,52 @@ class GarnetNetwork(RubyNetwork):
     buffers_per_data_vc = Param.UInt32(4, "buffers per data virtual channel");
     buffers_per_ctrl_vc = Param.UInt32(1, "buffers per ctrl virtual channel");
     routing_algorithm = Param.Int(0,
-        "0: Weight-based Table, 1: XY, 2: Custom");
+        """0: Weight-based Table, 1: XY, 2: Custom, 3: West-first adaptive,
+        4: Odd-even adaptive, 5: Ring shortest direction with dateline""");
+    switch_allocator = Param.Int(0,
+        "0: separable input-first, 1: iSLIP, 2: wavefront");
+    lookahead_routing = Param.Bool(False, """compute the route of a packet
+        for the next router on the link, saving the route computation
+        stage of the router pipeline""");
+    router_bypass = Param.Bool(False, """let a flit alone in the router
+        skip the buffer stages and reach its output on the cycle it
+        arrives, needs lookahead_routing""");
+    smart_hpc_max = Param.UInt32(1, """SMART: most hops a flit may go
+        through in one cycle when the routers on its straight path are
+        idle, 1 disables it, needs lookahead_routing""");
+    router_threads = Param.UInt32(1, """host threads evaluating the routers
+        of one cycle in parallel, 1 evaluates them one by one""");
     enable_fault_model = Param.Bool(False, "enable network fault model");
     fault_model = Param.FaultModel(NULL, "network fault model");
     garnet_deadlock_threshold = Param.UInt32(50000,
                               "network-level deadlock threshold");
     task_graph_enable = Param.Bool(False, "enable the task graph traffic");
+    analytical_network = Param.Bool(False, """task graph pkts skip the
+        routers and take the latency of a per link M/D/1 model""");
+    ddr_port = VectorMasterPort("""memory controllers of the DDR cores of
+        the task graph, one per DDR core in the architecture file order""")
+    system = Param.System(Parent.any, "system object")
+    task_graph_event_driven = Param.Bool(False, """wake the task graph
+        network interfaces only on task, flit generation and token events
+        instead of every cycle""");
+    task_graph_seed = Param.UInt32(0, """seed of the task graph random
+        numbers, 0 seeds from the wall clock""");
+    task_graph_quiet_load = Param.Bool(False, """do not print the node
+        configuration and the tasks of every core when loading""");
+    task_graph_stats_window = Param.UInt32(0, """keep the times of only the
+        last iterations of every application and stream the delay stats,
+        must cover the iterations in flight. 0 keeps every iteration""");
+    task_graph_sample_interval = Param.UInt32(10000, """cycles between two
+        rows of the task graph time series, 0 disables it""");
+    task_graph_ci_precision = Param.Float(0.0, """stop an application once
+        the 95% confidence half width of its steady state iteration delay
+        and throughput is within this fraction of the mean, 0 runs the
+        iterations of the task graph file""");
+    task_mapping_search_moves = Param.UInt32(0, """simulated annealing
+        moves of the task to core mapping search run before loading the
+        task graph, 0 keeps the mapping of the task graph file""");
+    task_mapping_search_threads = Param.UInt32(1, """host threads of the
+        task to core mapping search, each one anneals its own mapping""");
     task_graph_file = Param.String(" ", "task graph input file");
     token_packet_length = Param.Int(8, "task token packet length in flits");
     topology = Param.String("Crossbar", "check topologies for complete set");
@@ -0,0 +1,265 @@
+#include "mem/ruby/network/garnet2.0/GeneratorBuffer.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <new>
+
+namespace
+{
+
+bool
+earlier_seq(const generator_buffer_type *a, const generator_buffer_type *b)
+{
+    return a->seq < b->seq;
+}
+
+}
+
+GeneratorBuffer::GeneratorBuffer()
+    : m_slots(m_num_slots, NULL), m_overflow_min(MaxTick), m_in_wheel(0),
+      m_cursor(0), m_ready_head(NULL), m_seq(0), m_size(0), m_peak_size(0)
+{
+}
+
+GeneratorBuffer::~GeneratorBuffer()
+{
+    for (int i = 0; i < m_num_slots; i++) {
+        generator_buffer_type *e = m_slots[i];
+        while (e != NULL) {
+            generator_buffer_type *next = e->next;
+            delete e->flit_to_generate;
+            freeEntry(e);
+            e = next;
+        }
+    }
+    for (int i = 0; i < m_overflow.size(); i++) {
+        delete m_overflow[i]->flit_to_generate;
+        freeEntry(m_overflow[i]);
+    }
+    generator_buffer_type *e = m_ready_head;
+    while (e != NULL) {
+        generator_buffer_type *next = e->next;
+        delete e->flit_to_generate;
+        freeEntry(e);
+        e = next;
+    }
+}
+
+SlabPool &
+GeneratorBuffer::pool()
+{
+    //shared by the generator buffers of all the cores
+    static SlabPool *p = new SlabPool(sizeof(generator_buffer_type));
+    return *p;
+}
+
+generator_buffer_type *
+GeneratorBuffer::allocEntry()
+{
+    return new (pool().alloc()) generator_buffer_type();
+}
+
+void
+GeneratorBuffer::freeEntry(generator_buffer_type *e)
+{
+    pool().free(e);
+}
+
+// put the entry in the wheel, the overflow list, or the due list if its
+// release cycle has already been drained
+void
+GeneratorBuffer::place(generator_buffer_type *e,
+    std::vector<generator_buffer_type *> &due)
+{
+    if (e->release_time < m_cursor) {
+        due.push_back(e);
+    } else if (e->release_time < m_cursor + Cycles(m_num_slots)) {
+        generator_buffer_type *&slot =
+            m_slots[e->release_time & (m_num_slots - 1)];
+        e->next = slot;
+        slot = e;
+        m_in_wheel++;
+    } else {
+        m_overflow.push_back(e);
+        m_overflow_min = std::min(m_overflow_min, e->release_time);
+    }
+}
+
+void
+GeneratorBuffer::insert(flit *fl, Cycles release_time)
+{
+    generator_buffer_type *e = allocEntry();
+    e->flit_to_generate = fl;
+    e->release_time = release_time;
+    e->seq = m_seq++;
+    e->next = NULL;
+
+    m_due.clear();
+    place(e, m_due);
+    if (!m_due.empty()) {
+        //released before the cursor, it is the youngest entry so it
+        //goes to the tail of the ready list
+        generator_buffer_type **tail = &m_ready_head;
+        while (*tail != NULL)
+            tail = &(*tail)->next;
+        *tail = e;
+    }
+
+    m_size++;
+    m_peak_size = std::max(m_peak_size, m_size);
+}
+
+void
+GeneratorBuffer::advance(Cycles cur_time)
+{
+    if (cur_time < m_cursor)
+        return;
+
+    m_due.clear();
+
+    //every entry in the wheel is released before m_cursor + m_num_slots,
+    //so at most one lap of the wheel has to be drained
+    if (m_in_wheel > 0) {
+        uint64_t num_cycles = std::min<uint64_t>(cur_time - m_cursor + 1,
+            m_num_slots);
+        for (uint64_t c = 0; c < num_cycles && m_in_wheel > 0; c++) {
+            generator_buffer_type *&slot =
+                m_slots[(m_cursor + c) & (m_num_slots - 1)];
+            for (generator_buffer_type *e = slot; e != NULL; ) {
+                generator_buffer_type *next = e->next;
+                assert(e->release_time <= cur_time);
+                m_due.push_back(e);
+                m_in_wheel--;
+                e = next;
+            }
+            slot = NULL;
+        }
+    }
+    m_cursor = cur_time + Cycles(1);
+
+    //the window moved on, pull the overflow entries it now covers
+    if (m_overflow_min < m_cursor + Cycles(m_num_slots)) {
+        std::vector<generator_buffer_type *> overflow;
+        overflow.swap(m_overflow);
+        m_overflow_min = Cycles(MaxTick);
+        for (int i = 0; i < overflow.size(); i++)
+            place(overflow[i], m_due);
+    }
+
+    if (m_due.empty())
+        return;
+
+    //merge the released entries in the ready list by insertion order
+    std::sort(m_due.begin(), m_due.end(), earlier_seq);
+    generator_buffer_type **tail = &m_ready_head;
+    for (int i = 0; i < m_due.size(); i++) {
+        while (*tail != NULL && (*tail)->seq < m_due[i]->seq)
+            tail = &(*tail)->next;
+        m_due[i]->next = *tail;
+        *tail = m_due[i];
+        tail = &m_due[i]->next;
+    }
+}
+
+generator_buffer_type *
+GeneratorBuffer::release(generator_buffer_type *prev,
+    generator_buffer_type *e)
+{
+    generator_buffer_type *next = e->next;
+    if (prev == NULL) {
+        assert(m_ready_head == e);
+        m_ready_head = next;
+    } else {
+        assert(prev->next == e);
+        prev->next = next;
+    }
+
+    freeEntry(e);
+    m_size--;
+    return next;
+}
+
+Cycles
+GeneratorBuffer::getNextReleaseTime() const
+{
+    if (m_ready_head != NULL)
+        return m_cursor;
+
+    if (m_in_wheel > 0) {
+        for (int c = 0; c < m_num_slots; c++) {
+            if (m_slots[(m_cursor + c) & (m_num_slots - 1)] != NULL)
+                return m_cursor + Cycles(c);
+        }
+        assert(false);
+    }
+
+    return m_overflow_min;
+}
+
+void
+GeneratorBuffer::serialize(const std::string &base, CheckpointOut &cp) const
+{
+    std::vector<generator_buffer_type *> entries;
+    for (generator_buffer_type *e = m_ready_head; e != NULL; e = e->next)
+        entries.push_back(e);
+    for (int i = 0; i < m_num_slots; i++)
+        for (generator_buffer_type *e = m_slots[i]; e != NULL; e = e->next)
+            entries.push_back(e);
+    entries.insert(entries.end(), m_overflow.begin(), m_overflow.end());
+    assert(entries.size() == m_size);
+    std::sort(entries.begin(), entries.end(), earlier_seq);
+
+    std::vector<uint64_t> release_time, seq;
+    std::vector<flit *> flits;
+    for (int i = 0; i < entries.size(); i++) {
+        release_time.push_back(entries[i]->release_time);
+        seq.push_back(entries[i]->seq);
+        flits.push_back(entries[i]->flit_to_generate);
+    }
+
+    paramOut(cp, base + ".cursor", (uint64_t)m_cursor);
+    paramOut(cp, base + ".next_seq", m_seq);
+    paramOut(cp, base + ".peak_size", m_peak_size);
+    arrayParamOut(cp, base + ".release_time", release_time);
+    arrayParamOut(cp, base + ".seq", seq);
+    flit::serializeList(cp, base, flits);
+}
+
+void
+GeneratorBuffer::unserialize(const std::string &base, CheckpointIn &cp)
+{
+    assert(m_size == 0);
+
+    uint64_t cursor;
+    std::vector<uint64_t> release_time, seq;
+    std::vector<flit *> flits;
+    paramIn(cp, base + ".cursor", cursor);
+    paramIn(cp, base + ".next_seq", m_seq);
+    paramIn(cp, base + ".peak_size", m_peak_size);
+    arrayParamIn(cp, base + ".release_time", release_time);
+    arrayParamIn(cp, base + ".seq", seq);
+    flit::unserializeList(cp, base, flits);
+    assert(release_time.size() == flits.size() &&
+           seq.size() == flits.size());
+
+    //the entries come by insertion order, so the released ones are
+    //already in the order of the ready list
+    m_cursor = Cycles(cursor);
+    m_due.clear();
+    for (int i = 0; i < flits.size(); i++) {
+        generator_buffer_type *e = allocEntry();
+        e->flit_to_generate = flits[i];
+        e->release_time = Cycles(release_time[i]);
+        e->seq = seq[i];
+        e->next = NULL;
+        place(e, m_due);
+    }
+    generator_buffer_type **tail = &m_ready_head;
+    for (int i = 0; i < m_due.size(); i++) {
+        *tail = m_due[i];
+        tail = &m_due[i]->next;
+    }
+
+    m_size = flits.size();
+    m_peak_size = std::max(m_peak_size, m_size);
+}
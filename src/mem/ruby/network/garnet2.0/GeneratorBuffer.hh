@@ -0,0 +1,89 @@
+#ifndef __MEM_RUBY_NETWORK_GARNET2_0_GENERATOR_BUFFER_HH__
+#define __MEM_RUBY_NETWORK_GARNET2_0_GENERATOR_BUFFER_HH__
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "base/types.hh"
+#include "mem/ruby/network/garnet2.0/SlabPool.hh"
+#include "mem/ruby/network/garnet2.0/flit.hh"
+#include "sim/serialize.hh"
+
+struct generator_buffer_type
+{
+    //the cycle the pkt is released to the core/cluster buffer
+    Cycles release_time;
+    //insertion order, released pkts are served in this order
+    uint64_t seq;
+    flit *flit_to_generate;
+    generator_buffer_type *next;
+};
+
+// The pkts a core is generating while it executes a task. Every pkt waits
+// in the slot of its absolute release cycle in a timing wheel, and is moved
+// to the ready list once that cycle is reached. The ready list is kept in
+// insertion order; a pkt that cannot be released yet stays there and is
+// retried in the next cycle. Pkts beyond the wheel horizon wait in an
+// overflow list. The entries come from a slab pool shared by all cores.
+class GeneratorBuffer
+{
+  public:
+    GeneratorBuffer();
+    ~GeneratorBuffer();
+
+    void insert(flit *fl, Cycles release_time);
+    //move the pkts released up to cur_time to the ready list
+    void advance(Cycles cur_time);
+
+    //walk the ready list: e = release(prev, e) removes e and returns the
+    //next entry, prev = e; e = e->next skips it
+    generator_buffer_type *getReadyHead() { return m_ready_head; }
+    generator_buffer_type *release(generator_buffer_type *prev,
+        generator_buffer_type *e);
+
+    //the next cycle a pkt can be released: the cycle after the last
+    //advance() if some pkts are ready, Cycles(MaxTick) if it is empty
+    Cycles getNextReleaseTime() const;
+
+    bool isEmpty() const { return m_size == 0; }
+    int getSize() const { return m_size; }
+    int getPeakSize() const { return m_peak_size; }
+    static const SlabPool &getPool() { return pool(); }
+
+    //the pending pkts under base in the current checkpoint section, they
+    //are placed again by release cycle and insertion order on restore
+    void serialize(const std::string &base, CheckpointOut &cp) const;
+    void unserialize(const std::string &base, CheckpointIn &cp);
+
+  private:
+    GeneratorBuffer(const GeneratorBuffer& obj);
+    GeneratorBuffer& operator=(const GeneratorBuffer& obj);
+
+    static SlabPool &pool();
+    generator_buffer_type *allocEntry();
+    void freeEntry(generator_buffer_type *e);
+    void place(generator_buffer_type *e,
+        std::vector<generator_buffer_type *> &due);
+
+    //must be a power of 2
+    static const int m_num_slots = 256;
+
+    std::vector<generator_buffer_type *> m_slots;
+    std::vector<generator_buffer_type *> m_overflow;
+    Cycles m_overflow_min;
+    //pkts in the wheel, ready list excluded
+    int m_in_wheel;
+    //first cycle not drained from the wheel yet
+    Cycles m_cursor;
+
+    generator_buffer_type *m_ready_head;
+    uint64_t m_seq;
+
+    int m_size;
+    int m_peak_size;
+
+    std::vector<generator_buffer_type *> m_due;
+};
+
+#endif // __MEM_RUBY_NETWORK_GARNET2_0_GENERATOR_BUFFER_HH__
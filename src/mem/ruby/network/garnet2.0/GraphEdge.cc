@@ -1,30 +1,210 @@
 #include "mem/ruby/network/garnet2.0/GraphEdge.hh"
 
+#include <algorithm>
+
+void
+TokenTable::init(int max_tokens)
+{
+        assert(max_tokens > 0);
+        int num_slots = 1;
+        while (num_slots < 2 * max_tokens)
+                num_slots <<= 1;
+
+        token_info_type empty;
+        empty.id = -1;
+        empty.length_in_pkt = 0;
+        empty.received_pkt = 0;
+        slots.assign(num_slots, empty);
+        mask = num_slots - 1;
+        max_num_tokens = max_tokens;
+        num_tokens = 0;
+}
+
+token_info_type *
+TokenTable::find(int token_id)
+{
+        for (int i = token_id & mask; slots[i].id != -1; i = (i + 1) & mask)
+        {
+                if (slots[i].id == token_id)
+                        return &slots[i];
+        }
+        return NULL;
+}
+
+token_info_type *
+TokenTable::insert(int token_id, int length_in_pkt)
+{
+        if (num_tokens >= max_num_tokens)
+                fatal("Edge token table is full, more tokens in flight "
+                        "than the in memory can hold ! ");
+
+        int i = token_id & mask;
+        while (slots[i].id != -1)
+                i = (i + 1) & mask;
+        slots[i].id = token_id;
+        slots[i].length_in_pkt = length_in_pkt;
+        slots[i].received_pkt = 1;
+        num_tokens++;
+        return &slots[i];
+}
+
+void
+TokenTable::erase(token_info_type *t)
+{
+        //shift the following entries of the probe sequence back, so that
+        //no tombstone is needed
+        int hole = t - &slots[0];
+        assert(hole >= 0 && hole < slots.size() && slots[hole].id != -1);
+        for (int i = (hole + 1) & mask; slots[i].id != -1; i = (i + 1) & mask)
+        {
+                int home = slots[i].id & mask;
+                if (((i - home) & mask) >= ((i - hole) & mask)) {
+                        slots[hole] = slots[i];
+                        hole = i;
+                }
+        }
+        slots[hole].id = -1;
+        num_tokens--;
+}
+
+void
+TokenTable::serialize(const std::string &base, CheckpointOut &cp) const
+{
+        std::vector<int> ids, lengths, received;
+        for (int i = 0; i < slots.size(); i++) {
+                if (slots[i].id == -1)
+                        continue;
+                ids.push_back(slots[i].id);
+                lengths.push_back(slots[i].length_in_pkt);
+                received.push_back(slots[i].received_pkt);
+        }
+        arrayParamOut(cp, base + ".id", ids);
+        arrayParamOut(cp, base + ".length_in_pkt", lengths);
+        arrayParamOut(cp, base + ".received_pkt", received);
+}
+
+void
+TokenTable::unserialize(const std::string &base, CheckpointIn &cp)
+{
+        std::vector<int> ids, lengths, received;
+        arrayParamIn(cp, base + ".id", ids);
+        arrayParamIn(cp, base + ".length_in_pkt", lengths);
+        arrayParamIn(cp, base + ".received_pkt", received);
+        assert(ids.size() == lengths.size() && ids.size() == received.size());
+
+        init(max_num_tokens);
+        for (int i = 0; i < ids.size(); i++)
+                insert(ids[i], lengths[i])->received_pkt = received[i];
+}
+
+GraphEdge::GraphEdge(int in_mem_size)
+        : token_receive_time(in_mem_size)
+{
+        //every token, partially sent/received or waiting to be consumed,
+        //holds a slot of the in memory
+        received_token_list.init(in_mem_size);
+        sent_token_list.init(in_mem_size);
+}
+
 void
 GraphEdge::initial()
 {
         output_token_id = 0;
         num_incoming_token = 0;
         total_incoming_token = 0;
-        generate_seed();
-        gen_exp_dis_time(0.1);
         return;
 }
 
+void
+GraphEdge::serialize(CheckpointOut &cp) const
+{
+        SERIALIZE_SCALAR(id);
+        SERIALIZE_SCALAR(num_incoming_token);
+        SERIALIZE_SCALAR(total_incoming_token);
+        SERIALIZE_SCALAR(output_token_id);
+
+        std::vector<uint64_t> receive_time;
+        for (auto it = token_receive_time.begin();
+             it != token_receive_time.end(); ++it)
+                receive_time.push_back(*it);
+        arrayParamOut(cp, "token_receive_time", receive_time);
+        received_token_list.serialize("received_token", cp);
+        sent_token_list.serialize("sent_token", cp);
+
+        SERIALIZE_SCALAR(out_memory_size);
+        SERIALIZE_SCALAR(out_memory_remained);
+        SERIALIZE_SCALAR(in_memory_size);
+        SERIALIZE_SCALAR(in_memory_remained);
+        SERIALIZE_SCALAR(in_memory_credit);
+
+        rng.serialize("edge", cp);
+}
+
+void
+GraphEdge::unserialize(CheckpointIn &cp)
+{
+        int saved_id;
+        paramIn(cp, "id", saved_id);
+        if (saved_id != id)
+                fatal("Edge %d of application %d is edge %d in the "
+                        "checkpoint, the task graph changed ! ",
+                        id, app_idx, saved_id);
+
+        UNSERIALIZE_SCALAR(num_incoming_token);
+        UNSERIALIZE_SCALAR(total_incoming_token);
+        UNSERIALIZE_SCALAR(output_token_id);
+
+        //the slots taken in the in memory by the tokens received or
+        //waiting to be consumed, and the ones reserved by the sender
+        int saved_size, saved_remained, saved_credit;
+        paramIn(cp, "in_memory_size", saved_size);
+        paramIn(cp, "in_memory_remained", saved_remained);
+        paramIn(cp, "in_memory_credit", saved_credit);
+        int used = saved_size - saved_remained;
+        int reserved = saved_size - saved_credit;
+        if (std::max(used, reserved) > in_memory_size)
+                fatal("Edge %d of application %d holds %d tokens in the "
+                        "checkpoint, more than an in memory of %d ! ",
+                        id, app_idx, std::max(used, reserved),
+                        in_memory_size);
+        in_memory_remained = in_memory_size - used;
+        in_memory_credit = in_memory_size - reserved;
+        in_memory_write_pointer = used % in_memory_size;
+        in_memory_read_pointer = 0;
+
+        std::vector<uint64_t> receive_time;
+        arrayParamIn(cp, "token_receive_time", receive_time);
+        fatal_if(receive_time.size() > token_receive_time.capacity(),
+                "Edge %d of application %d has %d receive times in the "
+                "checkpoint, more than the %d it can hold ! ",
+                id, app_idx, receive_time.size(),
+                token_receive_time.capacity());
+        token_receive_time.flush();
+        for (int i = 0; i < receive_time.size(); i++)
+                token_receive_time.push_back(receive_time[i]);
+        received_token_list.unserialize("received_token", cp);
+        sent_token_list.unserialize("sent_token", cp);
+
+        //the out memory only bounds the executions of the source task,
+        //a smaller one may be over full until the tokens are sent
+        paramIn(cp, "out_memory_size", saved_size);
+        paramIn(cp, "out_memory_remained", saved_remained);
+        used = saved_size - saved_remained;
+        out_memory_remained = out_memory_size - used;
+        out_memory_write_pointer = used % out_memory_size;
+        out_memory_read_pointer = 0;
+
+        rng.unserialize("edge", cp);
+}
+
 int
-GraphEdge::record_pkt(flit* fl, int time)
+GraphEdge::record_pkt(flit* fl, uint64_t time)
 {
-        int i;
         // find token
-        for (i = 0; i < received_token_list.size(); i++)
-        {
-                if (received_token_list.at(i).id ==\
-                fl->get_tg_info().token_id){
-                        break;
-                }
-        }
+        token_info_type *t = received_token_list.find(
+                fl->get_tg_info().token_id);
         //new token
-        if (i >= received_token_list.size())
+        if (t == NULL)
         {
         //it consumes/reserves memory immediately,
         //However, it only applys when this is an inter-core pkt. Otherwise,
@@ -32,33 +212,29 @@ GraphEdge::record_pkt(flit* fl, int time)
         //same place
                 // if (src_proc_id != dst_proc_id)
                 // {
-                        assert(update_in_memory_write_pointer());
+                        bool ok = update_in_memory_write_pointer();
+                        panic_if(!ok, "Edge %d has no room left in its in "
+                                "memory !", id);
                 // }
-                token_info_type temp;
-                temp.id = fl->get_tg_info().token_id;
-                temp.length_in_pkt = fl->get_tg_info().token_length_in_pkt;
-                temp.received_pkt = 1;
-                received_token_list.push_back(temp);
+                t = received_token_list.insert(fl->get_tg_info().token_id,
+                        fl->get_tg_info().token_length_in_pkt);
         } else {
-                if (received_token_list.at(i).length_in_pkt \
-                                != fl->get_tg_info().token_length_in_pkt){
+                if (t->length_in_pkt != fl->get_tg_info().token_length_in_pkt){
                         fatal("error receiving token when record flit ! ");
                         return 0;
                 }
-                received_token_list.at(i).received_pkt++;
+                t->received_pkt++;
         }
         //check token state
-        if (received_token_list.at(i).received_pkt == \
-                received_token_list.at(i).length_in_pkt)
+        if (t->received_pkt == t->length_in_pkt)
         {
                 num_incoming_token++;
                 total_incoming_token++;
+                assert(!token_receive_time.full());
                 token_receive_time.push_back(time);
-                received_token_list.erase(received_token_list.begin() + i);
-                received_token_list.shrink_to_fit();
+                received_token_list.erase(t);
                 //if (id==0) printf("token size %d\n", num_incoming_token);
-        } else if (received_token_list.at(i).received_pkt > \
-                received_token_list.at(i).length_in_pkt) {
+        } else if (t->received_pkt > t->length_in_pkt) {
                 fatal(" error receiving token when record flit ! ");
                 return 0;
         }
@@ -69,58 +245,48 @@ GraphEdge::record_pkt(flit* fl, int time)
 bool
 GraphEdge::record_sent_pkt(flit* fl)
 { //only for inter-core pkts
-        int i;
         // find token
-        for (i = 0; i < sent_token_list.size(); i++)
-        {
-                if (sent_token_list.at(i).id == fl->get_tg_info().token_id)
-                {
-                        break;
-                }
-        }
+        token_info_type *t = sent_token_list.find(fl->get_tg_info().token_id);
         //new token
-        if (i >= sent_token_list.size())
+        if (t == NULL)
         {
         //new token would reserve new memory, therefore,
         //we should check the buffer state of dest
-                if (in_memory_remained <= 0)
+                if (in_memory_credit <= 0)
                 //if (0)
                 {       
                         // std::cout << src_task_id << "\t" << dst_task_id << "\t" << src_proc_id << "\t" << dst_proc_id << std::endl;
                         return false;
                 } else { //it consumes/resevers memory immediately, and need update when dst receive the pkt
                         // std::cout << src_task_id << "\t" << dst_task_id << "\t" << src_proc_id << "\t" << dst_proc_id << std::endl;
-                        assert(update_in_memory_write_pointer());                                           //should update when received, not now
-                        token_info_type temp;
-                        temp.id = fl->get_tg_info().token_id;
-                        temp.length_in_pkt = fl->get_tg_info().\
-                        token_length_in_pkt;
-                        temp.received_pkt = 1;
-                        sent_token_list.push_back(temp);
+                        //should update when received, not now
+                        bool ok = reserve_in_memory_credit();
+                        panic_if(!ok, "Edge %d has no in memory credit "
+                                "left !", id);
+                        t = sent_token_list.insert(fl->get_tg_info().token_id,
+                                fl->get_tg_info().token_length_in_pkt);
                 }
         } else {
-                if (sent_token_list.at(i).length_in_pkt !=\
-                                fl->get_tg_info().token_length_in_pkt){
+                if (t->length_in_pkt != fl->get_tg_info().token_length_in_pkt){
                         fatal("error receiving token");
                         return false;
                 }
-                sent_token_list.at(i).received_pkt++;
+                t->received_pkt++;
         }
         //check token state
-        if (sent_token_list.at(i).received_pkt == \
-                sent_token_list.at(i).length_in_pkt)
+        if (t->received_pkt == t->length_in_pkt)
         {
-                sent_token_list.erase(sent_token_list.begin() + i);
-                sent_token_list.shrink_to_fit();
+                sent_token_list.erase(t);
                 //at this moment, a buffer size is emptied
-                assert(update_out_memory_read_pointer());
+                bool ok = update_out_memory_read_pointer();
+                panic_if(!ok, "Edge %d has no token to free in its out "
+                        "memory !", id);
                 /*
                 if (src_task_id==0)
                         DPRINTF("task %d send pkt to task %d completely !\n", \
                         src_task_id, dst_task_id);
                 */
-        } else if (sent_token_list.at(i).received_pkt > \
-                sent_token_list.at(i).length_in_pkt) {
+        } else if (t->received_pkt > t->length_in_pkt) {
                 fatal("error receiving token");
                 return false;
         }
@@ -131,7 +297,7 @@ GraphEdge::record_sent_pkt(flit* fl)
 int
 GraphEdge::get_random_token_size()
 {
-        int a = gen_normal_dist(mu_token_size, sigma_token_size);
+        int a = rng.normal(mu_token_size, sigma_token_size);
         if (a > max_token_size)
                 a = max_token_size;
         else if (a <= 0)
@@ -154,7 +320,7 @@ int
 GraphEdge::get_random_pkt_interval()
 {
 
-        double a = gen_exp_dis_time(lambda_pkt_interval);
+        double a = rng.exponential(lambda_pkt_interval);
         return a;
 }
 
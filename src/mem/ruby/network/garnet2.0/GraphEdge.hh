@@ -5,12 +5,44 @@
 #include <iostream>
 #include <vector>
 
+#include "base/circular_queue.hh"
 #include "mem/ruby/network/garnet2.0/TaskGraphDefinition.hh"
 #include "mem/ruby/network/garnet2.0/flit.hh"
+#include "sim/serialize.hh"
+
+//the partially sent/received tokens of an edge, hashed by token id with
+//linear probing. Every token in the table holds a slot of the in memory,
+//so its size is fixed once and it never allocates afterwards.
+class TokenTable
+{
+public:
+        void init(int max_tokens);
+
+        token_info_type *find(int token_id);
+        token_info_type *insert(int token_id, int length_in_pkt);
+        void erase(token_info_type *t);
+
+        int size() const { return num_tokens; }
+
+        //the tokens in the table, restored into a table of any size that
+        //can hold them
+        void serialize(const std::string &base, CheckpointOut &cp) const;
+        void unserialize(const std::string &base, CheckpointIn &cp);
+
+private:
+        std::vector<token_info_type> slots;     //id -1 is an empty slot
+        int mask;
+        int max_num_tokens;
+        int num_tokens;
+};
 
 class GraphEdge
 {
 public:
+        //the in memory size bounds the tokens in flight on the edge, the
+        //token bookkeeping is sized from it once
+        explicit GraphEdge(int in_mem_size);
+
         // critical functions for the statistical trace
         // get a random token size using the parameters for
                 // Gaussian distribution
@@ -62,18 +94,23 @@ public:
         int set_recorded_token_size(int s);
 
         void initial();
+        //call once the id and app_idx are set
+        void
+        seed_random_stream(uint64_t seed)
+        {
+                rng.seed(seed, TG_EDGE_STREAM, app_idx, id);
+        }
 
         //record the incoming token/pkt
-        int record_pkt(flit* pkt, int time);
+        int record_pkt(flit* pkt, uint64_t time);
         //for compare all in edge's token receive time, choose the max time
         //it will compare the first token the edge have, and delete it after
         //it is used.
-        int get_token_received_time(){
+        uint64_t get_token_received_time(){
                 //now the token has been consume
                 assert(token_receive_time.size() >= num_incoming_token + 1);
-                int time = token_receive_time.front();
-                token_receive_time.erase(token_receive_time.begin());
-                token_receive_time.shrink_to_fit();
+                uint64_t time = token_receive_time.front();
+                token_receive_time.pop_front();
 
                 return time;
         }
@@ -88,8 +125,6 @@ public:
 
         int get_current_token_id() { return output_token_id; }
 
-        std::vector<int> &get_pkt_generate_time() { return pkt_generate_time; }
-
         void
         set_out_memory(int a, int b)
         {
@@ -128,11 +163,13 @@ public:
         void
         set_in_memory(int a, int b)
         {
+                assert(b == token_receive_time.capacity());
                 in_memory_start_address = a;
                 in_memory_size = b;
                 in_memory_remained = in_memory_size;
                 in_memory_write_pointer = 0;
                 in_memory_read_pointer = 0;
+                in_memory_credit = in_memory_size;
                 return;
         }
 
@@ -158,13 +195,40 @@ public:
                 return true;
         }
 
+        //the source task side view of the in memory: a slot is reserved
+        //when the first pkt of a token is sent and released when the dest
+        //task consumes the token
+        bool
+        reserve_in_memory_credit()
+        {
+                if (in_memory_credit <= 0)
+                        return false;
+                in_memory_credit--;
+                return true;
+        }
+
+        bool
+        release_in_memory_credit()
+        {
+                if (in_memory_credit >= in_memory_size)
+                        return false;
+                in_memory_credit++;
+                return true;
+        }
+
+        int get_in_memory_credit() { return in_memory_credit; }
+
         int get_in_memory_remained() { return in_memory_remained; }
         int get_in_memory_write_pointer() { return in_memory_write_pointer; }
         int get_in_memory_size() { return in_memory_size; }
 
         bool record_sent_pkt(flit* pkt);
 
-        /* Memory operation is as below:
+        /* One GraphEdge object is shared by the source and the dest task.
+        The out memory and the in memory credit are only touched by the
+        source task, the in memory and the received tokens only by the
+        dest task.
+        Memory operation is as below:
         Execute_task: task's in_edge's in_memory_read, if the src_task is
                 mapped to the same core as current task,
                                 the src_task's out_edge's
@@ -183,27 +247,18 @@ public:
         int get_app_idx() { return app_idx; }
         //decide whether the flit in this edge token list
         bool find_in_token_list(flit* fl) {
-                        int i;
-                        // find token
-                        for (i = 0; i < received_token_list.size(); i++)
-                        {
-                                if (received_token_list.at(i).id ==
-                                        fl->get_tg_info().token_id)
-                                {
-                                        break;
-                                }
-                        }
-                        //new token
-                        if (i >= received_token_list.size())
-                        {
-                                return false;
-                        } else {
-                                return true;
-                        }
+                        return received_token_list.find(
+                                fl->get_tg_info().token_id) != NULL;
                 }
 
         int get_total_incoming_token(){ return total_incoming_token; }
 
+        //the dynamic state of the edge in the current checkpoint section,
+        //the rest is loaded from the task graph again. The memories are
+        //restored into the sizes of this run.
+        void serialize(CheckpointOut &cp) const;
+        void unserialize(CheckpointIn &cp);
+
 private:
         // the statistical token sizes follow Gaussian distribution
         double mu_token_size;	 // the mean of the token size
@@ -232,19 +287,18 @@ private:
         int num_incoming_token;
         // current total num of token which for compute task waiting time
         int total_incoming_token;
-        std::vector<int> token_receive_time;
+        //receive time of the complete tokens not consumed yet
+        CircularQueue<uint64_t> token_receive_time;
 
-        //the number of partially received tokens
-        std::vector<token_info_type> received_token_list;
+        //the partially received tokens
+        TokenTable received_token_list;
 
-        //the number of partially sent tokens
-        std::vector<token_info_type> sent_token_list;
+        //the partially sent tokens, each one holds an in memory credit
+        TokenTable sent_token_list;
 
         //the output token ID
         int output_token_id;
 
-        std::vector<int> pkt_generate_time;
-
         // the start address to write data for outgoing edge
         int out_memory_start_address;
         int out_memory_size;
@@ -258,9 +312,13 @@ private:
         int in_memory_write_pointer;
         int in_memory_read_pointer;
         int in_memory_remained;
+        //in memory slots the source task can still reserve
+        int in_memory_credit;
 
         //for multi-app
         int app_idx;
+
+        TaskGraphRNG rng;
 };
 
 
@@ -1,11 +1,13 @@
 #include "mem/ruby/network/garnet2.0/GraphTask.hh"
 
+#include <algorithm>
+
 GraphEdge&
 GraphTask::get_incoming_edge_by_eid(int eid)
 {
         for (unsigned int i = 0; i < incoming_edge_list.size(); i++)
         {
-                GraphEdge &e = incoming_edge_list.at(i);
+                GraphEdge &e = get_incoming_edge_by_offset(i);
                 if (e.get_id() == eid)
                         return e;
         }
@@ -15,7 +17,8 @@ GraphTask::get_incoming_edge_by_eid(int eid)
 GraphEdge&
 GraphTask::get_incoming_edge_by_offset(int i)
 {
-        GraphEdge &e = incoming_edge_list.at(i);
+        assert(edge_store != NULL);
+        GraphEdge &e = edge_store->at(incoming_edge_list.at(i));
         return e;
 }
 
@@ -24,7 +27,7 @@ GraphTask::get_outgoing_edge_by_eid(int eid)
 {
         for (unsigned int i = 0; i < outgoing_edge_list.size(); i++)
         {
-                GraphEdge &e = outgoing_edge_list.at(i);
+                GraphEdge &e = get_outgoing_edge_by_offset(i);
                 if (e.get_id() == eid)
                         return e;
         }
@@ -34,28 +37,29 @@ GraphTask::get_outgoing_edge_by_eid(int eid)
 GraphEdge&
 GraphTask::get_outgoing_edge_by_offset(int i)
 {
-        GraphEdge &e = outgoing_edge_list.at(i);
+        assert(edge_store != NULL);
+        GraphEdge &e = edge_store->at(outgoing_edge_list.at(i));
         return e;
 }
 
 int
-GraphTask::add_incoming_edge(GraphEdge &e)
+GraphTask::add_incoming_edge(int edge_idx)
 {
-        incoming_edge_list.push_back(e);
+        incoming_edge_list.push_back(edge_idx);
         return 0;
 }
 
 int
-GraphTask::add_outgoing_edge(GraphEdge &e)
+GraphTask::add_outgoing_edge(int edge_idx)
 {
-        outgoing_edge_list.push_back(e);
+        outgoing_edge_list.push_back(edge_idx);
         return 0;
 }
 
 int
 GraphTask::get_random_execution_time()
 {
-        int a = gen_normal_dist(mu_time, sigma_time);
+        int a = rng.normal(mu_time, sigma_time);
         if (a > max_time)
                 a = max_time;
         else if (a <= 0)
@@ -108,3 +112,80 @@ GraphTask::set_max_time(int t)
 
         return 0;
 }
+
+void
+GraphTask::serialize(CheckpointOut &cp) const
+{
+        SERIALIZE_SCALAR(id);
+        SERIALIZE_SCALAR(completed_times);
+        SERIALIZE_SCALAR(task_state);
+        SERIALIZE_SCALAR(c_e_times);
+        SERIALIZE_SCALAR(total_waiting_time);
+        SERIALIZE_SCALAR(num_start_recorded);
+        SERIALIZE_SCALAR(num_tokens_recorded);
+
+        //the executions still in the window, oldest first
+        std::vector<uint64_t> start, end, tokens;
+        for (int i = std::max(num_start_recorded - history_size, 0);
+             i < num_start_recorded; i++) {
+                start.push_back(start_time[i % history_size]);
+                end.push_back(end_time[i % history_size]);
+        }
+        for (int i = std::max(num_tokens_recorded - history_size, 0);
+             i < num_tokens_recorded; i++)
+                tokens.push_back(get_all_tokens_time[i % history_size]);
+        arrayParamOut(cp, "start_time", start);
+        arrayParamOut(cp, "end_time", end);
+        arrayParamOut(cp, "get_all_tokens_time", tokens);
+
+        rng.serialize("task", cp);
+}
+
+void
+GraphTask::unserialize(CheckpointIn &cp)
+{
+        int saved_id;
+        paramIn(cp, "id", saved_id);
+        if (saved_id != id)
+                fatal("Task %d of application %d is task %d in the "
+                        "checkpoint, the task graph changed ! ",
+                        id, app_idx, saved_id);
+
+        UNSERIALIZE_SCALAR(completed_times);
+        UNSERIALIZE_SCALAR(task_state);
+        UNSERIALIZE_SCALAR(c_e_times);
+        UNSERIALIZE_SCALAR(total_waiting_time);
+
+        int saved_start, saved_tokens;
+        paramIn(cp, "num_start_recorded", saved_start);
+        paramIn(cp, "num_tokens_recorded", saved_tokens);
+        std::vector<uint64_t> start, end, tokens;
+        arrayParamIn(cp, "start_time", start);
+        arrayParamIn(cp, "end_time", end);
+        arrayParamIn(cp, "get_all_tokens_time", tokens);
+        assert(start.size() == end.size());
+
+        //executions beyond the iterations of this run are not recorded
+        num_start_recorded = std::min(saved_start, required_times);
+        num_tokens_recorded = std::min(saved_tokens, required_times);
+
+        int first = saved_start - start.size();
+        for (int k = 0; k < start.size(); k++) {
+                int i = first + k;
+                if (i < num_start_recorded - history_size ||
+                    i >= num_start_recorded)
+                        continue;
+                start_time[i % history_size] = start[k];
+                end_time[i % history_size] = end[k];
+        }
+        first = saved_tokens - tokens.size();
+        for (int k = 0; k < tokens.size(); k++) {
+                int i = first + k;
+                if (i < num_tokens_recorded - history_size ||
+                    i >= num_tokens_recorded)
+                        continue;
+                get_all_tokens_time[i % history_size] = tokens[k];
+        }
+
+        rng.unserialize("task", cp);
+}
@@ -13,8 +13,11 @@ public:
         int set_statistical_execution_time(double mu, double sigma);
 
         // assistant functions
-        int add_incoming_edge(GraphEdge &e);
-        int add_outgoing_edge(GraphEdge &e);
+        // the edges live in the edge store owned by GarnetNetwork, the task
+        // only keeps their indices
+        void set_edge_store(std::vector<GraphEdge> *store) { edge_store = store; }
+        int add_incoming_edge(int edge_idx);
+        int add_outgoing_edge(int edge_idx);
 
         // basic functions
         int get_id() { return id; }
@@ -42,14 +45,15 @@ public:
         get_size_of_outgoing_edge_list() { return outgoing_edge_list.size(); }
 
         int
-        set_required_times(int k)
+        set_required_times(int k, int window = 0)
         {
                 required_times = k;
-                //because we use continuous stimulus, the vector would be long
-                //we limit it before simulation.
-                start_time.reserve(required_times);
-                end_time.reserve(required_times);
-                get_all_tokens_time.reserve(required_times);
+                //the times of every execution are kept, or only those of
+                //the last window executions in streaming mode
+                history_size = (window > 0 && window < k) ? window : k;
+                start_time.resize(history_size);
+                end_time.resize(history_size);
+                get_all_tokens_time.resize(history_size);
                 return 0;
         }
 
@@ -64,6 +68,9 @@ public:
                 completed_times = 0;
                 task_state = 0;
                 c_e_times = 0;
+                num_start_recorded = 0;
+                num_tokens_recorded = 0;
+                total_waiting_time = 0;
                 return;
         }
 
@@ -79,46 +86,80 @@ public:
         
         int get_task_state() { return task_state; }
         
-        void record_execution_time(int start, int end){
-                if(start_time.size()<required_times){
-                        start_time.push_back(start);
-                        end_time.push_back(end);
+        void
+        record_execution_time(uint64_t start, uint64_t end)
+        {
+                if (num_start_recorded < required_times) {
+                        int slot = num_start_recorded % history_size;
+                        start_time[slot] = start;
+                        end_time[slot] = end;
+                        num_start_recorded++;
                 }
         }
 
-        int get_start_time(int i)
+        //the end of the execution exec (from 0), for the tasks whose time
+        //is only known once they are done
+        void
+        record_execution_end(int exec, uint64_t end)
         {
-                if(i>required_times)
-                        fatal("Get task start time over the required times ! ");
-                else
-                        return start_time.at(i);
+                if (exec < num_start_recorded &&
+                    exec + history_size >= num_start_recorded)
+                        end_time[exec % history_size] = end;
         }
-        
-        int get_end_time(int i)
+
+        uint64_t
+        get_start_time(int i)
         {
-                if(i>required_times)
-                        fatal("Get task end time over the required times ! ");
-                else                
-                        return end_time.at(i);
+                return start_time[history_slot(i, num_start_recorded)];
         }
-        
-        void set_all_tokens_received_time(int time){
-                if(get_all_tokens_time.size()<required_times){
-                        get_all_tokens_time.push_back(time);
+
+        uint64_t
+        get_end_time(int i)
+        {
+                return end_time[history_slot(i, num_start_recorded)];
+        }
+
+        //call after record_execution_time of the same execution
+        void
+        set_all_tokens_received_time(uint64_t time)
+        {
+                if (num_tokens_recorded < required_times) {
+                        assert(num_tokens_recorded < num_start_recorded);
+                        int slot = num_tokens_recorded % history_size;
+                        get_all_tokens_time[slot] = time;
+                        total_waiting_time += start_time[slot] - time;
+                        num_tokens_recorded++;
                 }
         }
-        
-        int get_task_waiting_time(int i){
-                if(i>required_times)
-                        fatal("Get task waiting time over the required times ! ");
-                else
-                        return start_time[i]-get_all_tokens_time[i];}
+
+        uint64_t
+        get_task_waiting_time(int i)
+        {
+                int slot = history_slot(i, num_tokens_recorded);
+                return start_time[slot] - get_all_tokens_time[slot];
+        }
+
+        //summed over all the recorded executions, also the ones that
+        //left the window
+        uint64_t get_total_waiting_time() { return total_waiting_time; }
 
         int get_token_received_size(){ 
-                return get_all_tokens_time.size(); }
+                return num_tokens_recorded; }
         
         void set_app_idx(int i){ app_idx=i; return; }
         int get_app_idx() { return app_idx; }
+        //call once the id and app_idx are set
+        void
+        seed_random_stream(uint64_t seed)
+        {
+                rng.seed(seed, TG_TASK_STREAM, app_idx, id);
+        }
+
+        //the dynamic state of the task in the current checkpoint section.
+        //The recorded executions are restored into the window and the
+        //required times of this run.
+        void serialize(CheckpointOut &cp) const;
+        void unserialize(CheckpointIn &cp);
 
 private:
         // the statistical task executions follow Gaussian distribution
@@ -135,10 +176,14 @@ private:
         // for multi-application
         int app_idx;
 
-        // each entry is an incoming edge
-        std::vector<GraphEdge> incoming_edge_list;
-        // each entry is an outgoing edge
-        std::vector<GraphEdge> outgoing_edge_list;
+        TaskGraphRNG rng;
+
+        // shared by all tasks of the network
+        std::vector<GraphEdge> *edge_store;
+        // each entry is the index of an incoming edge in the edge store
+        std::vector<int> incoming_edge_list;
+        // each entry is the index of an outgoing edge in the edge store
+        std::vector<int> outgoing_edge_list;
         int completed_times; //the times that this task has been finished
         //the times required for this this task.
         //In this application, it is always 1.
@@ -147,10 +192,26 @@ private:
         int task_state;
         //For a task, first get all tokens, then if core idle, the task begin
         //execute, so between them could be the task waiting time.
-        //the length of these vector would be limited in the task required times when push back
-        std::vector<int> get_all_tokens_time;
-        std::vector<int> start_time;
-        std::vector<int> end_time;
+        //execution i is in slot i % history_size
+        std::vector<uint64_t> get_all_tokens_time;
+        std::vector<uint64_t> start_time;
+        std::vector<uint64_t> end_time;
+        int history_size;
+        int num_start_recorded;
+        int num_tokens_recorded;
+        uint64_t total_waiting_time;
+
+        int
+        history_slot(int i, int num_recorded)
+        {
+                if (i < 0 || i >= num_recorded)
+                        fatal("Task %d has not executed %d times yet ! ",
+                            id, i + 1);
+                if (i < num_recorded - history_size)
+                        fatal("Execution %d of task %d left the stats "
+                            "window ! ", i, id);
+                return i % history_size;
+        }
 
         //the times completed or executing
         int c_e_times;
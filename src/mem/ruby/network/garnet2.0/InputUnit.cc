@@ -60,9 +60,14 @@ InputUnit::InputUnit(int id, PortDirection direction, Router *router)
     creditQueue = new flitBuffer();
     // Instantiating the virtual channels
     m_vcs.resize(m_num_vcs);
+    GarnetNetwork *net_ptr = m_router->get_net_ptr();
     for (int i=0; i < m_num_vcs; i++) {
-        m_vcs[i] = new VirtualChannel(i);
+        int depth = (net_ptr->get_vnet_type(i) == DATA_VNET_) ?
+            net_ptr->getBuffersPerDataVC() : net_ptr->getBuffersPerCtrlVC();
+        m_vcs[i] = new VirtualChannel(i, depth);
     }
+    m_occupied_vcs.resize(m_num_vcs);
+    m_num_bypasses = 0;
 }
 
 InputUnit::~InputUnit()
@@ -97,9 +102,13 @@ InputUnit::wakeup()
             assert(m_vcs[vc]->get_state() == IDLE_);
             set_vc_active(vc, m_router->curCycle());
 
-            // Route computation for this vc
-            int outport = m_router->route_compute(t_flit->get_route(),
-                m_id, m_direction);
+            // Route computation for this vc, already done on the link
+            // with lookahead routing
+            int outport = t_flit->get_lookahead_outport();
+            if (outport == -1)
+                outport = m_router->route_compute(t_flit->get_route(),
+                    m_id, m_direction);
+            t_flit->set_lookahead_outport(-1);
 
             // Update output port in VC
             // All flits in this packet will use this output port
@@ -113,6 +122,7 @@ InputUnit::wakeup()
 
         // Buffer the flit
         m_vcs[vc]->insertFlit(t_flit);
+        m_occupied_vcs.set(vc);
 
         int vnet = vc/m_vc_per_vnet;
         // number of writes same as reads
@@ -121,6 +131,17 @@ InputUnit::wakeup()
         m_num_buffer_reads[vnet]++;
 
         Cycles pipe_stages = m_router->get_pipe_stages();
+        GarnetNetwork *net_ptr = m_router->get_net_ptr();
+        if (net_ptr->isLookaheadRouting() && pipe_stages > 1) {
+            // the route computation stage moved to the upstream link
+            pipe_stages = pipe_stages - Cycles(1);
+        }
+        if (net_ptr->isRouterBypass() && pipe_stages > 1 &&
+            m_router->can_bypass(m_id, vc)) {
+            pipe_stages = Cycles(1);
+            m_num_bypasses++;
+        }
+
         if (pipe_stages == 1) {
             // 1-cycle router
             // Flit goes for SA directly
@@ -146,7 +167,8 @@ InputUnit::increment_credit(int in_vc, bool free_signal, Cycles curTime)
 {
     Credit *t_credit = new Credit(in_vc, free_signal, curTime);
     creditQueue->insert(t_credit);
-    m_credit_link->scheduleEventAbsolute(m_router->clockEdge(Cycles(1)));
+    m_router->schedule_consumer(m_credit_link,
+                                m_router->clockEdge(Cycles(1)));
 }
 
 
@@ -164,6 +186,7 @@ InputUnit::functionalWrite(Packet *pkt)
 void
 InputUnit::resetStats()
 {
+    m_num_bypasses = 0;
     for (int j = 0; j < m_num_buffer_reads.size(); j++) {
         m_num_buffer_reads[j] = 0;
         m_num_buffer_writes[j] = 0;
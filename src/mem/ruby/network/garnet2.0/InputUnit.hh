@@ -38,6 +38,7 @@
 #include <vector>
 
 #include "mem/ruby/common/Consumer.hh"
+#include "mem/ruby/network/garnet2.0/BitMask.hh"
 #include "mem/ruby/network/garnet2.0/CommonTypes.hh"
 #include "mem/ruby/network/garnet2.0/CreditLink.hh"
 #include "mem/ruby/network/garnet2.0/NetworkLink.hh"
@@ -109,7 +110,17 @@ class InputUnit : public Consumer
     inline flit*
     getTopFlit(int vc)
     {
-        return m_vcs[vc]->getTopFlit();
+        flit *t_flit = m_vcs[vc]->getTopFlit();
+        if (m_vcs[vc]->isEmpty())
+            m_occupied_vcs.clear(vc);
+        return t_flit;
+    }
+
+    // VCs holding at least one flit
+    inline const BitMask &
+    get_occupied_vcs() const
+    {
+        return m_occupied_vcs;
     }
 
     inline bool
@@ -133,6 +144,19 @@ class InputUnit : public Consumer
     }
 
     inline int get_inlink_id() { return m_in_link->get_id(); }
+    // a flit reaches the input buffer on this cycle
+    inline bool
+    has_incoming_flit(Cycles curTime)
+    {
+        return m_in_link->isReady(curTime);
+    }
+
+    // nothing buffered and no credit left to send upstream
+    inline bool
+    isDrained()
+    {
+        return m_occupied_vcs.none() && creditQueue->isEmpty();
+    }
 
     inline void
     set_credit_link(CreditLink *credit_link)
@@ -144,6 +168,13 @@ class InputUnit : public Consumer
     { return m_num_buffer_reads[vnet]; }
     double get_buf_write_activity(unsigned int vnet) const
     { return m_num_buffer_writes[vnet]; }
+    double get_bypass_count() const { return m_num_bypasses; }
+
+    inline int
+    get_num_flits(int vc)
+    {
+        return m_vcs[vc]->getSize();
+    }
 
     uint32_t functionalWrite(Packet *pkt);
     void resetStats();
@@ -161,10 +192,12 @@ class InputUnit : public Consumer
 
     // Input Virtual channels
     std::vector<VirtualChannel *> m_vcs;
+    BitMask m_occupied_vcs;
 
     // Statistical variables
     std::vector<double> m_num_buffer_writes;
     std::vector<double> m_num_buffer_reads;
+    double m_num_bypasses;
 };
 
 #endif // __MEM_RUBY_NETWORK_GARNET2_0_INPUTUNIT_HH__
@@ -33,15 +33,20 @@
 
 #include "mem/ruby/network/garnet2.0/NetworkInterface.hh"
 
+#include <algorithm>
 #include <cassert>
+#include <climits>
 #include <cmath>
 #include <ctime>
 
 #include "base/cast.hh"
+#include "base/cprintf.hh"
 #include "base/stl_helpers.hh"
 #include "debug/RubyNetwork.hh"
 #include "mem/ruby/network/MessageBuffer.hh"
+#include "mem/ruby/network/garnet2.0/AnalyticalNetworkModel.hh"
 #include "mem/ruby/network/garnet2.0/Credit.hh"
+#include "mem/ruby/network/garnet2.0/TaskGraphMemory.hh"
 #include "mem/ruby/network/garnet2.0/flitBuffer.hh"
 #include "mem/ruby/slicc_interface/Message.hh"
 
@@ -77,7 +82,10 @@ NetworkInterface::NetworkInterface(const Params *p)
     m_stall_count.resize(m_virtual_networks);
 
     //task graph
+    m_num_cores = 0;
     core_buffer_round_robin = 0;
+    m_tg_activity = false;
+    m_tg_last_cycle = Cycles(0);
 }
 
 void
@@ -116,6 +124,10 @@ NetworkInterface::~NetworkInterface()
     deletePointers(m_ni_out_vcs);
     delete outCreditQueue;
     delete outFlitQueue;
+    deletePointers(generator_buffer);
+    for (auto it = m_analytical_arrivals.begin();
+         it != m_analytical_arrivals.end(); ++it)
+        delete it->second;
 
     //for the task parallelism release memory
     for (int i=0;i<m_num_cores;i++){
@@ -215,6 +227,7 @@ NetworkInterface::incrementStats(flit *t_flit)
 
     // Hops
     m_net_ptr->increment_total_hops(t_flit->get_route().hops_traversed);
+    m_net_ptr->increment_total_smart_hops(t_flit->get_smart_hops());
 }
 void
 NetworkInterface::incrementStats(flit *t_flit, bool in_core)
@@ -246,6 +259,7 @@ NetworkInterface::incrementStats(flit *t_flit, bool in_core)
 
     // Hops
     m_net_ptr->increment_total_hops(t_flit->get_route().hops_traversed);
+    m_net_ptr->increment_total_smart_hops(t_flit->get_smart_hops());
 }
 
 /*
@@ -284,6 +298,10 @@ NetworkInterface::wakeup()
             }
         }
     } else {
+        if (m_net_ptr->isTaskGraphEventDriven())
+            catchUpIdleCycles();
+        m_tg_activity = false;
+
         enqueueTaskInThreadQueue();
         task_execution();
         updateGeneratorBuffer();
@@ -342,37 +360,7 @@ NetworkInterface::wakeup()
             }
         }
         else {
-            flit *t_flit = inNetLink->consumeLink();
-            int temp_task = t_flit->get_tg_info().dest_task;
-            int temp_edge_id = t_flit->get_tg_info().edge_id;
-            int app_idx = t_flit->get_tg_info().app_idx;
-            int core_id = get_core_id_by_task_id(app_idx, temp_task);
-
-            GraphTask &dest_task = get_task_by_task_id(core_id, app_idx, temp_task);
-            GraphEdge &dest_edge = dest_task.get_incoming_edge_by_eid(temp_edge_id);
-
-            t_flit->set_dequeue_time(curCycle());
-
-            if (t_flit->get_type() == TAIL_ || t_flit->get_type() == HEAD_TAIL_)
-            {
-                //received a pkt
-                dest_edge.record_pkt(t_flit, curCycle());   //operate in this task's in edge(in mem write)
-                /*
-                DPRINTF(TaskGraph, " NI %d received the tail flit \
-                from the NI %d \n", m_id, t_flit->get_route().src_ni);
-                */
-                sendCredit(t_flit, true);
-                // Update stats and delete flit pointer
-                incrementStats(t_flit);
-                delete t_flit;
-            }
-            else
-            {
-                sendCredit(t_flit, false);
-                // Update stats and delete flit pointer.
-                incrementStats(t_flit);
-                delete t_flit;
-            }
+            consumeTaskGraphFlit(inNetLink->consumeLink(), true);
 
             /*
             if (input_buffer[core_idx].size() == input_buffer_size[core_idx] ){
@@ -386,6 +374,14 @@ NetworkInterface::wakeup()
         }
     }
 
+    /*********** Flits of the analytical network due now **********/
+    while (!m_analytical_arrivals.empty() &&
+           m_analytical_arrivals.begin()->first <= curCycle()) {
+        flit *t_flit = m_analytical_arrivals.begin()->second;
+        m_analytical_arrivals.erase(m_analytical_arrivals.begin());
+        consumeTaskGraphFlit(t_flit, false);
+    }
+
     /****************** Check the incoming credit link *******/
 
     if (inCreditLink->isReady(curCycle())) {
@@ -395,6 +391,7 @@ NetworkInterface::wakeup()
             m_out_vc_state[t_credit->get_vc()]->setState(IDLE_, curCycle());
         }
         delete t_credit;
+        m_tg_activity = true;
     }
 
 
@@ -406,6 +403,11 @@ NetworkInterface::wakeup()
         outCreditLink->scheduleEventAbsolute(clockEdge(Cycles(1)));
     }
 
+    if (m_net_ptr->isTaskGraphEnabled() &&
+        m_net_ptr->isTaskGraphEventDriven()) {
+        scheduleTaskGraphWakeup();
+    }
+
     /****************** Core get the flit from input buffer *******/
     /*
     for (int i=0; i<m_num_cores; i++) {
@@ -452,6 +454,42 @@ NetworkInterface::wakeup()
     }*/
 }
 
+void
+NetworkInterface::consumeTaskGraphFlit(flit *t_flit, bool send_credit)
+{
+    m_tg_activity = true;
+    int temp_edge_id = t_flit->get_tg_info().edge_id;
+    int app_idx = t_flit->get_tg_info().app_idx;
+
+    GraphEdge &dest_edge = m_net_ptr->get_edge(app_idx, temp_edge_id);
+    assert(dest_edge.get_dst_task_id() == t_flit->get_tg_info().dest_task);
+
+    t_flit->set_dequeue_time(curCycle());
+
+    bool is_tail =
+        t_flit->get_type() == TAIL_ || t_flit->get_type() == HEAD_TAIL_;
+    if (is_tail) {
+        //received a pkt
+        dest_edge.record_pkt(t_flit, curCycle());   //operate in this task's in edge(in mem write)
+        /*
+        DPRINTF(TaskGraph, " NI %d received the tail flit \
+        from the NI %d \n", m_id, t_flit->get_route().src_ni);
+        */
+    }
+    if (send_credit)
+        sendCredit(t_flit, is_tail);
+    // Update stats and delete flit pointer
+    incrementStats(t_flit);
+    delete t_flit;
+}
+
+void
+NetworkInterface::receiveAnalyticalFlit(flit *t_flit, Cycles arrival)
+{
+    m_analytical_arrivals.insert(std::make_pair(arrival, t_flit));
+    scheduleEventAbsolute(clockEdge(Cycles(arrival - curCycle())));
+}
+
 void
 NetworkInterface::sendCredit(flit *t_flit, bool is_free)
 {
@@ -554,11 +592,10 @@ NetworkInterface::flitisizeMessage(MsgPtr msg_ptr, int vnet)
         }
 
         // Embed Route into the flits
-        // NetDest format is used by the routing table
+        // the routing table looks the NetDest of destID up in the network
         // Custom routing algorithms just need destID
         RouteInfo route;
         route.vnet = vnet;
-        route.net_dest = new_net_msg_ptr->getDestination();
         route.src_ni = m_id;
         route.src_router = m_router_id;
         route.dest_ni = destID;
@@ -721,8 +758,10 @@ NetworkInterface::checkReschedule()
         }
     }
 
-    //for task graph, every cycle wake up the NI
-    scheduleEvent(Cycles(1));
+    //for task graph, every cycle wake up the NI, unless the NI is
+    //event-driven (see scheduleTaskGraphWakeup)
+    if (!m_net_ptr->isTaskGraphEventDriven())
+        scheduleEvent(Cycles(1));
 }
 
 void
@@ -743,6 +782,155 @@ NetworkInterface::functionalWrite(Packet *pkt)
     return num_functional_writes;
 }
 
+bool
+NetworkInterface::isDrained()
+{
+    if (!outFlitQueue->isEmpty() || !outCreditQueue->isEmpty() ||
+        !m_stall_queue.empty() || !m_analytical_arrivals.empty())
+        return false;
+    for (int vc = 0; vc < m_num_vcs; vc++) {
+        if (!m_ni_out_vcs[vc]->isEmpty() ||
+            !m_out_vc_state[vc]->isInState(IDLE_, curCycle()))
+            return false;
+    }
+    return true;
+}
+
+void
+NetworkInterface::serialize(CheckpointOut &cp) const
+{
+    ClockedObject::serialize(cp);
+    SERIALIZE_SCALAR(m_num_cores);
+    if (m_num_cores == 0)
+        return;
+
+    SERIALIZE_SCALAR(core_buffer_round_robin);
+    paramOut(cp, "tg_last_cycle", (uint64_t)m_tg_last_cycle);
+
+    for (int i = 0; i < m_num_cores; i++) {
+        string base = csprintf("core%d", i);
+        int num_threads = m_core_id_thread.at(m_index_core_id.at(i));
+        arrayParamOut(cp, base + ".task_in_thread_queue",
+            task_in_thread_queue[i], num_threads);
+        arrayParamOut(cp, base + ".remained_execution_time_in_thread",
+            remained_execution_time_in_thread[i], num_threads);
+        arrayParamOut(cp, base + ".thread_busy_flag",
+            thread_busy_flag[i], num_threads);
+        arrayParamOut(cp, base + ".app_idx_in_thread_queue",
+            app_idx_in_thread_queue[i], num_threads);
+        arrayParamOut(cp, base + ".task_to_exec_round_robin",
+            task_to_exec_round_robin[i], m_num_apps);
+        paramOut(cp, base + ".app_exec_rr", app_exec_rr[i]);
+        paramOut(cp, base + ".total_data_bits",
+            doubleToBits(m_total_data_bits[i]));
+        paramOut(cp, base + ".core_buffer_sent", core_buffer_sent[i]);
+        paramOut(cp, base + ".crossbar_busy_out",
+            (bool)crossbar_busy_out[i]);
+        paramOut(cp, base + ".crossbar_delay_timer",
+            crossbar_delay_timer[i]);
+
+        flit::serializeList(cp, base + ".core_buffer", core_buffer[i]);
+        flit::serializeList(cp, base + ".cluster_buffer", cluster_buffer[i]);
+        flit::serializeList(cp, base + ".crossbar_data", crossbar_data[i]);
+        generator_buffer[i]->serialize(base + ".generator_buffer", cp);
+    }
+
+    if (m_id == entrance_NI) {
+        arrayParamOut(cp, "initial_task_thread_queue",
+            initial_task_thread_queue, num_initial_thread);
+        arrayParamOut(cp, "remainad_initial_task_exec_time",
+            remainad_initial_task_exec_time, num_initial_thread);
+        arrayParamOut(cp, "initial_task_busy_flag",
+            initial_task_busy_flag, num_initial_thread);
+        arrayParamOut(cp, "app_idx_in_initial_thread_queue",
+            app_idx_in_initial_thread_queue, num_initial_thread);
+        SERIALIZE_CONTAINER(initial_app_ratio_token);
+    }
+
+    //the tasks go last, each in its own section
+    for (int i = 0; i < m_num_cores; i++) {
+        for (int j = 0; j < m_num_apps; j++) {
+            for (int k = 0; k < task_list[i][j].size(); k++) {
+                ScopedCheckpointSection sec(cp,
+                    csprintf("core%d.app%d.task%d", i, j, k));
+                task_list[i][j][k].serialize(cp);
+            }
+        }
+    }
+}
+
+void
+NetworkInterface::unserialize(CheckpointIn &cp)
+{
+    ClockedObject::unserialize(cp);
+    int num_cores;
+    paramIn(cp, "m_num_cores", num_cores);
+    if (num_cores != m_num_cores)
+        fatal("NI %d has %d cores in the checkpoint and %d in the "
+            "architecture file !", m_id, num_cores, m_num_cores);
+    if (m_num_cores == 0)
+        return;
+
+    UNSERIALIZE_SCALAR(core_buffer_round_robin);
+    uint64_t last_cycle;
+    paramIn(cp, "tg_last_cycle", last_cycle);
+    m_tg_last_cycle = Cycles(last_cycle);
+
+    for (int i = 0; i < m_num_cores; i++) {
+        string base = csprintf("core%d", i);
+        int num_threads = lookUpMap(m_core_id_thread,
+            lookUpMap(m_index_core_id, i));
+        arrayParamIn(cp, base + ".task_in_thread_queue",
+            task_in_thread_queue[i], num_threads);
+        arrayParamIn(cp, base + ".remained_execution_time_in_thread",
+            remained_execution_time_in_thread[i], num_threads);
+        arrayParamIn(cp, base + ".thread_busy_flag",
+            thread_busy_flag[i], num_threads);
+        arrayParamIn(cp, base + ".app_idx_in_thread_queue",
+            app_idx_in_thread_queue[i], num_threads);
+        arrayParamIn(cp, base + ".task_to_exec_round_robin",
+            task_to_exec_round_robin[i], m_num_apps);
+        paramIn(cp, base + ".app_exec_rr", app_exec_rr[i]);
+        uint64_t data_bits;
+        paramIn(cp, base + ".total_data_bits", data_bits);
+        m_total_data_bits[i] = bitsToDouble(data_bits);
+        paramIn(cp, base + ".core_buffer_sent", core_buffer_sent[i]);
+        bool busy_out;
+        paramIn(cp, base + ".crossbar_busy_out", busy_out);
+        crossbar_busy_out[i] = busy_out;
+        paramIn(cp, base + ".crossbar_delay_timer",
+            crossbar_delay_timer[i]);
+
+        flit::unserializeList(cp, base + ".core_buffer", core_buffer[i]);
+        flit::unserializeList(cp, base + ".cluster_buffer",
+            cluster_buffer[i]);
+        flit::unserializeList(cp, base + ".crossbar_data", crossbar_data[i]);
+        generator_buffer[i]->unserialize(base + ".generator_buffer", cp);
+    }
+
+    if (m_id == entrance_NI) {
+        arrayParamIn(cp, "initial_task_thread_queue",
+            initial_task_thread_queue, num_initial_thread);
+        arrayParamIn(cp, "remainad_initial_task_exec_time",
+            remainad_initial_task_exec_time, num_initial_thread);
+        arrayParamIn(cp, "initial_task_busy_flag",
+            initial_task_busy_flag, num_initial_thread);
+        arrayParamIn(cp, "app_idx_in_initial_thread_queue",
+            app_idx_in_initial_thread_queue, num_initial_thread);
+        UNSERIALIZE_CONTAINER(initial_app_ratio_token);
+    }
+
+    for (int i = 0; i < m_num_cores; i++) {
+        for (int j = 0; j < m_num_apps; j++) {
+            for (int k = 0; k < task_list[i][j].size(); k++) {
+                ScopedCheckpointSection sec(cp,
+                    csprintf("core%d.app%d.task%d", i, j, k));
+                task_list[i][j][k].unserialize(cp);
+            }
+        }
+    }
+}
+
 NetworkInterface *
 GarnetNetworkInterfaceParams::create()
 {
@@ -786,6 +974,12 @@ NetworkInterface::initializeTaskIdList(){
 int
 NetworkInterface::get_task_offset_by_task_id(int core_id, int app_idx, int tid)
 {
+    if (m_net_ptr->isTaskGraphIndexed()){
+        const task_index_type &t = m_net_ptr->get_task_index(app_idx, tid);
+        assert(t.node_id == m_id && t.task->get_proc_id() == core_id);
+        return t.offset;
+    }
+
     int task_list_idx = lookUpMap(m_core_id_index, core_id);
     for (unsigned int i=0; i<task_list[task_list_idx][app_idx].size(); i++)
         {
@@ -799,6 +993,12 @@ NetworkInterface::get_task_offset_by_task_id(int core_id, int app_idx, int tid)
 GraphTask&
 NetworkInterface::get_task_by_task_id(int core_id, int app_idx, int tid)
 {
+    if (m_net_ptr->isTaskGraphIndexed()){
+        const task_index_type &t = m_net_ptr->get_task_index(app_idx, tid);
+        assert(t.node_id == m_id && t.task->get_proc_id() == core_id);
+        return *t.task;
+    }
+
     int task_list_idx = lookUpMap(m_core_id_index, core_id);
     for (unsigned int i=0; i<task_list[task_list_idx][app_idx].size(); i++)
         {
@@ -811,6 +1011,12 @@ NetworkInterface::get_task_by_task_id(int core_id, int app_idx, int tid)
 
 int
 NetworkInterface::get_core_id_by_task_id(int app_idx, int tid){
+    if (m_net_ptr->isTaskGraphIndexed()){
+        const task_index_type &t = m_net_ptr->get_task_index(app_idx, tid);
+        assert(t.node_id == m_id);
+        return t.task->get_proc_id();
+    }
+
     for (int i=0;i<m_num_cores;i++){
         for (unsigned int j=0;j<task_list[i][app_idx].size();j++){
             GraphTask &t = task_list[i][app_idx].at(j);
@@ -843,11 +1049,20 @@ NetworkInterface::get_core_name_by_index(int i){
 }
 
 int
-NetworkInterface::lookUpMap(std::map<int, int> m, int idx){
-    std::map<int, int>::iterator iter = m.find(idx);
+NetworkInterface::get_core_threads_by_index(int i){
+    if (i<m_num_cores){
+        int core_id = lookUpMap(m_index_core_id, i);
+        return lookUpMap(m_core_id_thread, core_id);
+    }else
+        fatal("Core Index out of range !");
+}
+
+int
+NetworkInterface::lookUpMap(const std::map<int, int> &m, int idx){
+    std::map<int, int>::const_iterator iter = m.find(idx);
     if (iter != m.end())
     //find the key
-        return m[idx];
+        return iter->second;
     else
         fatal("Error in finding key in map !");
 }
@@ -871,6 +1086,10 @@ NetworkInterface::enqueueTaskInThreadQueue()
         }
         if (idle_idx == num_threads)
             continue;//break;
+        //the memory of a DDR core is drained before a checkpoint
+        if (m_ddr_memory[i] != NULL &&
+            m_net_ptr->drainState() != DrainState::Running)
+            continue;
 
         bool isAllThreadRuning = false;
 
@@ -974,19 +1193,14 @@ NetworkInterface::enqueueTaskInThreadQueue()
                         round_robin_offset += 1;
 
                     c_task.add_c_e_times();
+                    m_tg_activity = true;
                     task_in_thread_queue[i][not_busy_idx] = c_task.get_id();
                     app_idx_in_thread_queue[i][not_busy_idx] = app_idx;
                     thread_busy_flag[i][not_busy_idx] = true;
                     assert(remained_execution_time_in_thread[i][not_busy_idx] == -1);
 
-                    int execution_time = c_task.get_random_execution_time();
-                    m_net_ptr->add_execution_time_to_total(execution_time);
-                    remained_execution_time_in_thread[i][not_busy_idx] = execution_time;
-                    c_task.record_execution_time(curCycle(), curCycle()+execution_time);
-
-                    if(c_task.get_c_e_times()<=c_task.get_required_times()){
-                        m_net_ptr->update_start_end_time(app_idx, c_task.get_c_e_times()-1, curCycle(), curCycle()+execution_time);
-                    }
+                    int execution_time = beginTaskExecution(i, not_busy_idx,
+                        app_idx, c_task);
 
                     //if the task have no in edges, we assume it can execute at the Cycle 0.
                     c_task.set_all_tokens_received_time(curCycle());
@@ -994,7 +1208,9 @@ NetworkInterface::enqueueTaskInThreadQueue()
                     for (int k=0;k<c_task.get_size_of_outgoing_edge_list();k++){
 
                         GraphEdge &temp_edge = c_task.get_outgoing_edge_by_offset(k);
-                        assert(temp_edge.update_out_memory_write_pointer());
+                        bool ok = temp_edge.update_out_memory_write_pointer();
+                        panic_if(!ok, "Edge %d has no room left in its out "
+                            "memory !", temp_edge.get_id());
 
                         int dest_proc_id = temp_edge.get_dst_proc_id();
                         if (dest_proc_id == c_task.get_proc_id()){
@@ -1005,10 +1221,16 @@ NetworkInterface::enqueueTaskInThreadQueue()
                         int num_flits = ceil(token_size / (m_net_ptr->getNiFlitSize() * 8));
                         m_total_data_bits[i] += token_size;
 
-                        enqueueFlitsGeneratorBuffer(temp_edge, num_flits, execution_time);
-
-                        temp_edge.generate_new_token();
+                        if (m_ddr_memory[i] != NULL) {
+                            readDramToken(i, not_busy_idx, temp_edge,
+                                num_flits, token_size);
+                        } else {
+                            enqueueFlitsGeneratorBuffer(temp_edge, num_flits, execution_time);
+                            temp_edge.generate_new_token();
+                        }
                     }
+                    if (m_ddr_memory[i] != NULL)
+                        endDramIssue(i, not_busy_idx);
                 }// the task that depends on other tasks
                 else {
                     int k;
@@ -1033,24 +1255,15 @@ NetworkInterface::enqueueTaskInThreadQueue()
 
                         GraphEdge &temp_edge = c_task.get_incoming_edge_by_offset(k);
                         temp_edge.consume_token();
-                        assert(temp_edge.update_in_memory_read_pointer());//operate in this task's in edge
-                        int src_proc_id = temp_edge.get_src_proc_id();
-                        int src_task_id = temp_edge.get_src_task_id();
-                        int edge_id = temp_edge.get_id();
-
-                        // if (src_proc_id == c_task.get_proc_id()){
-                        //     assert(src_proc_id == current_core_id);
-                        //     int src_task_id = temp_edge.get_src_task_id();
-                        //     int edge_id = temp_edge.get_id();
-                            // GraphTask &src_task = get_task_by_task_id(current_core_id, app_idx, src_task_id);
-                            // GraphEdge &out_edge = src_task.get_outgoing_edge_by_eid(edge_id);
-                            // assert(&out_edge == &temp_edge);
-                            // assert(out_edge.update_out_memory_read_pointer());  //operate in last task's out edge
-                            // m_net_ptr->update_in_memory_info(src_proc_id, app_idx, src_task_id, edge_id);
-                        // } 
-                        // else {
-                            m_net_ptr->update_in_memory_info(src_proc_id, app_idx, src_task_id, edge_id);   //operate in last task's out edge(in mem read)//////////////////////////////
-                        // }
+                        //operate in this task's in edge
+                        bool read = temp_edge.update_in_memory_read_pointer();
+                        panic_if(!read, "Edge %d has no token to read from "
+                            "its in memory !", temp_edge.get_id());
+                        //the edge is shared with the source task, give the
+                        //slot back to it directly
+                        bool released = temp_edge.release_in_memory_credit();
+                        panic_if(!released, "Edge %d has no in memory credit "
+                            "to give back !", temp_edge.get_id());
                     }
 
                     /*if (current_core_id==4){
@@ -1078,20 +1291,14 @@ NetworkInterface::enqueueTaskInThreadQueue()
                         round_robin_offset += 1;
 
                     c_task.add_c_e_times();
+                    m_tg_activity = true;
                     task_in_thread_queue[i][not_busy_idx] = c_task.get_id();
                     app_idx_in_thread_queue[i][not_busy_idx] = app_idx;
                     thread_busy_flag[i][not_busy_idx] = true;
                     assert(remained_execution_time_in_thread[i][not_busy_idx] == -1);
 
-                    int execution_time = c_task.get_random_execution_time();
-                    m_net_ptr->add_execution_time_to_total(execution_time);
-                    remained_execution_time_in_thread[i][not_busy_idx] = execution_time;
-                    c_task.record_execution_time(curCycle(), curCycle()+execution_time);
-                    
-                    if(c_task.get_c_e_times()<=c_task.get_required_times()){
-                        m_net_ptr->update_start_end_time(app_idx, c_task.get_c_e_times()-1, curCycle(), curCycle()+execution_time);
-                        
-                    }
+                    int execution_time = beginTaskExecution(i, not_busy_idx,
+                        app_idx, c_task);
 
                     /*if (current_core_id==4){
                         printf("Cycle [ %lu ] Task rr ========> %3d\n", u_int64_t(curCycle()),task_to_exec_round_robin[i][app_idx]);
@@ -1110,11 +1317,11 @@ NetworkInterface::enqueueTaskInThreadQueue()
 
                     //For the task has in edges, compare the receive token time of
                     //the iteration and choose the max cycle.
-                    int get_all_tokens_time = 0;
+                    uint64_t get_all_tokens_time = 0;
                     for (int ii=0;ii<c_task.get_size_of_incoming_edge_list();ii++){
                         
                         GraphEdge &temp_edge = c_task.get_incoming_edge_by_offset(ii);
-                        int edge_get_token_time = temp_edge.get_token_received_time();
+                        uint64_t edge_get_token_time = temp_edge.get_token_received_time();
                         if (edge_get_token_time > get_all_tokens_time)
                             get_all_tokens_time = edge_get_token_time;
                         
@@ -1127,7 +1334,9 @@ NetworkInterface::enqueueTaskInThreadQueue()
                     */
                     for (int k=0;k<c_task.get_size_of_outgoing_edge_list();k++){
                         GraphEdge &temp_edge = c_task.get_outgoing_edge_by_offset(k);
-                        assert(temp_edge.update_out_memory_write_pointer());
+                        bool ok = temp_edge.update_out_memory_write_pointer();
+                        panic_if(!ok, "Edge %d has no room left in its out "
+                            "memory !", temp_edge.get_id());
 
                         int dest_proc_id = temp_edge.get_dst_proc_id();
                         if (dest_proc_id == c_task.get_proc_id()){
@@ -1144,9 +1353,16 @@ NetworkInterface::enqueueTaskInThreadQueue()
                         int num_flits = ceil(token_size / (m_net_ptr->getNiFlitSize() * 8));
                         m_total_data_bits[i] += token_size;
 
-                        enqueueFlitsGeneratorBuffer(temp_edge, num_flits, execution_time);
-                        temp_edge.generate_new_token();
+                        if (m_ddr_memory[i] != NULL) {
+                            readDramToken(i, not_busy_idx, temp_edge,
+                                num_flits, token_size);
+                        } else {
+                            enqueueFlitsGeneratorBuffer(temp_edge, num_flits, execution_time);
+                            temp_edge.generate_new_token();
+                        }
                     }
+                    if (m_ddr_memory[i] != NULL)
+                        endDramIssue(i, not_busy_idx);
                 }
             }
             task_to_exec_round_robin[i][app_idx] = (task_to_exec_round_robin[i][app_idx] + round_robin_offset) % task_list[i][app_idx].size();
@@ -1169,6 +1385,7 @@ NetworkInterface::enqueueTaskInThreadQueue()
         }
         if(pp == m_num_apps){
             reset_initial_app_ratio_token();
+            m_tg_activity = true;
         }
 
         for (int kk=0; kk<m_num_apps;kk++){
@@ -1207,6 +1424,7 @@ NetworkInterface::enqueueTaskInThreadQueue()
                     assert(c_task.get_size_of_incoming_edge_list() == 0);
                     initial_app_ratio_token[app_idx]--; //consume token to reach certain ratio
                     c_task.add_c_e_times();
+                    m_tg_activity = true;
                     initial_task_thread_queue[not_busy_idx] = c_task.get_id();
                     initial_task_busy_flag[not_busy_idx] = true;
                     app_idx_in_initial_thread_queue[not_busy_idx] = app_idx;
@@ -1224,7 +1442,9 @@ NetworkInterface::enqueueTaskInThreadQueue()
                     for (int k=0;k<c_task.get_size_of_outgoing_edge_list();k++){
 
                         GraphEdge &temp_edge = c_task.get_outgoing_edge_by_offset(k);
-                        assert(temp_edge.update_out_memory_write_pointer());
+                        bool ok = temp_edge.update_out_memory_write_pointer();
+                        panic_if(!ok, "Edge %d has no room left in its out "
+                            "memory !", temp_edge.get_id());
                         int dest_proc_id = temp_edge.get_dst_proc_id();
                         if (dest_proc_id == c_task.get_proc_id()){
                             assert(dest_proc_id == entrance_core);
@@ -1253,6 +1473,8 @@ NetworkInterface::task_execution()
             if (!thread_busy_flag[i][j]){
                 assert(remained_execution_time_in_thread[i][j] == -1);
                 continue;
+            }else if (isDramWaiting(i, j)){
+                continue;
             }else{
                 remained_execution_time_in_thread[i][j]--;
                 if (remained_execution_time_in_thread[i][j]<=0){
@@ -1261,6 +1483,7 @@ NetworkInterface::task_execution()
                     int app_idx = app_idx_in_thread_queue[i][j];
                     GraphTask &c_task = get_task_by_task_id(current_core_id, app_idx, c_task_id);
                     c_task.add_completed_times();
+                    m_tg_activity = true;
                     //for output dete delay
                     if(c_task.get_completed_times()<=c_task.get_required_times())
                         m_net_ptr->add_num_completed_tasks(app_idx, c_task.get_completed_times());
@@ -1282,11 +1505,12 @@ NetworkInterface::task_execution()
             }else{
                 remainad_initial_task_exec_time[i]--;
                 if (remainad_initial_task_exec_time[i]<=0){
-                    int c_task_id = initial_task_thread_queue[i];
+                    int M5_VAR_USED c_task_id = initial_task_thread_queue[i];
                     assert(c_task_id==0);
                     int app_idx = app_idx_in_initial_thread_queue[i];
                     GraphTask &c_task = task_list[entrance_idx_in_NI][app_idx][0];
                     c_task.add_completed_times();
+                    m_tg_activity = true;
                     if (c_task.get_completed_times()<=c_task.get_required_times())
                         m_net_ptr->add_num_completed_tasks(app_idx, c_task.get_completed_times());
 
@@ -1299,6 +1523,216 @@ NetworkInterface::task_execution()
     }
 }
 
+int
+NetworkInterface::beginTaskExecution(int core_idx, int thread, int app_idx,
+    GraphTask &c_task)
+{
+    //a DDR task counts down from 1 once its accesses are done
+    TaskGraphMemory *mem = m_ddr_memory[core_idx];
+    int execution_time = (mem == NULL) ?
+        c_task.get_random_execution_time() : 1;
+    remained_execution_time_in_thread[core_idx][thread] = execution_time;
+    c_task.record_execution_time(curCycle(), curCycle()+execution_time);
+    if (c_task.get_c_e_times()<=c_task.get_required_times()){
+        m_net_ptr->update_start_end_time(app_idx, c_task.get_c_e_times()-1,
+            curCycle(), curCycle()+execution_time);
+    }
+    if (mem == NULL){
+        m_net_ptr->add_execution_time_to_total(execution_time);
+        return execution_time;
+    }
+
+    DramExecution &d = m_dram_execution[core_idx][thread];
+    assert(!d.waiting && d.out_tokens.empty());
+    d.waiting = true;
+    d.app_idx = app_idx;
+    d.task_id = c_task.get_id();
+    d.exec = c_task.get_c_e_times() - 1;
+    d.start = curCycle();
+    //the consumed tokens are written, the pkts do not carry the size of
+    //their token so it is the mean of the edge
+    for (int k=0;k<c_task.get_size_of_incoming_edge_list();k++){
+        GraphEdge &in_edge = c_task.get_incoming_edge_by_offset(k);
+        mem->access(app_idx, d.task_id, thread,
+            (uint64_t)ceil(in_edge.get_mu() / 8), true);
+    }
+    return execution_time;
+}
+
+void
+NetworkInterface::readDramToken(int core_idx, int thread, GraphEdge &e,
+    int num_flits, double token_size)
+{
+    DramExecution &d = m_dram_execution[core_idx][thread];
+    assert(d.waiting);
+    d.out_tokens.push_back(make_pair(&e, num_flits));
+    m_ddr_memory[core_idx]->access(d.app_idx, d.task_id, thread,
+        (uint64_t)ceil(token_size / 8), false);
+}
+
+void
+NetworkInterface::endDramIssue(int core_idx, int thread)
+{
+    //a task without any byte to move is done at once
+    if (!m_ddr_memory[core_idx]->isPending(thread))
+        dramAccessDone(core_idx, thread);
+}
+
+void
+NetworkInterface::dramAccessDone(int core_idx, int thread)
+{
+    DramExecution &d = m_dram_execution[core_idx][thread];
+    assert(d.waiting &&
+        remained_execution_time_in_thread[core_idx][thread] == 1);
+    d.waiting = false;
+
+    //the thread is free in the next cycle, as with a drawn execution time
+    //ending now
+    Cycles end = curCycle() + Cycles(1);
+    m_net_ptr->add_execution_time_to_total(end - d.start);
+    int core_id = lookUpMap(m_index_core_id, core_idx);
+    GraphTask &c_task = get_task_by_task_id(core_id, d.app_idx, d.task_id);
+    c_task.record_execution_end(d.exec, end);
+    if (d.exec < c_task.get_required_times())
+        m_net_ptr->update_start_end_time(d.app_idx, d.exec, d.start, end);
+
+    //the tokens read from mem leave now
+    for (int k=0;k<d.out_tokens.size();k++){
+        GraphEdge &e = *d.out_tokens[k].first;
+        enqueueFlitsGeneratorBuffer(e, d.out_tokens[k].second, 1);
+        e.generate_new_token();
+    }
+    d.out_tokens.clear();
+
+    scheduleEvent(Cycles(1));
+}
+
+void
+NetworkInterface::setDdrMemory(int core_id, TaskGraphMemory *mem)
+{
+    int idx = lookUpMap(m_core_id_index, core_id);
+    DramExecution d;
+    d.waiting = false;
+    d.app_idx = -1;
+    d.task_id = -1;
+    d.exec = -1;
+    d.start = Cycles(0);
+    m_ddr_memory[idx] = mem;
+    m_dram_execution[idx].assign(lookUpMap(m_core_id_thread, core_id), d);
+    mem->setCore(this, idx);
+}
+
+// In event-driven mode the NI is not evaluated in cycles where nothing can
+// change its task graph state. Such an idle cycle still counts down the
+// running threads and the generator buffer, and moves the round robin
+// pointers, so replay that here before evaluating the current cycle.
+void
+NetworkInterface::catchUpIdleCycles()
+{
+    Cycles now = curCycle();
+    int skipped = (now > m_tg_last_cycle) ?
+        (int)(now - m_tg_last_cycle) - 1 : 0;
+    m_tg_last_cycle = now;
+
+    if (skipped <= 0)
+        return;
+
+    for (int i=0;i<m_num_cores;i++){
+        int current_core_id = lookUpMap(m_index_core_id, i);
+        int num_threads = lookUpMap(m_core_id_thread, current_core_id);
+
+        bool has_idle_thread = false;
+        for (int j=0;j<num_threads;j++){
+            if (thread_busy_flag[i][j]){
+                if (!isDramWaiting(i, j))
+                    remained_execution_time_in_thread[i][j] -= skipped;
+            }else
+                has_idle_thread = true;
+        }
+
+        //a core with an idle thread walks all its tasks every cycle, task 0
+        //is skipped and moves the task round robin, then the app round
+        //robin moves on
+        if (has_idle_thread){
+            for (int app_idx=0;app_idx<m_num_apps;app_idx++){
+                int num_tasks = task_list[i][app_idx].size();
+                for (int k=0;k<num_tasks;k++){
+                    if (task_list[i][app_idx][k].get_id() == 0){
+                        task_to_exec_round_robin[i][app_idx] =
+                            (task_to_exec_round_robin[i][app_idx] +
+                            skipped % num_tasks) % num_tasks;
+                    }
+                }
+            }
+            app_exec_rr[i] = (app_exec_rr[i] + skipped % m_num_apps)
+                % m_num_apps;
+        }
+    }
+
+    if (m_id==entrance_NI){
+        for (int i=0;i<num_initial_thread;i++){
+            if (initial_task_busy_flag[i])
+                remainad_initial_task_exec_time[i] -= skipped;
+        }
+        app_exec_rr[entrance_idx_in_NI] =
+            (app_exec_rr[entrance_idx_in_NI] + skipped % m_num_apps)
+            % m_num_apps;
+    }
+
+    core_buffer_round_robin = (core_buffer_round_robin + skipped % m_num_cores)
+        % m_num_cores;
+}
+
+// If nothing changed in this cycle, the next cycles are idle until a
+// thread completes or the generator buffer releases a packet. Flits and
+// credits arriving on the links wake the NI through the link consumer.
+void
+NetworkInterface::scheduleTaskGraphWakeup()
+{
+    if (m_tg_activity){
+        scheduleEvent(Cycles(1));
+        return;
+    }
+
+    int next_event = INT_MAX;
+    for (int i=0;i<m_num_cores;i++){
+        //buffered packets and crossbar transfers are served every cycle
+        if (!core_buffer[i].empty() || !cluster_buffer[i].empty() ||
+            crossbar_delay_timer[i] != -1){
+            scheduleEvent(Cycles(1));
+            return;
+        }
+
+        int current_core_id = lookUpMap(m_index_core_id, i);
+        int num_threads = lookUpMap(m_core_id_thread, current_core_id);
+        for (int j=0;j<num_threads;j++){
+            //a DDR task waiting for mem is woken by the response
+            if (thread_busy_flag[i][j] && !isDramWaiting(i, j))
+                next_event = min(next_event,
+                    remained_execution_time_in_thread[i][j]);
+        }
+
+        if (!generator_buffer[i]->isEmpty()){
+            Cycles release = generator_buffer[i]->getNextReleaseTime();
+            next_event = min<uint64_t>(next_event,
+                max(release, curCycle()) - curCycle());
+        }
+    }
+
+    if (m_id==entrance_NI){
+        for (int i=0;i<num_initial_thread;i++){
+            if (initial_task_busy_flag[i])
+                next_event = min(next_event,
+                    remainad_initial_task_exec_time[i]);
+        }
+    }
+
+    if (next_event == INT_MAX)
+        return;
+
+    scheduleEvent(Cycles(max(next_event, 1)));
+}
+
 void
 NetworkInterface::enqueueFlitsGeneratorBuffer( GraphEdge &e, int num, int task_execution_time ){
     //actually enqueue the head flit in the Buffer, if triggerred, the Buffer
@@ -1342,23 +1776,6 @@ NetworkInterface::enqueueFlitsGeneratorBuffer( GraphEdge &e, int num, int task_e
     }
     */
 
-    //specify the destinition
-    NetDest net_dest;
-    NodeID destID = (NodeID) route.dest_ni;
-
-    for (int m = 0;m < (int) MachineType_NUM; m++) {
-        if ((destID >= MachineType_base_number((MachineType) m)) &&
-                destID < MachineType_base_number((MachineType) (m+1))) {
-            // calculating the NetDest associated with this dest_ni
-            net_dest.clear();
-            net_dest.add((MachineID) {(MachineType) m, (destID -
-                        MachineType_base_number((MachineType) m))});
-            //net_msg_ptr->getDestination() = net_dest;
-            break;
-        }
-    }
-    route.net_dest = net_dest;
-
     MsgPtr msg_ptr=NULL;
 
     //token length in packet
@@ -1410,11 +1827,11 @@ NetworkInterface::enqueueFlitsGeneratorBuffer( GraphEdge &e, int num, int task_e
         u_int64_t(curCycle() + Cycles(temp_time_to_generate - 1)));
         */
 
-        generator_buffer_type *buffer_temp = new generator_buffer_type;
-        buffer_temp->flit_to_generate = fl;
-        buffer_temp->time_to_generate_flit = temp_time_to_generate;
+        //the generator buffer is updated in this cycle too, so the pkt is
+        //released temp_time_to_generate - 1 cycles later
         int generator_buffer_idx = lookUpMap(m_core_id_index, current_core_id);
-        generator_buffer[generator_buffer_idx].push_back( buffer_temp );
+        generator_buffer[generator_buffer_idx]->insert(fl,
+            curCycle() + Cycles(max(temp_time_to_generate - 1, 0)));
     }
 }
 
@@ -1427,83 +1844,82 @@ NetworkInterface::updateGeneratorBuffer(){
 
         int current_core_id = lookUpMap(m_index_core_id, i);
 
-        for (unsigned j=0;j<generator_buffer[i].size();j++){
-            //update remained sending time
-            generator_buffer[i].at(j)->time_to_generate_flit--;
-            if (generator_buffer[i].at(j)->time_to_generate_flit <= 0){
-                flit *fl = generator_buffer[i].at(j)->flit_to_generate;
-                //check whether the task on the core
-                GraphTask& src_task = get_task_by_task_id(current_core_id, fl->get_tg_info().app_idx,\
-                    fl->get_tg_info().src_task);
-                GraphEdge& out_edge = src_task.\
-                    get_outgoing_edge_by_eid(fl->get_tg_info().edge_id);
-                int dst_core_id = out_edge.get_dst_proc_id();
-                int dst_node_id = fl->get_route().dest_ni;
-
-                if (dst_core_id == current_core_id){
-                    //send to the same core, write directly
-                    /*printf("Core [ %2d ] Task [ %2d ] send themseleves \
-                    Task [[ %2d ]]!\n", current_core_id, \
-                    fl->get_tg_info().src_task, fl->get_tg_info().dest_task);*/
-                    assert(dst_node_id == m_id);
-                    GraphTask& dst_task = get_task_by_task_id(current_core_id,fl->get_tg_info().app_idx,\
-                        fl->get_tg_info().dest_task);
-                    GraphEdge& in_edge = dst_task.\
-                        get_incoming_edge_by_eid(fl->get_tg_info().edge_id);
-
-                    if(!out_edge.record_sent_pkt(fl)){
-                        continue;
-                    }
+        GeneratorBuffer *gb = generator_buffer[i];
+        gb->advance(curCycle());
+
+        generator_buffer_type *prev = NULL;
+        generator_buffer_type *entry = gb->getReadyHead();
+        while (entry != NULL){
+            m_tg_activity = true;
+            flit *fl = entry->flit_to_generate;
+            //check whether the task on the core
+            GraphEdge& out_edge = m_net_ptr->get_edge(\
+                fl->get_tg_info().app_idx, fl->get_tg_info().edge_id);
+            assert(out_edge.get_src_proc_id() == current_core_id);
+            int dst_core_id = out_edge.get_dst_proc_id();
+            int dst_node_id = fl->get_route().dest_ni;
+
+            if (dst_core_id == current_core_id){
+                //send to the same core, write directly
+                /*printf("Core [ %2d ] Task [ %2d ] send themseleves \
+                Task [[ %2d ]]!\n", current_core_id, \
+                fl->get_tg_info().src_task, fl->get_tg_info().dest_task);*/
+                assert(dst_node_id == m_id);
+                GraphEdge& in_edge = m_net_ptr->get_edge(\
+                    fl->get_tg_info().app_idx, fl->get_tg_info().edge_id);
+
+                if(!out_edge.record_sent_pkt(fl)){
+                    //no memory in the dest task, retry next cycle
+                    prev = entry;
+                    entry = entry->next;
+                    continue;
+                }
 /*
-                    //record flit info in same core communication
-                    int num_flits = fl->get_size();
-                    vector<flit *> in_core_buffer;
-                    for (int j=0;j<num_flits;j++){
-                        flit* generated_fl = new flit(j, -1, 2, fl->get_route(), \
-                        num_flits, fl->get_msg_ptr(), curCycle(), fl->get_tg_info());
-                        //the fl enqueue time record the time flit should be sent
-                        generated_fl->set_src_delay(curCycle() - \
-                            fl->get_enqueue_time());
-
-                        in_core_buffer.push_back(generated_fl);
-                    }
-                    delete fl;
-                    for (int j=0;j<num_flits;j++){
-                    //receive a pkt (just the head flit)
-                        flit* fl = in_core_buffer.front();
-                        fl->set_dequeue_time(curCycle());
-
-                        if (fl->get_type() == TAIL_ || fl->get_type() == HEAD_TAIL_)
-                            in_edge.record_pkt(fl, curCycle());    //operate in next task's in edge(in mem write)
-                        //Note that!! if intra-cluster, we should set the hop_num
-                        //to 0, because the intial value is -1 !
-                        //record the flit time information !!
-                        fl->increment_hops();
-                        assert(fl->get_route().hops_traversed==0);
-                        incrementStats(fl, true);
-                        delete fl;
-                        in_core_buffer.erase(in_core_buffer.begin());
-                        in_core_buffer.shrink_to_fit();
-                    }
-*/
-                    if (!in_edge.record_pkt(fl, curCycle()))    //operate in next task's in edge(in mem write)
-                       printf("record pkt Error! \n");
+                //record flit info in same core communication
+                int num_flits = fl->get_size();
+                vector<flit *> in_core_buffer;
+                for (int j=0;j<num_flits;j++){
+                    flit* generated_fl = new flit(j, -1, 2, fl->get_route(), \
+                    num_flits, fl->get_msg_ptr(), curCycle(), fl->get_tg_info());
+                    //the fl enqueue time record the time flit should be sent
+                    generated_fl->set_src_delay(curCycle() - \
+                        fl->get_enqueue_time());
 
-                    //Note: if flit useless, remeber to delete !!
-                    delete fl;
+                    in_core_buffer.push_back(generated_fl);
                 }
-                else {
-                    if(dst_node_id == m_id)
-                        core_buffer[i].push_back(fl); 
-                    else
-                        cluster_buffer[i].push_back(fl);
+                delete fl;
+                for (int j=0;j<num_flits;j++){
+                //receive a pkt (just the head flit)
+                    flit* fl = in_core_buffer.front();
+                    fl->set_dequeue_time(curCycle());
+
+                    if (fl->get_type() == TAIL_ || fl->get_type() == HEAD_TAIL_)
+                        in_edge.record_pkt(fl, curCycle());    //operate in next task's in edge(in mem write)
+                    //Note that!! if intra-cluster, we should set the hop_num
+                    //to 0, because the intial value is -1 !
+                    //record the flit time information !!
+                    fl->increment_hops();
+                    assert(fl->get_route().hops_traversed==0);
+                    incrementStats(fl, true);
+                    delete fl;
+                    in_core_buffer.erase(in_core_buffer.begin());
+                    in_core_buffer.shrink_to_fit();
                 }
-                    
-                delete generator_buffer[i].at(j);
-                generator_buffer[i].erase(generator_buffer[i].begin()+j);
-                generator_buffer[i].shrink_to_fit();
-                j--;
+*/
+                if (!in_edge.record_pkt(fl, curCycle()))    //operate in next task's in edge(in mem write)
+                   printf("record pkt Error! \n");
+
+                //Note: if flit useless, remeber to delete !!
+                delete fl;
+            }
+            else {
+                if(dst_node_id == m_id)
+                    core_buffer[i].push_back(fl); 
+                else
+                    cluster_buffer[i].push_back(fl);
             }
+                
+            entry = gb->release(prev, entry);
         }
     }
 }
@@ -1520,6 +1936,7 @@ NetworkInterface::coreSendFlitsOut(){//in cluster, between core, crossbar delay
             assert(crossbar_busy_out[i]);
             if (crossbar_delay_timer[i] == crossbar_delay){
                 //send data from crossbar successfully
+                m_tg_activity = true;
                 crossbar_delay_timer[i] = -1;
                 crossbar_busy_out[i] = false;
 
@@ -1528,11 +1945,10 @@ NetworkInterface::coreSendFlitsOut(){//in cluster, between core, crossbar delay
                 assert(crossbar_data[i].size() == num_flits);
 
                 //crossbar send flits to dst_core
-                int dst_core_id = lookUpMap(m_index_core_id, i);
+                int M5_VAR_USED dst_core_id = lookUpMap(m_index_core_id, i);
 
-                GraphTask& dst_task = get_task_by_task_id(dst_core_id, fl->get_tg_info().app_idx,\
-                    fl->get_tg_info().dest_task);
-                GraphEdge& out_edge = dst_task.get_incoming_edge_by_eid(fl->get_tg_info().edge_id);
+                GraphEdge& out_edge = m_net_ptr->get_edge(\
+                    fl->get_tg_info().app_idx, fl->get_tg_info().edge_id);
                 assert(out_edge.get_dst_proc_id() == dst_core_id);
 
                 for (int j=0;j<num_flits;j++){
@@ -1611,7 +2027,6 @@ NetworkInterface::intraClusterOut()
 
         // int p, least_c_e_times = 99999, pick = 0, defu_app_idx;
         // if core_buffer do not have flit of this app, check next app. if have flit of this app, choose one with least c_e_times.
-        srand((int)time(NULL));
         // for (int kk=0; kk<m_num_apps && least_c_e_times == 99999;kk++){
             
             // defu_app_idx = (kk+app_exec_rr[i]) % m_num_apps;
@@ -1643,10 +2058,9 @@ NetworkInterface::intraClusterOut()
         //choose the least iteration task
         flit* fl = core_buffer[j].at(pick);
         //////////////////////////////////////////////////////////////////////
-        GraphTask& src_task = get_task_by_task_id(current_core_id, fl->get_tg_info().app_idx,\
-            fl->get_tg_info().src_task);
         int edge_id = fl->get_tg_info().edge_id;
-        GraphEdge& out_edge = src_task.get_outgoing_edge_by_eid(edge_id);
+        GraphEdge& out_edge = m_net_ptr->get_edge(\
+            fl->get_tg_info().app_idx, edge_id);
         int dst_core_id = out_edge.get_dst_proc_id();
         
         int dst_core_idx = lookUpMap(m_core_id_index, dst_core_id);
@@ -1717,6 +2131,11 @@ NetworkInterface::intraClusterOut()
 void
 NetworkInterface::interClusterOut()
 {
+    //the network is drained for a checkpoint, the pkts wait in the
+    //cluster buffers, which are saved
+    if (m_net_ptr->drainState() != DrainState::Running)
+        return;
+
     for (int i=0;i<m_num_cores;i++){
         int j = (i + core_buffer_round_robin) % m_num_cores;
         int current_core_id = lookUpMap(m_index_core_id, j);
@@ -1729,7 +2148,6 @@ NetworkInterface::interClusterOut()
         //////////////////////////////////////////////////////////////////////
         // int p, least_c_e_times = 99999, pick = 0, defu_app_idx;
         //if cluster_buffer do not have flit of this app, check next app. if have flit of this app, choose one with least c_e_times.
-        srand((int)time(NULL));
         // for (int kk=0; kk<m_num_apps && least_c_e_times == 99999;kk++){
         //     defu_app_idx = (kk+app_exec_rr[i]) % m_num_apps;
         // while(least_c_e_times == 99999){
@@ -1776,15 +2194,18 @@ NetworkInterface::interClusterOut()
         flit* fl = cluster_buffer[j].at(pick);
         //////////////////////////////////////////////////////////////////////
 
-        GraphTask& src_task = get_task_by_task_id(current_core_id, fl->get_tg_info().app_idx,fl->get_tg_info().src_task);
-        GraphEdge& out_edge = src_task.get_outgoing_edge_by_eid(fl->get_tg_info().edge_id);
+        GraphEdge& out_edge = m_net_ptr->get_edge(\
+            fl->get_tg_info().app_idx, fl->get_tg_info().edge_id);
         int dst_core_id = out_edge.get_dst_proc_id();
         int dst_node_id = fl->get_route().dest_ni;
 
-        int vc=calculateVC(fl->get_vnet());
-
-        if (vc == -1)
-            break;
+        //the analytical network has no VCs
+        int vc = 0;
+        if (!m_net_ptr->isAnalyticalNetwork()) {
+            vc = calculateVC(fl->get_vnet());
+            if (vc == -1)
+                break;
+        }
 
         //check the buffer in the dest core
 
@@ -1806,6 +2227,29 @@ NetworkInterface::interClusterOut()
 
         int num_flits = fl->get_size();
 
+        if (m_net_ptr->isAnalyticalNetwork()) {
+            //the whole pkt reaches the dest NI when its tail would
+            RouteInfo route = fl->get_route();
+            Cycles latency = m_net_ptr->getAnalyticalModel()->send(m_id,
+                dst_node_id, num_flits, curCycle(), route.hops_traversed);
+            NetworkInterface *dst_ni =
+                m_net_ptr->getNetworkInterface(dst_node_id);
+            for (int j=0;j<num_flits;j++){
+                flit* generated_fl = new flit(j, vc, 2, route, num_flits,
+                    fl->get_msg_ptr(), curCycle(), fl->get_tg_info());
+                generated_fl->set_src_delay(
+                    curCycle() - fl->get_enqueue_time());
+                dst_ni->receiveAnalyticalFlit(generated_fl,
+                    curCycle() + latency);
+            }
+
+            delete fl;
+            cluster_buffer[j].erase(cluster_buffer[j].begin()+pick);
+            cluster_buffer[j].shrink_to_fit();
+            core_buffer_sent[j] += 1;
+            continue;
+        }
+
         for (int j=0;j<num_flits;j++){
             flit* generated_fl = new flit(j, vc, 2, fl->get_route(), \
             num_flits, fl->get_msg_ptr(),curCycle(), fl->get_tg_info());
@@ -1856,6 +2300,11 @@ std::string* core_name, int* num_threads, int num_apps){
 
     remained_execution_time.resize(m_num_cores);
     generator_buffer.resize(m_num_cores);
+    for (int i=0;i<m_num_cores;i++)
+        generator_buffer[i] = new GeneratorBuffer();
+    //the DDR cores get their memory from setDdrMemory
+    m_ddr_memory.assign(m_num_cores, NULL);
+    m_dram_execution.resize(m_num_cores);
     core_buffer.resize(m_num_cores);
     cluster_buffer.resize(m_num_cores);
     crossbar_busy_out.resize(m_num_cores);
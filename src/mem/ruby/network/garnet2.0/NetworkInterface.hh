@@ -34,19 +34,23 @@
 #ifndef __MEM_RUBY_NETWORK_GARNET2_0_NETWORKINTERFACE_HH__
 #define __MEM_RUBY_NETWORK_GARNET2_0_NETWORKINTERFACE_HH__
 
+#include <algorithm>
 #include <iostream>
+#include <map>
 #include <vector>
 
 #include "mem/ruby/common/Consumer.hh"
 #include "mem/ruby/network/garnet2.0/CommonTypes.hh"
 #include "mem/ruby/network/garnet2.0/CreditLink.hh"
 #include "mem/ruby/network/garnet2.0/GarnetNetwork.hh"
+#include "mem/ruby/network/garnet2.0/GeneratorBuffer.hh"
 #include "mem/ruby/network/garnet2.0/NetworkLink.hh"
 #include "mem/ruby/network/garnet2.0/OutVcState.hh"
 #include "mem/ruby/slicc_interface/Message.hh"
 #include "params/GarnetNetworkInterface.hh"
 
 class MessageBuffer;
+class TaskGraphMemory;
 class flitBuffer;
 
 class NetworkInterface : public ClockedObject, public Consumer
@@ -70,10 +74,21 @@ class NetworkInterface : public ClockedObject, public Consumer
     void print(std::ostream& out) const;
     int get_vnet(int vc);
     int get_router_id() { return m_router_id; }
+    NetworkLink *getInNetLink() { return inNetLink; }
+    NetworkLink *getOutNetLink() { return outNetLink; }
+    //a flit of the analytical network, handed over at its arrival cycle
+    void receiveAnalyticalFlit(flit *t_flit, Cycles arrival);
     void init_net_ptr(GarnetNetwork *net_ptr) { m_net_ptr = net_ptr; }
 
     uint32_t functionalWrite(Packet *);
 
+    //no flit or credit of this NI left in the network
+    bool isDrained();
+    //the task graph state of the cores, the network side is drained
+    //before a checkpoint and is not saved
+    void serialize(CheckpointOut &cp) const override;
+    void unserialize(CheckpointIn &cp) override;
+
     //for task graph traffic
     int add_task(int app_idx, GraphTask &t, bool is_head_task);
     int	sort_task_list();
@@ -89,17 +104,41 @@ class NetworkInterface : public ClockedObject, public Consumer
     //muilt core
     int get_core_id_by_task_id(int app_idx, int tid);
     int get_num_cores(){ return m_num_cores; }
+    //max pending pkts seen in the generator buffer of a core
+    int
+    getGeneratorBufferPeak()
+    {
+        int peak = 0;
+        for (int i=0;i<generator_buffer.size();i++)
+            peak = std::max(peak, generator_buffer[i]->getPeakSize());
+        return peak;
+    }
+    //pkts of all the cores waiting in the generator, core and cluster
+    //buffers to be injected
+    int
+    getInjectionQueueDepth()
+    {
+        int depth = 0;
+        for (int i=0;i<generator_buffer.size();i++)
+            depth += generator_buffer[i]->getSize() + get_core_buffer_size(i);
+        return depth;
+    }
     int get_core_id_by_index(int i);
     std::string get_core_name_by_index(int i);
+    int get_core_threads_by_index(int i);
 
     void enqueueTaskInThreadQueue();
     void task_execution();
+    //the tasks of core_id take the time of their accesses to mem
+    void setDdrMemory(int core_id, TaskGraphMemory *mem);
+    //the last access of the task on the thread is done
+    void dramAccessDone(int core_idx, int thread);
 
     //for construct architecture in tg mode
     bool configureNode(int num_cores, int* core_id, \
     std::string* core_name, int* num_threads, int num_apps);
     void printNodeConfiguation();
-    int lookUpMap(std::map<int, int> m, int idx);
+    int lookUpMap(const std::map<int, int> &m, int idx);
 
     // when token is all consumed, reset to fixed value
     void reset_initial_app_ratio_token(){
@@ -131,6 +170,7 @@ class NetworkInterface : public ClockedObject, public Consumer
         fixed_initial_app_ratio_token.push_back(ratiolist[i]);
         initial_app_ratio_token.push_back(ratiolist[i]);
       }
+    }
 
   private:
     GarnetNetwork *m_net_ptr;
@@ -165,7 +205,12 @@ class NetworkInterface : public ClockedObject, public Consumer
     // When a vc stays busy for a long time, it indicates a deadlock
     std::vector<int> vc_busy_counter;
 
+    //flits of the analytical network by arrival cycle, in send order
+    std::multimap<Cycles, flit *> m_analytical_arrivals;
+
     bool checkStallQueue();
+    //a task graph flit reached this NI, record its pkt at the tail
+    void consumeTaskGraphFlit(flit *t_flit, bool send_credit);
     bool flitisizeMessage(MsgPtr msg_ptr, int vnet);
     int calculateVC(int vnet);
     //Get the remained vcs, make corebuffer can enqueue more flits in buffer
@@ -245,7 +290,37 @@ class NetworkInterface : public ClockedObject, public Consumer
         } compare;
 
     //Generator Buffer for each Core, can be considered as the running Core
-    std::vector< std::vector<generator_buffer_type* >> generator_buffer;
+    std::vector<GeneratorBuffer *> generator_buffer;
+
+    //the memory of a DDR core, NULL for the other cores
+    std::vector<TaskGraphMemory *> m_ddr_memory;
+    //a task of a DDR core waiting for its accesses, its out tokens are
+    //generated once they are done
+    struct DramExecution
+    {
+        bool waiting;
+        int app_idx;
+        int task_id;
+        int exec;
+        Cycles start;
+        std::vector<std::pair<GraphEdge *, int> > out_tokens;
+    };
+    //m_dram_execution[core_idx][thread]
+    std::vector<std::vector<DramExecution> > m_dram_execution;
+    bool
+    isDramWaiting(int core_idx, int thread)
+    {
+        return m_ddr_memory[core_idx] != NULL &&
+            m_dram_execution[core_idx][thread].waiting;
+    }
+    //the execution time of a task starting on the thread, drawn or
+    //taken by the accesses of a DDR core
+    int beginTaskExecution(int core_idx, int thread, int app_idx,
+        GraphTask &c_task);
+    //an out token of a task of a DDR core, read from mem first
+    void readDramToken(int core_idx, int thread, GraphEdge &e,
+        int num_flits, double token_size);
+    void endDramIssue(int core_idx, int thread);
 
     //remained execution time in each core
     std::vector<int> remained_execution_time;
@@ -257,6 +332,17 @@ class NetworkInterface : public ClockedObject, public Consumer
     void coreSendFlitsOut();
     void intraClusterOut();
     void interClusterOut();
+
+    //for event-driven task graph mode
+    //set when the task graph state changed in this cycle, so the NI has to
+    //be evaluated again in the next cycle
+    bool m_tg_activity;
+    //last cycle in which the task graph state was evaluated
+    Cycles m_tg_last_cycle;
+    //replay the effect of the idle cycles skipped while sleeping
+    void catchUpIdleCycles();
+    //sleep until the next thread completion or flit generation
+    void scheduleTaskGraphWakeup();
 };
 
 #endif // __MEM_RUBY_NETWORK_GARNET2_0_NETWORKINTERFACE_HH__
@@ -34,13 +34,15 @@
 #include "mem/ruby/network/garnet2.0/NetworkLink.hh"
 
 #include "mem/ruby/network/garnet2.0/CreditLink.hh"
+#include "mem/ruby/network/garnet2.0/Router.hh"
 
 NetworkLink::NetworkLink(const Params *p)
     : ClockedObject(p), Consumer(this), m_id(p->link_id),
       m_type(NUM_LINK_TYPES_),
       m_latency(p->link_latency),
       linkBuffer(new flitBuffer()), link_consumer(nullptr),
-      link_srcQueue(nullptr), m_link_utilized(0),
+      link_srcQueue(nullptr), m_lookahead_router(nullptr),
+      m_lookahead_inport(-1), m_link_utilized(0),
       m_vc_load(p->vcs_per_vnet * p->virt_nets)
 {
 }
@@ -62,16 +64,57 @@ NetworkLink::setSourceQueue(flitBuffer *srcQueue)
     link_srcQueue = srcQueue;
 }
 
+void
+NetworkLink::setLookaheadRouter(Router *router, int inport,
+                                PortDirection inport_dirn)
+{
+    m_lookahead_router = router;
+    m_lookahead_inport = inport;
+    m_lookahead_inport_dirn = inport_dirn;
+}
+
 void
 NetworkLink::wakeup()
 {
     if (link_srcQueue->isReady(curCycle())) {
         flit *t_flit = link_srcQueue->getTopFlit();
         t_flit->set_time(curCycle() + m_latency);
-        linkBuffer->insert(t_flit);
-        link_consumer->scheduleEventAbsolute(clockEdge(m_latency));
         m_link_utilized++;
         m_vc_load[t_flit->get_vc()]++;
+        lookahead(t_flit);
+
+        // SMART: go on through the idle routers ahead, up to HPC_max
+        // links on this cycle
+        NetworkLink *link = this;
+        int hops = 1;
+        while (link->m_lookahead_router != nullptr &&
+               hops < link->m_lookahead_router->get_net_ptr()->
+                   getSmartHpcMax()) {
+            NetworkLink *next = link->m_lookahead_router->
+                smart_traverse(t_flit, link->m_lookahead_inport);
+            if (next == nullptr)
+                break;
+            link = next;
+            link->m_link_utilized++;
+            link->m_vc_load[t_flit->get_vc()]++;
+            link->lookahead(t_flit);
+            hops++;
+        }
+
+        link->linkBuffer->insert(t_flit);
+        link->link_consumer->scheduleEventAbsolute(clockEdge(m_latency));
+    }
+}
+
+void
+NetworkLink::lookahead(flit *t_flit)
+{
+    if (m_lookahead_router != nullptr &&
+        (t_flit->get_type() == HEAD_ ||
+         t_flit->get_type() == HEAD_TAIL_)) {
+        t_flit->set_lookahead_outport(
+            m_lookahead_router->route_compute(t_flit->get_route(),
+                m_lookahead_inport, m_lookahead_inport_dirn));
     }
 }
 
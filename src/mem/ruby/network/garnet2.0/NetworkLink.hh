@@ -38,12 +38,14 @@
 #include <vector>
 
 #include "mem/ruby/common/Consumer.hh"
+#include "mem/ruby/network/Topology.hh"
 #include "mem/ruby/network/garnet2.0/CommonTypes.hh"
 #include "mem/ruby/network/garnet2.0/flitBuffer.hh"
 #include "params/NetworkLink.hh"
 #include "sim/clocked_object.hh"
 
 class GarnetNetwork;
+class Router;
 
 class NetworkLink : public ClockedObject, public Consumer
 {
@@ -54,13 +56,20 @@ class NetworkLink : public ClockedObject, public Consumer
 
     void setLinkConsumer(Consumer *consumer);
     void setSourceQueue(flitBuffer *srcQueue);
+    // compute the route of the head flits at the router this link feeds
+    // while they traverse the link (lookahead routing)
+    void setLookaheadRouter(Router *router, int inport,
+                            PortDirection inport_dirn);
     void setType(link_type type) { m_type = type; }
     link_type getType() { return m_type; }
     void print(std::ostream& out) const {}
     int get_id() const { return m_id; }
+    Cycles getLatency() const { return m_latency; }
     void wakeup();
 
     unsigned int getLinkUtilization() const { return m_link_utilized; }
+    //flits the analytical network sent over the link
+    void addAnalyticalUtilization(unsigned int flits) { m_link_utilized += flits; }
     const std::vector<unsigned int> & getVcLoad() const { return m_vc_load; }
 
     inline bool isReady(Cycles curTime)
@@ -72,8 +81,11 @@ class NetworkLink : public ClockedObject, public Consumer
     uint32_t functionalWrite(Packet *);
     void resetStats();
     int getsize() {return linkBuffer->getSize(); }
+    bool isDrained() { return linkBuffer->isEmpty(); }
 
   private:
+    void lookahead(flit *t_flit);
+
     const int m_id;
     link_type m_type;
     const Cycles m_latency;
@@ -81,6 +93,9 @@ class NetworkLink : public ClockedObject, public Consumer
     flitBuffer *linkBuffer;
     Consumer *link_consumer;
     flitBuffer *link_srcQueue;
+    Router *m_lookahead_router;
+    int m_lookahead_inport;
+    PortDirection m_lookahead_inport_dirn;
 
     // Statistical variables
     unsigned int m_link_utilized;
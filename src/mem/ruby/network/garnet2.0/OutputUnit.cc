@@ -56,6 +56,10 @@ OutputUnit::OutputUnit(int id, PortDirection direction, Router *router)
     for (int i = 0; i < m_num_vcs; i++) {
         m_outvc_state.push_back(new OutVcState(i, m_router->get_net_ptr()));
     }
+    // every VC starts IDLE_
+    m_free_vcs.resize(m_num_vcs);
+    for (int i = 0; i < m_num_vcs; i++)
+        m_free_vcs.set(i);
 }
 
 OutputUnit::~OutputUnit()
@@ -96,16 +100,13 @@ OutputUnit::has_credit(int out_vc)
 
 
 // Check if the output port (i.e., input port at next router) has free VCs.
+// m_free_vcs mirrors the IDLE_ VCs, so this is a find-first-set
+// over the VCs of the vnet.
 bool
 OutputUnit::has_free_vc(int vnet)
 {
     int vc_base = vnet*m_vc_per_vnet;
-    for (int vc = vc_base; vc < vc_base + m_vc_per_vnet; vc++) {
-        if (is_vc_idle(vc, m_router->curCycle()))
-            return true;
-    }
-
-    return false;
+    return m_free_vcs.findFirstIn(vc_base, vc_base + m_vc_per_vnet) != -1;
 }
 
 // Assign a free output VC to the winner of Switch Allocation
@@ -113,33 +114,28 @@ int
 OutputUnit::select_free_vc(int vnet)
 {
     int vc_base = vnet*m_vc_per_vnet;
-    for (int vc = vc_base; vc < vc_base + m_vc_per_vnet; vc++) {
-        if (is_vc_idle(vc, m_router->curCycle())) {
-            m_outvc_state[vc]->setState(ACTIVE_, m_router->curCycle());
-            return vc;
-        }
-    }
+    int vc = m_free_vcs.findFirstIn(vc_base, vc_base + m_vc_per_vnet);
+    if (vc != -1)
+        set_vc_state(ACTIVE_, vc, m_router->curCycle());
 
-    return -1;
+    return vc;
 }
 
 //add for Ring
 
-bool
-OutputUnit::has_free_vc(int vnet, int vc_choice)
+// VCs [vc_start, vc_end) of a vnet that a flit of this vc_choice may use
+void
+OutputUnit::get_vc_choice_range(int vc_choice, int &vc_start, int &vc_end)
 {
-    int vc_base = vnet*m_vc_per_vnet;
-    int vc_start, vc_end;
-    
     if(m_vc_allocation_object != " " && m_vcs_for_allocation > 0){
-    // allocate some vcs for specific object, 4 cases: 
+    // allocate some vcs for specific object, 4 cases:
     // special low; special high; normal low; normal high
         switch(vc_choice){
             case 0:
             // special low
                 vc_start = 0;
-                vc_end = m_vc_per_vnet / 2;
                 // vc_end = m_vcs_for_allocation / 2;
+                vc_end = m_vc_per_vnet / 2;
                 break;
             case 1:
             // special high
@@ -161,18 +157,11 @@ OutputUnit::has_free_vc(int vnet, int vc_choice)
                 fatal("Vc choice error in has_free_vc()! Should in range [0, 3]!");
                 break;
         }
-
-        for (int vc = (vc_base + vc_start); vc < (vc_base + vc_end); vc++) {
-            if (is_vc_idle(vc, m_router->curCycle()))
-                return true;
-        }
-
-        return false;
     }
     else{
+    // Normal situation.
     // No special allocation. To realize deadlock-free, 2 cases:
     // low channel; high channel.
-        int vc_base = vnet*m_vc_per_vnet;
         if(vc_choice == 0){
         // low channel
             vc_start = 0;
@@ -184,84 +173,33 @@ OutputUnit::has_free_vc(int vnet, int vc_choice)
             vc_start = m_vc_per_vnet / 2;
             vc_end = m_vc_per_vnet;
         }
-        for (int vc = (vc_base + vc_start); vc < (vc_base + vc_end); vc++) {
-            if (is_vc_idle(vc, m_router->curCycle()))
-                return true;
-        }
-        return false;
     }
 }
 
+bool
+OutputUnit::has_free_vc(int vnet, int vc_choice)
+{
+    int vc_base = vnet*m_vc_per_vnet;
+    int vc_start, vc_end;
+    get_vc_choice_range(vc_choice, vc_start, vc_end);
+
+    return m_free_vcs.findFirstIn(vc_base + vc_start,
+                                  vc_base + vc_end) != -1;
+}
+
 // Assign a free output VC to the winner of Switch Allocation
 int
 OutputUnit::select_free_vc(int vnet, int vc_choice)
 {
     int vc_base = vnet*m_vc_per_vnet;
     int vc_start, vc_end;
-    
-    if(m_vc_allocation_object != " " && m_vcs_for_allocation > 0){
-    // allocate some vcs for specific object, 4 cases: 
-    // special low; special high; normal low; normal high
-        switch(vc_choice){
-            case 0:
-            // special low
-                vc_start = 0;
-                // vc_end = m_vcs_for_allocation / 2;
-                vc_end = m_vc_per_vnet / 2;
-                break;
-            case 1:
-            // special high
-                // vc_start = m_vcs_for_allocation / 2;
-                vc_start = m_vc_per_vnet / 2;
-                vc_end = m_vc_per_vnet;
-                break;
-            case 2:
-            // normal low
-                vc_start = m_vcs_for_allocation;
-                vc_end = (m_vcs_for_allocation + m_vc_per_vnet) / 2;
-                break;
-            case 3:
-            // normal high
-                vc_start = (m_vcs_for_allocation + m_vc_per_vnet) / 2;
-                vc_end = m_vc_per_vnet;
-                break;
-            default:
-                fatal("Vc choice error in has_free_vc()! Should in range [0, 3]!");
-                break;
-        }
-        for (int vc = (vc_base + vc_start); vc < (vc_base + vc_end); vc++) {
-            if (is_vc_idle(vc, m_router->curCycle())) {
-                m_outvc_state[vc]->setState(ACTIVE_, m_router->curCycle());
-                return vc;
-            }
-        }
+    get_vc_choice_range(vc_choice, vc_start, vc_end);
 
-        return -1;
-    }
-    else{
-    // Normal situation.
-    // No special allocation. To realize deadlock-free, 2 cases:
-    // low channel; high channel.
-        int vc_base = vnet*m_vc_per_vnet;
-        if(vc_choice == 0){
-        // low channel
-            vc_start = 0;
-            vc_end = m_vc_per_vnet / 2;
-        }
-        else{
-        // high channel
-            assert(vc_choice == 1);
-            vc_start = m_vc_per_vnet / 2;
-            vc_end = m_vc_per_vnet;
-        }
-        for (int vc = (vc_base + vc_start); vc < (vc_base + vc_end); vc++) {
-            if (is_vc_idle(vc, m_router->curCycle())){
-                m_outvc_state[vc]->setState(ACTIVE_, m_router->curCycle());
-                return vc;
-            }
-        }
-        return -1;
-    }   
+    int vc = m_free_vcs.findFirstIn(vc_base + vc_start, vc_base + vc_end);
+    if (vc != -1)
+        set_vc_state(ACTIVE_, vc, m_router->curCycle());
+
+    return vc;
 }
 
 // bool
@@ -38,6 +38,7 @@
 #include <vector>
 
 #include "mem/ruby/common/Consumer.hh"
+#include "mem/ruby/network/garnet2.0/BitMask.hh"
 #include "mem/ruby/network/garnet2.0/CommonTypes.hh"
 #include "mem/ruby/network/garnet2.0/CreditLink.hh"
 #include "mem/ruby/network/garnet2.0/NetworkLink.hh"
@@ -73,16 +74,41 @@ class OutputUnit : public Consumer
         return m_outvc_state[vc]->get_credit_count();
     }
 
+    // free buffers left downstream over the VCs of vnet
+    int
+    get_vnet_credits(int vnet)
+    {
+        int credits = 0;
+        for (int vc = vnet * m_vc_per_vnet;
+             vc < (vnet + 1) * m_vc_per_vnet; vc++)
+            credits += m_outvc_state[vc]->get_credit_count();
+        return credits;
+    }
+
     inline int
     get_outlink_id()
     {
         return m_out_link->get_id();
     }
 
+    NetworkLink *get_out_link() { return m_out_link; }
+
+    // nothing left for the link and every downstream VC freed, which
+    // also means all its credits are back
+    inline bool
+    isDrained()
+    {
+        return m_out_buffer->isEmpty() && m_free_vcs.count() == m_num_vcs;
+    }
+
     inline void
     set_vc_state(VC_state_type state, int vc, Cycles curTime)
     {
       m_outvc_state[vc]->setState(state, curTime);
+      if (state == IDLE_)
+          m_free_vcs.set(vc);
+      else
+          m_free_vcs.clear(vc);
     }
 
     inline bool
@@ -95,12 +121,15 @@ class OutputUnit : public Consumer
     insert_flit(flit *t_flit)
     {
         m_out_buffer->insert(t_flit);
-        m_out_link->scheduleEventAbsolute(m_router->clockEdge(Cycles(1)));
+        m_router->schedule_consumer(m_out_link,
+                                    m_router->clockEdge(Cycles(1)));
     }
 
     uint32_t functionalWrite(Packet *pkt);
 
   private:
+    void get_vc_choice_range(int vc_choice, int &vc_start, int &vc_end);
+
     int m_id;
     PortDirection m_direction;
     int m_num_vcs;
@@ -113,6 +142,7 @@ class OutputUnit : public Consumer
 
     flitBuffer *m_out_buffer; // This is for the network link to consume
     std::vector<OutVcState *> m_outvc_state; // vc state of downstream router
+    BitMask m_free_vcs; // the IDLE_ VCs of m_outvc_state
 
 };
 
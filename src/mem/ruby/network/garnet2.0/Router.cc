@@ -56,6 +56,7 @@ Router::Router(const Params *p)
     m_vcs_for_allocation = p ->vcs_for_allocation;
     m_vc_allocation_object = p->vc_allocation_object;
     m_num_vcs = m_virtual_networks * m_vc_per_vnet;
+    m_defer_wakeups = false;
 
     m_routing_unit = new RoutingUnit(this);
     m_sw_alloc = new SwitchAllocator(this);
@@ -81,10 +82,27 @@ Router::init()
 
     m_sw_alloc->init();
     m_switch->init();
+
+    m_smart_free.assign(m_output_unit.size(), Cycles(0));
 }
 
 void
 Router::wakeup()
+{
+    // with --garnet-router-threads the network evaluates all the routers
+    // of this cycle together, after the links of the cycle. SMART and the
+    // bypass look at the routers from the links, so they go the same way
+    // for their results not to depend on the number of threads
+    if (m_network_ptr->isRouterEvaluationBatched()) {
+        m_network_ptr->scheduleRouterEvaluation(this);
+        return;
+    }
+
+    evaluate();
+}
+
+void
+Router::evaluate()
 {
     DPRINTF(RubyNetwork, "Router %d woke up\n", m_id);
 
@@ -161,22 +179,185 @@ Router::getInportDirection(int inport)
 }
 
 int
-Router::route_compute(RouteInfo route, int inport, PortDirection inport_dirn)
+Router::route_compute(const RouteInfo &route, int inport,
+                      PortDirection inport_dirn)
 {
     return m_routing_unit->outportCompute(route, inport, inport_dirn);
 }
 
+int
+Router::vc_choice(const RouteInfo &route, int outport)
+{
+    return m_routing_unit->vcChoice(route, outport);
+}
+
+void
+Router::compileRoutingTable(int num_nis, uint32_t seed)
+{
+    m_routing_unit->compileRoutingTable(num_nis, seed);
+}
+
 void
 Router::grant_switch(int inport, flit *t_flit)
 {
     m_switch->update_sw_winner(inport, t_flit);
 }
 
+/*
+ * With --router-bypass a flit that just arrived goes for SA on the same
+ * cycle if it is sure to win it: it is the only flit of its input port,
+ * no other flit of the router waits for its output port and it could be
+ * sent (free output VC or credit, see SwitchAllocator::send_allowed).
+ */
+bool
+Router::can_bypass(int inport, int invc)
+{
+    InputUnit *input_unit = m_input_unit[inport];
+    if (input_unit->get_occupied_vcs().count() != 1 ||
+        input_unit->get_num_flits(invc) != 1)
+        return false;
+
+    int outport = input_unit->get_outport(invc);
+    for (int i = 0; i < m_input_unit.size(); i++) {
+        if (i == inport)
+            continue;
+        const BitMask &occupied = m_input_unit[i]->get_occupied_vcs();
+        for (int vc = occupied.findFirstIn(0, m_num_vcs); vc != -1;
+             vc = occupied.findFirstIn(vc + 1, m_num_vcs)) {
+            if (m_input_unit[i]->get_outport(vc) == outport)
+                return false;
+        }
+    }
+
+    return m_sw_alloc->send_allowed(inport, invc, outport,
+                                    input_unit->get_outvc(invc));
+}
+
+/*
+ * SMART (--smart-hpc-max): a flit coming in on inport on this cycle goes
+ * through without stopping if it goes straight on, this is not its
+ * destination and the router is idle: no flit in the input units, none
+ * arriving on the input links and none waiting for the output link.
+ * The flits of the router thus always win over the passing ones (the
+ * Prio=Local setup arbitration), and one output port carries one SMART
+ * flit a cycle. The input VC is allocated and released on the spot, its
+ * credit goes back upstream as if the flit had been buffered. Returns the
+ * output link the flit goes on with, NULL if it has to stop here.
+ */
+NetworkLink *
+Router::smart_traverse(flit *t_flit, int inport)
+{
+    Cycles curTime = curCycle();
+    InputUnit *input_unit = m_input_unit[inport];
+    int invc = t_flit->get_vc();
+    bool head = (t_flit->get_type() == HEAD_ ||
+                 t_flit->get_type() == HEAD_TAIL_);
+    bool tail = (t_flit->get_type() == TAIL_ ||
+                 t_flit->get_type() == HEAD_TAIL_);
+
+    int outport;
+    if (head) {
+        if (t_flit->get_route().dest_router == m_id ||
+            t_flit->get_lookahead_outport() == -1)
+            return NULL;
+        outport = t_flit->get_lookahead_outport();
+    } else {
+        // the head went through or is still here
+        if (!input_unit->get_occupied_vcs().none())
+            return NULL;
+        outport = input_unit->get_outport(invc);
+    }
+
+    PortDirection in_dirn = getInportDirection(inport);
+    PortDirection out_dirn = getOutportDirection(outport);
+    bool straight = (in_dirn == "West" && out_dirn == "East") ||
+                    (in_dirn == "East" && out_dirn == "West") ||
+                    (in_dirn == "North" && out_dirn == "South") ||
+                    (in_dirn == "South" && out_dirn == "North");
+    if (!straight || m_smart_free[outport] > curTime ||
+        !m_output_unit[outport]->getOutQueue()->isEmpty())
+        return NULL;
+
+    for (int i = 0; i < m_input_unit.size(); i++) {
+        if (!m_input_unit[i]->get_occupied_vcs().none() ||
+            m_input_unit[i]->has_incoming_flit(curTime))
+            return NULL;
+    }
+
+    OutputUnit *output_unit = m_output_unit[outport];
+    int outvc;
+    if (head) {
+        int vnet = invc / m_vc_per_vnet;
+        int vc_ch = vc_choice(t_flit->get_route(), outport);
+        bool ring = m_sw_alloc->is_ring();
+        if (ring ? !output_unit->has_free_vc(vnet, vc_ch) :
+                   !output_unit->has_free_vc(vnet))
+            return NULL;
+        outvc = ring ? output_unit->select_free_vc(vnet, vc_ch) :
+                       output_unit->select_free_vc(vnet);
+        input_unit->set_vc_active(invc, curTime);
+        input_unit->grant_outport(invc, outport);
+        input_unit->grant_outvc(invc, outvc);
+    } else {
+        outvc = input_unit->get_outvc(invc);
+        if (!output_unit->has_credit(outvc))
+            return NULL;
+    }
+
+    output_unit->decrement_credit(outvc);
+    if (tail)
+        input_unit->set_vc_idle(invc, curTime);
+    input_unit->increment_credit(invc, tail, curTime);
+    m_smart_free[outport] = Cycles(curTime + 1);
+
+    t_flit->set_vc(outvc);
+    t_flit->set_outport(outport);
+    t_flit->set_lookahead_outport(-1);
+    t_flit->increment_hops();
+    t_flit->increment_smart_hops();
+    m_smart_flits++;
+
+    return output_unit->get_out_link();
+}
+
 void
 Router::schedule_wakeup(Cycles time)
 {
     // wake up after time cycles
-    scheduleEvent(time);
+    schedule_consumer(this, clockEdge(time));
+}
+
+bool
+Router::isDrained()
+{
+    for (int inport = 0; inport < m_input_unit.size(); inport++) {
+        if (!m_input_unit[inport]->isDrained())
+            return false;
+    }
+    for (int outport = 0; outport < m_output_unit.size(); outport++) {
+        if (!m_output_unit[outport]->isDrained())
+            return false;
+    }
+    return m_switch->isDrained();
+}
+
+void
+Router::schedule_consumer(Consumer *consumer, Tick time)
+{
+    if (m_defer_wakeups)
+        m_deferred_wakeups.push_back(std::make_pair(consumer, time));
+    else
+        consumer->scheduleEventAbsolute(time);
+}
+
+void
+Router::flush_wakeups()
+{
+    m_defer_wakeups = false;
+    for (int i = 0; i < m_deferred_wakeups.size(); i++)
+        m_deferred_wakeups[i].first->scheduleEventAbsolute(
+            m_deferred_wakeups[i].second);
+    m_deferred_wakeups.clear();
 }
 
 std::string
@@ -218,6 +399,18 @@ Router::regStats()
         .name(name() + ".sw_output_arbiter_activity")
         .flags(Stats::nozero)
     ;
+
+    m_smart_flits
+        .name(name() + ".smart_flits")
+        .desc("flits that went through the router without stopping")
+        .flags(Stats::nozero)
+    ;
+
+    m_bypassed_flits
+        .name(name() + ".bypassed_flits")
+        .desc("flits that went through the router on their arrival cycle")
+        .flags(Stats::nozero)
+    ;
 }
 
 void
@@ -233,6 +426,10 @@ Router::collateStats()
     m_sw_input_arbiter_activity = m_sw_alloc->get_input_arbiter_activity();
     m_sw_output_arbiter_activity = m_sw_alloc->get_output_arbiter_activity();
     m_crossbar_activity = m_switch->get_crossbar_activity();
+
+    m_bypassed_flits = 0;
+    for (int i = 0; i < m_input_unit.size(); i++)
+        m_bypassed_flits += m_input_unit[i]->get_bypass_count();
 }
 
 void
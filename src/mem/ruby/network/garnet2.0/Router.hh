@@ -63,6 +63,8 @@ class Router : public BasicRouter, public Consumer
     ~Router();
 
     void wakeup();
+    // one router cycle: input units, credits, SA and switch traversal
+    void evaluate();
     void print(std::ostream& out) const {};
 
     void init();
@@ -93,9 +95,21 @@ class Router : public BasicRouter, public Consumer
     PortDirection getOutportDirection(int outport);
     PortDirection getInportDirection(int inport);
 
-    int route_compute(RouteInfo route, int inport, PortDirection direction);
+    int route_compute(const RouteInfo &route, int inport,
+                      PortDirection direction);
+    int vc_choice(const RouteInfo &route, int outport);
+    void compileRoutingTable(int num_nis, uint32_t seed);
     void grant_switch(int inport, flit *t_flit);
+    bool can_bypass(int inport, int invc);
+    NetworkLink *smart_traverse(flit *t_flit, int inport);
     void schedule_wakeup(Cycles time);
+    // no flit or credit left anywhere in the router
+    bool isDrained();
+    // wake up a consumer (this router or one of its links) at time,
+    // deferred to flush_wakeups() while the network evaluates the router
+    void schedule_consumer(Consumer *consumer, Tick time);
+    void defer_wakeups() { m_defer_wakeups = true; }
+    void flush_wakeups();
 
     std::string getPortDirectionName(PortDirection direction);
     void printFaultVector(std::ostream& out);
@@ -130,6 +144,12 @@ class Router : public BasicRouter, public Consumer
     SwitchAllocator *m_sw_alloc;
     CrossbarSwitch *m_switch;
 
+    // first cycle an output port is free again after a SMART traversal
+    std::vector<Cycles> m_smart_free;
+
+    bool m_defer_wakeups;
+    std::vector<std::pair<Consumer *, Tick> > m_deferred_wakeups;
+
     // Statistical variables required for power computations
     Stats::Scalar m_buffer_reads;
     Stats::Scalar m_buffer_writes;
@@ -138,6 +158,8 @@ class Router : public BasicRouter, public Consumer
     Stats::Scalar m_sw_output_arbiter_activity;
 
     Stats::Scalar m_crossbar_activity;
+    Stats::Scalar m_bypassed_flits;
+    Stats::Scalar m_smart_flits;
 };
 
 #endif // __MEM_RUBY_NETWORK_GARNET2_0_ROUTER_HH__
@@ -0,0 +1,60 @@
+#include "mem/ruby/network/garnet2.0/RouterThreadPool.hh"
+
+#include <cassert>
+
+#include "mem/ruby/network/garnet2.0/Router.hh"
+
+RouterThreadPool::RouterThreadPool(int num_threads)
+    : m_num_threads(num_threads), m_start(num_threads),
+      m_done(num_threads), m_stop(false), m_routers(NULL), m_next(0)
+{
+    assert(num_threads > 1);
+    for (int i = 1; i < m_num_threads; i++)
+        m_threads.push_back(std::thread(&RouterThreadPool::worker, this));
+}
+
+RouterThreadPool::~RouterThreadPool()
+{
+    m_stop = true;
+    m_start.wait();
+    for (int i = 0; i < m_threads.size(); i++)
+        m_threads[i].join();
+}
+
+void
+RouterThreadPool::run(const std::vector<Router *> &routers)
+{
+    //waking the workers costs more than a few routers
+    if (routers.size() < m_num_threads) {
+        for (int i = 0; i < routers.size(); i++)
+            routers[i]->evaluate();
+        return;
+    }
+
+    m_routers = &routers;
+    m_next = 0;
+    m_start.wait();
+    evaluate();
+    m_done.wait();
+    m_routers = NULL;
+}
+
+void
+RouterThreadPool::worker()
+{
+    while (true) {
+        m_start.wait();
+        if (m_stop)
+            return;
+        evaluate();
+        m_done.wait();
+    }
+}
+
+void
+RouterThreadPool::evaluate()
+{
+    const std::vector<Router *> &routers = *m_routers;
+    for (int i = m_next++; i < routers.size(); i = m_next++)
+        routers[i]->evaluate();
+}
@@ -0,0 +1,45 @@
+#ifndef __MEM_RUBY_NETWORK_GARNET2_0_ROUTER_THREAD_POOL_HH__
+#define __MEM_RUBY_NETWORK_GARNET2_0_ROUTER_THREAD_POOL_HH__
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "base/barrier.hh"
+
+class Router;
+
+// Host threads evaluating the routers woken up on one clock edge. The
+// routers of a cycle only talk to each other through links and credit
+// links of at least one cycle, so they can be evaluated in any order and
+// on any thread without changing the results. The caller evaluates
+// routers too, num_threads counts it.
+class RouterThreadPool
+{
+  public:
+    RouterThreadPool(int num_threads);
+    ~RouterThreadPool();
+
+    int getNumThreads() const { return m_num_threads; }
+
+    // evaluate every router of the list, returns once they all are done
+    void run(const std::vector<Router *> &routers);
+
+  private:
+    RouterThreadPool(const RouterThreadPool& obj);
+    RouterThreadPool& operator=(const RouterThreadPool& obj);
+
+    void worker();
+    void evaluate();
+
+    int m_num_threads;
+    std::vector<std::thread> m_threads;
+    Barrier m_start;
+    Barrier m_done;
+    bool m_stop;
+    const std::vector<Router *> *m_routers;
+    //next router of m_routers to evaluate
+    std::atomic<int> m_next;
+};
+
+#endif // __MEM_RUBY_NETWORK_GARNET2_0_ROUTER_THREAD_POOL_HH__
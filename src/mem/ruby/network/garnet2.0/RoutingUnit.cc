@@ -36,6 +36,7 @@
 #include "base/cast.hh"
 #include "base/logging.hh"
 #include "mem/ruby/network/garnet2.0/InputUnit.hh"
+#include "mem/ruby/network/garnet2.0/OutputUnit.hh"
 #include "mem/ruby/network/garnet2.0/Router.hh"
 #include "mem/ruby/slicc_interface/Message.hh"
 
@@ -65,57 +66,58 @@ RoutingUnit::addWeight(int link_weight)
  * Correct weight assignments are critical to provide deadlock avoidance.
  */
 
-int
-RoutingUnit::lookupRoutingTable(int vnet, NetDest msg_destination)
+void
+RoutingUnit::compileRoutingTable(int num_nis, uint32_t seed)
 {
-    // First find all possible output link candidates
-    // For ordered vnet, just choose the first
-    // (to make sure different packets don't choose different routes)
-    // For unordered vnet, randomly choose any of the links
-    // To have a strict ordering between links, they should be given
-    // different weights in the topology file
-
-    int output_link = -1;
-    int min_weight = INFINITE_;
-    std::vector<int> output_link_candidates;
-    int num_candidates = 0;
-
-    // Identify the minimum weight among the candidate output links
-    for (int link = 0; link < m_routing_table.size(); link++) {
-        if (msg_destination.intersectionIsNotEmpty(m_routing_table[link])) {
-
-        if (m_weight_table[link] <= min_weight)
-            min_weight = m_weight_table[link];
-        }
-    }
+    GarnetNetwork *net_ptr = m_router->get_net_ptr();
 
-    // Collect all candidate output links with this minimum weight
-    for (int link = 0; link < m_routing_table.size(); link++) {
-        if (msg_destination.intersectionIsNotEmpty(m_routing_table[link])) {
+    m_dest_offset.assign(num_nis + 1, 0);
+    m_dest_outports.clear();
 
-            if (m_weight_table[link] == min_weight) {
+    for (int ni = 0; ni < num_nis; ni++) {
+        const NetDest &msg_destination = net_ptr->getNetDest(ni);
+        int min_weight = INFINITE_;
 
-                num_candidates++;
-                output_link_candidates.push_back(link);
-            }
+        for (int link = 0; link < m_routing_table.size(); link++) {
+            if (msg_destination.intersectionIsNotEmpty(m_routing_table[link])
+                && m_weight_table[link] < min_weight)
+                min_weight = m_weight_table[link];
+        }
+
+        // same order as the table, ordered vnets take the first one
+        m_dest_offset[ni] = m_dest_outports.size();
+        for (int link = 0; link < m_routing_table.size(); link++) {
+            if (m_weight_table[link] == min_weight &&
+                msg_destination.intersectionIsNotEmpty(m_routing_table[link]))
+                m_dest_outports.push_back(link);
         }
     }
+    m_dest_offset[num_nis] = m_dest_outports.size();
+
+    m_rng.init(seed ^ (m_router->get_id() * 0x9e3779b9U));
+}
 
-    if (output_link_candidates.size() == 0) {
+int
+RoutingUnit::lookupRoutingTable(int vnet, int dest_ni)
+{
+    assert(dest_ni >= 0 && dest_ni + 1 < m_dest_offset.size());
+    int first = m_dest_offset[dest_ni];
+    int num_candidates = m_dest_offset[dest_ni + 1] - first;
+
+    if (num_candidates == 0) {
         fatal("Fatal Error:: No Route exists from this Router.");
         exit(0);
     }
 
     // Randomly select any candidate output link
     int candidate = 0;
-    if (!(m_router->get_net_ptr())->isVNetOrdered(vnet))
-        candidate = rand() % num_candidates;
+    if (num_candidates > 1 &&
+        !(m_router->get_net_ptr())->isVNetOrdered(vnet))
+        candidate = m_rng.random<int>(0, num_candidates - 1);
 
-    output_link = output_link_candidates.at(candidate);
-    return output_link;
+    return m_dest_outports[first + candidate];
 }
 
-
 void
 RoutingUnit::addInDirection(PortDirection inport_dirn, int inport_idx)
 {
@@ -137,7 +139,7 @@ RoutingUnit::addOutDirection(PortDirection outport_dirn, int outport_idx)
 // table is provided here.
 
 int
-RoutingUnit::outportCompute(RouteInfo route, int inport,
+RoutingUnit::outportCompute(const RouteInfo &route, int inport,
                             PortDirection inport_dirn)
 {
     int outport = -1;
@@ -147,7 +149,7 @@ RoutingUnit::outportCompute(RouteInfo route, int inport,
         // Multiple NIs may be connected to this router,
         // all with output port direction = "Local"
         // Get exact outport id from table
-        outport = lookupRoutingTable(route.vnet, route.net_dest);
+        outport = lookupRoutingTable(route.vnet, route.dest_ni);
         return outport;
     }
 
@@ -158,14 +160,20 @@ RoutingUnit::outportCompute(RouteInfo route, int inport,
 
     switch (routing_algorithm) {
         case TABLE_:  outport =
-            lookupRoutingTable(route.vnet, route.net_dest); break;
+            lookupRoutingTable(route.vnet, route.dest_ni); break;
         case XY_:     outport =
             outportComputeXY(route, inport, inport_dirn); break;
         // any custom algorithm
         case CUSTOM_: outport =
             outportComputeCustom(route, inport, inport_dirn); break;
+        case WEST_FIRST_: outport =
+            outportComputeWestFirst(route, inport, inport_dirn); break;
+        case ODD_EVEN_: outport =
+            outportComputeOddEven(route, inport, inport_dirn); break;
+        case RING_: outport =
+            outportComputeRing(route, inport, inport_dirn); break;
         default: outport =
-            lookupRoutingTable(route.vnet, route.net_dest); break;
+            lookupRoutingTable(route.vnet, route.dest_ni); break;
     }
 
     assert(outport != -1);
@@ -176,7 +184,7 @@ RoutingUnit::outportCompute(RouteInfo route, int inport,
 // Only for reference purpose in a Mesh
 // By default Garnet uses the routing table
 int
-RoutingUnit::outportComputeXY(RouteInfo route,
+RoutingUnit::outportComputeXY(const RouteInfo &route,
                               int inport,
                               PortDirection inport_dirn)
 {
@@ -235,7 +243,7 @@ RoutingUnit::outportComputeXY(RouteInfo route,
 // using port directions. (Example adaptive)
 // add the algorithm for deadlock-free Ring
 int
-RoutingUnit::outportComputeCustom(RouteInfo route,
+RoutingUnit::outportComputeCustom(const RouteInfo &route,
                                  int inport,
                                  PortDirection inport_dirn)     //made for ring
 {
@@ -267,3 +275,152 @@ RoutingUnit::outportComputeCustom(RouteInfo route,
 
     //panic("%s placeholder executed", __FUNCTION__);       //originally there is only this one line
 }
+
+// Downstream credits of the vnet summed over the output VCs, the most
+// free buffers wins, ties go to the first direction. Ordered vnets never
+// get more than one direction.
+int
+RoutingUnit::selectLeastCongested(const std::vector<PortDirection> &dirns,
+                                  int vnet)
+{
+    assert(!dirns.empty());
+    int best_outport = -1;
+    int best_credits = -1;
+    for (int i = 0; i < dirns.size(); i++) {
+        int outport = m_outports_dirn2idx[dirns[i]];
+        int credits =
+            m_router->get_outputUnit_ref()[outport]->get_vnet_credits(vnet);
+        if (credits > best_credits) {
+            best_outport = outport;
+            best_credits = credits;
+        }
+    }
+    return best_outport;
+}
+
+// West-first turn model: a packet going West goes West first, any other
+// packet may take any productive direction. No turn into West, so no
+// cycle of channel dependencies.
+int
+RoutingUnit::outportComputeWestFirst(const RouteInfo &route,
+                                     int inport,
+                                     PortDirection inport_dirn)
+{
+    int num_cols = m_router->get_net_ptr()->getNumCols();
+    assert(num_cols > 0);
+
+    int my_id = m_router->get_id();
+    int x_hops = route.dest_router % num_cols - my_id % num_cols;
+    int y_hops = route.dest_router / num_cols - my_id / num_cols;
+    assert(!(x_hops == 0 && y_hops == 0));
+
+    std::vector<PortDirection> dirns;
+    if (x_hops < 0) {
+        dirns.push_back("West");
+    } else {
+        if (x_hops > 0)
+            dirns.push_back("East");
+        if (y_hops > 0)
+            dirns.push_back("North");
+        else if (y_hops < 0)
+            dirns.push_back("South");
+    }
+
+    if (m_router->get_net_ptr()->isVNetOrdered(route.vnet))
+        return m_outports_dirn2idx[dirns[0]];
+    return selectLeastCongested(dirns, route.vnet);
+}
+
+// Odd-even turn model (Chiu): no East->North/South turn in the even
+// columns and no North/South->West turn in the odd ones, which leaves
+// more adaptivity than west-first and spreads it over both directions.
+int
+RoutingUnit::outportComputeOddEven(const RouteInfo &route,
+                                   int inport,
+                                   PortDirection inport_dirn)
+{
+    int num_cols = m_router->get_net_ptr()->getNumCols();
+    assert(num_cols > 0);
+
+    int my_id = m_router->get_id();
+    int my_x = my_id % num_cols;
+    int src_x = route.src_router % num_cols;
+    int dest_x = route.dest_router % num_cols;
+    int x_hops = dest_x - my_x;
+    int y_hops = route.dest_router / num_cols - my_id / num_cols;
+    assert(!(x_hops == 0 && y_hops == 0));
+
+    PortDirection y_dirn = (y_hops > 0) ? "North" : "South";
+    std::vector<PortDirection> dirns;
+    if (x_hops == 0) {
+        dirns.push_back(y_dirn);
+    } else if (x_hops > 0) {
+        if (y_hops == 0) {
+            dirns.push_back("East");
+        } else {
+            if (my_x % 2 == 1 || my_x == src_x)
+                dirns.push_back(y_dirn);
+            if (dest_x % 2 == 1 || x_hops != 1)
+                dirns.push_back("East");
+        }
+    } else {
+        dirns.push_back("West");
+        if (y_hops != 0 && my_x % 2 == 0)
+            dirns.push_back(y_dirn);
+    }
+
+    if (m_router->get_net_ptr()->isVNetOrdered(route.vnet))
+        return m_outports_dirn2idx[dirns[0]];
+    return selectLeastCongested(dirns, route.vnet);
+}
+
+// Shortest direction on a Ring, when both ways are as long the less
+// congested one is taken. Deadlock freedom comes from the dateline VCs,
+// see vcChoice().
+int
+RoutingUnit::outportComputeRing(const RouteInfo &route,
+                                int inport,
+                                PortDirection inport_dirn)
+{
+    int num_routers = m_router->get_net_ptr()->getNumRouters();
+    assert(num_routers > 0);
+
+    int my_id = m_router->get_id();
+    int east_hops = (route.dest_router - my_id + num_routers) % num_routers;
+    int west_hops = num_routers - east_hops;
+    assert(east_hops != 0);
+
+    std::vector<PortDirection> dirns;
+    if (east_hops <= west_hops)
+        dirns.push_back("East");
+    if (west_hops <= east_hops)
+        dirns.push_back("West");
+
+    if (m_router->get_net_ptr()->isVNetOrdered(route.vnet))
+        return m_outports_dirn2idx[dirns[0]];
+    return selectLeastCongested(dirns, route.vnet);
+}
+
+// With RING_ routing the flits take the low VCs of a direction until
+// they cross its dateline, the East link of the last router or the West
+// link of router 0, and the high VCs from there on. The special/normal
+// classes of --vc-allocation-object are kept.
+int
+RoutingUnit::vcChoice(const RouteInfo &route, int outport)
+{
+    if (m_router->get_net_ptr()->getRoutingAlgorithm() != RING_)
+        return route.vc_choice;
+
+    int num_routers = m_router->get_net_ptr()->getNumRouters();
+    int my_id = m_router->get_id();
+    PortDirection outport_dirn = m_router->getOutportDirection(outport);
+    bool crossed;
+    if (outport_dirn == "East")
+        crossed = (my_id < route.src_router) || (my_id == num_routers - 1);
+    else if (outport_dirn == "West")
+        crossed = (my_id > route.src_router) || (my_id == 0);
+    else
+        return route.vc_choice;
+
+    return (route.vc_choice & 2) | crossed;
+}
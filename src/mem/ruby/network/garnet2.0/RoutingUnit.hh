@@ -34,6 +34,7 @@
 #ifndef __MEM_RUBY_NETWORK_GARNET2_0_ROUTINGUNIT_HH__
 #define __MEM_RUBY_NETWORK_GARNET2_0_ROUTINGUNIT_HH__
 
+#include "base/random.hh"
 #include "mem/ruby/common/Consumer.hh"
 #include "mem/ruby/common/NetDest.hh"
 #include "mem/ruby/network/garnet2.0/CommonTypes.hh"
@@ -47,7 +48,7 @@ class RoutingUnit
 {
   public:
     RoutingUnit(Router *router);
-    int outportCompute(RouteInfo route,
+    int outportCompute(const RouteInfo &route,
                       int inport,
                       PortDirection inport_dirn);
 
@@ -55,30 +56,61 @@ class RoutingUnit
     void addRoute(const NetDest& routing_table_entry);
     void addWeight(int link_weight);
 
-    // get output port from routing table
-    int  lookupRoutingTable(int vnet, NetDest net_dest);
+    // Compile the routing table into the minimal weight outports towards
+    // every destination NI, once all the links are added. The ties are
+    // broken by a random stream of the router, seeded from seed.
+    void compileRoutingTable(int num_nis, uint32_t seed);
+    // get output port from the compiled table
+    int  lookupRoutingTable(int vnet, int dest_ni);
 
     // Topology-specific direction based routing
     void addInDirection(PortDirection inport_dirn, int inport);
     void addOutDirection(PortDirection outport_dirn, int outport);
 
     // Routing for Mesh
-    int outportComputeXY(RouteInfo route,
+    int outportComputeXY(const RouteInfo &route,
                          int inport,
                          PortDirection inport_dirn);
 
+    // Minimal adaptive routing for Mesh, among the directions the turn
+    // model allows the one with the most downstream credits is taken
+    int outportComputeWestFirst(const RouteInfo &route,
+                                int inport,
+                                PortDirection inport_dirn);
+    int outportComputeOddEven(const RouteInfo &route,
+                              int inport,
+                              PortDirection inport_dirn);
+
     // Custom Routing Algorithm using Port Directions
-    int outportComputeCustom(RouteInfo route,
+    int outportComputeCustom(const RouteInfo &route,
                              int inport,
                              PortDirection inport_dirn);
 
+    // Shortest direction routing for Ring with dateline VCs
+    int outportComputeRing(const RouteInfo &route,
+                           int inport,
+                           PortDirection inport_dirn);
+
+    // VC class (see OutputUnit::has_free_vc(vnet, vc_choice)) a flit
+    // takes on outport
+    int vcChoice(const RouteInfo &route, int outport);
+
   private:
+    int selectLeastCongested(const std::vector<PortDirection> &dirns,
+                             int vnet);
+
     Router *m_router;
 
     // Routing Table
     std::vector<NetDest> m_routing_table;
     std::vector<int> m_weight_table;
 
+    // Compiled routing table, the candidate outports towards NI i are
+    // m_dest_outports[m_dest_offset[i]] up to m_dest_offset[i + 1]
+    std::vector<int> m_dest_offset;
+    std::vector<int> m_dest_outports;
+    Random m_rng;
+
     // Inport and Outport direction to idx maps
     std::map<PortDirection, int> m_inports_dirn2idx;
     std::map<int, PortDirection> m_inports_idx2dirn;
@@ -0,0 +1,87 @@
+#include "mem/ruby/network/garnet2.0/SlabPool.hh"
+
+#include <algorithm>
+#include <cassert>
+
+SlabPool::SlabPool(size_t obj_size, int objs_per_slab)
+    : m_objs_per_slab(objs_per_slab), m_free_list(NULL), m_live(0),
+      m_peak_live(0), m_thread_safe(false), m_peak_held(false)
+{
+    assert(objs_per_slab > 0);
+    //room for the free list link, aligned for any member
+    const size_t align = alignof(std::max_align_t);
+    m_obj_size = std::max(obj_size, sizeof(FreeSlot));
+    m_obj_size = (m_obj_size + align - 1) / align * align;
+}
+
+SlabPool::~SlabPool()
+{
+    for (int i = 0; i < m_slabs.size(); i++)
+        ::operator delete(m_slabs[i]);
+}
+
+void
+SlabPool::grow()
+{
+    char *slab = (char *)::operator new(m_obj_size * m_objs_per_slab);
+    m_slabs.push_back(slab);
+    //hand out the slab from its start
+    for (int i = m_objs_per_slab - 1; i >= 0; i--) {
+        FreeSlot *slot = (FreeSlot *)(slab + i * m_obj_size);
+        slot->next = m_free_list;
+        m_free_list = slot;
+    }
+}
+
+void *
+SlabPool::alloc()
+{
+    if (m_thread_safe) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return allocLocked();
+    }
+    return allocLocked();
+}
+
+void
+SlabPool::free(void *p)
+{
+    if (m_thread_safe) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        freeLocked(p);
+    } else {
+        freeLocked(p);
+    }
+}
+
+void *
+SlabPool::allocLocked()
+{
+    if (m_free_list == NULL)
+        grow();
+    FreeSlot *slot = m_free_list;
+    m_free_list = slot->next;
+    m_live++;
+    if (!m_peak_held)
+        m_peak_live = std::max(m_peak_live, m_live);
+    return slot;
+}
+
+void
+SlabPool::releasePeak()
+{
+    m_peak_held = false;
+    m_peak_live = std::max(m_peak_live, m_live);
+}
+
+void
+SlabPool::freeLocked(void *p)
+{
+    if (p == NULL)
+        return;
+    assert(m_live > 0);
+    FreeSlot *slot = (FreeSlot *)p;
+    slot->next = m_free_list;
+    m_free_list = slot;
+    m_live--;
+}
@@ -0,0 +1,59 @@
+#ifndef __MEM_RUBY_NETWORK_GARNET2_0_SLAB_POOL_HH__
+#define __MEM_RUBY_NETWORK_GARNET2_0_SLAB_POOL_HH__
+
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+// Objects of one size carved out of large slabs and recycled through a
+// free list, for the objects garnet creates and destroys on every hop
+// (flits, credits, generator buffer entries). The slabs go back to the
+// heap only with the pool.
+class SlabPool
+{
+  public:
+    SlabPool(size_t obj_size, int objs_per_slab = 256);
+    ~SlabPool();
+
+    void *alloc();
+    void free(void *p);
+    // lock the free list, for objects created and destroyed by the
+    // routers evaluated on several threads
+    void setThreadSafe(bool thread_safe) { m_thread_safe = thread_safe; }
+    // while held, the peak is not raised by every allocation but by the
+    // live count once released: the peak then does not depend on how the
+    // threads holding it interleave their allocations and frees
+    void holdPeak() { m_peak_held = true; }
+    void releasePeak();
+
+    size_t getObjectSize() const { return m_obj_size; }
+    //objects handed out and not freed yet, now and at most
+    int getLive() const { return m_live; }
+    int getPeakLive() const { return m_peak_live; }
+    int getCapacity() const { return m_slabs.size() * m_objs_per_slab; }
+
+  private:
+    SlabPool(const SlabPool& obj);
+    SlabPool& operator=(const SlabPool& obj);
+
+    struct FreeSlot
+    {
+        FreeSlot *next;
+    };
+
+    void grow();
+    void *allocLocked();
+    void freeLocked(void *p);
+
+    size_t m_obj_size;
+    int m_objs_per_slab;
+    FreeSlot *m_free_list;
+    std::vector<char *> m_slabs;
+    int m_live;
+    int m_peak_live;
+    bool m_thread_safe;
+    bool m_peak_held;
+    std::mutex m_mutex;
+};
+
+#endif // __MEM_RUBY_NETWORK_GARNET2_0_SLAB_POOL_HH__
@@ -0,0 +1,105 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <set>
+#include <vector>
+
+#include "mem/ruby/network/garnet2.0/SlabPool.hh"
+
+TEST(SlabPoolTest, ObjectSize)
+{
+    // room for the free list link and aligned for any member
+    SlabPool small(1);
+    EXPECT_GE(small.getObjectSize(), sizeof(void *));
+    EXPECT_EQ(0, small.getObjectSize() % alignof(std::max_align_t));
+
+    SlabPool large(100);
+    EXPECT_GE(large.getObjectSize(), 100);
+    EXPECT_EQ(0, large.getObjectSize() % alignof(std::max_align_t));
+}
+
+TEST(SlabPoolTest, AllocDistinctAligned)
+{
+    SlabPool pool(24, 4);
+    std::set<void *> seen;
+    for (int i = 0; i < 10; i++) {
+        void *p = pool.alloc();
+        EXPECT_EQ(0, (uintptr_t)p % alignof(std::max_align_t));
+        EXPECT_TRUE(seen.insert(p).second);
+    }
+    // three slabs of four
+    EXPECT_EQ(12, pool.getCapacity());
+    EXPECT_EQ(10, pool.getLive());
+}
+
+TEST(SlabPoolTest, FreeRecycles)
+{
+    SlabPool pool(24, 4);
+    void *a = pool.alloc();
+    void *b = pool.alloc();
+    pool.free(a);
+    EXPECT_EQ(1, pool.getLive());
+    // the last freed slot goes out first
+    EXPECT_EQ(a, pool.alloc());
+    pool.free(b);
+    EXPECT_EQ(b, pool.alloc());
+    EXPECT_EQ(4, pool.getCapacity());
+
+    // freeing NULL does nothing
+    pool.free(NULL);
+    EXPECT_EQ(2, pool.getLive());
+}
+
+TEST(SlabPoolTest, PeakLive)
+{
+    SlabPool pool(8);
+    std::vector<void *> objs;
+    for (int i = 0; i < 5; i++)
+        objs.push_back(pool.alloc());
+    for (int i = 0; i < 5; i++)
+        pool.free(objs[i]);
+    EXPECT_EQ(0, pool.getLive());
+    EXPECT_EQ(5, pool.getPeakLive());
+
+    pool.alloc();
+    EXPECT_EQ(5, pool.getPeakLive());
+}
+
+// while held, only the live count at the release counts, whatever the
+// allocations and frees in between
+TEST(SlabPoolTest, HeldPeak)
+{
+    SlabPool pool(8);
+    void *a = pool.alloc();
+    pool.holdPeak();
+    void *b = pool.alloc();
+    void *c = pool.alloc();
+    pool.free(b);
+    EXPECT_EQ(1, pool.getPeakLive());
+    pool.releasePeak();
+    EXPECT_EQ(2, pool.getPeakLive());
+
+    pool.holdPeak();
+    pool.free(a);
+    pool.free(c);
+    pool.releasePeak();
+    EXPECT_EQ(2, pool.getPeakLive());
+    EXPECT_EQ(0, pool.getLive());
+}
+
+TEST(SlabPoolTest, ThreadSafe)
+{
+    SlabPool pool(8, 2);
+    pool.setThreadSafe(true);
+    void *a = pool.alloc();
+    void *b = pool.alloc();
+    void *c = pool.alloc();
+    EXPECT_EQ(4, pool.getCapacity());
+    pool.free(b);
+    EXPECT_EQ(b, pool.alloc());
+    pool.free(a);
+    pool.free(b);
+    pool.free(c);
+    EXPECT_EQ(0, pool.getLive());
+    EXPECT_EQ(3, pool.getPeakLive());
+}
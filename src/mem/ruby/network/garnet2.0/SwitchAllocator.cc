@@ -31,8 +31,11 @@
  */
 
 
+
 #include "mem/ruby/network/garnet2.0/SwitchAllocator.hh"
 
+#include <algorithm>
+
 #include "debug/RubyNetwork.hh"
 #include "mem/ruby/network/garnet2.0/GarnetNetwork.hh"
 #include "mem/ruby/network/garnet2.0/InputUnit.hh"
@@ -48,6 +51,7 @@ SwitchAllocator::SwitchAllocator(Router *router)
 
     m_input_arbiter_activity = 0;
     m_output_arbiter_activity = 0;
+    m_wavefront_priority = 0;
 }
 
 void
@@ -56,26 +60,39 @@ SwitchAllocator::init()
     m_input_unit = m_router->get_inputUnit_ref();
     m_output_unit = m_router->get_outputUnit_ref();
 
+    // the network pointer is only set after the router is built
+    int type = m_router->get_net_ptr()->getSwitchAllocator();
+    if (type < 0 || type >= NUM_SWITCH_ALLOCATOR_TYPE_)
+        fatal("Unknown switch allocator %d, should be 0 (separable), "
+              "1 (iSLIP) or 2 (wavefront) !", type);
+    m_type = (SwitchAllocatorType)type;
+    m_ring = (m_router->get_net_ptr()->getTopology() == "Ring");
+
     m_num_inports = m_router->get_num_inports();
     m_num_outports = m_router->get_num_outports();
     m_round_robin_inport.resize(m_num_outports);
     m_round_robin_invc.resize(m_num_inports);
+    m_round_robin_outport.resize(m_num_inports);
     m_port_requests.resize(m_num_outports);
+    m_inport_requests.resize(m_num_inports);
+    m_islip_grants.resize(m_num_inports);
+    m_requested_outports.resize(m_num_outports);
+    m_requesting_inports.resize(m_num_inports);
+    m_granted_inports.resize(m_num_inports);
     m_vc_winners.resize(m_num_outports);
 
     for (int i = 0; i < m_num_inports; i++) {
         m_round_robin_invc[i] = 0;
+        m_round_robin_outport[i] = 0;
+        m_inport_requests[i].resize(m_num_outports);
+        m_islip_grants[i].resize(m_num_outports);
     }
 
     for (int i = 0; i < m_num_outports; i++) {
-        m_port_requests[i].resize(m_num_inports);
+        m_port_requests[i].resize(m_num_inports); // [outport][inport]
         m_vc_winners[i].resize(m_num_inports);
 
         m_round_robin_inport[i] = 0;
-
-        for (int j = 0; j < m_num_inports; j++) {
-            m_port_requests[i][j] = false; // [outport][inport]
-        }
     }
 }
 
@@ -86,20 +103,30 @@ SwitchAllocator::init()
  * There is no separate VCAllocator stage like the one in garnet1.0.
  * At the end of this function, the router is rescheduled to wakeup
  * next cycle for peforming SA for any flits ready next cycle.
+ *
+ * With --switch-allocator 1 or 2 every input port requests all the
+ * output ports it has a ready VC for and the input/output matching is
+ * done by iSLIP or by a wavefront allocator instead.
  */
 
 void
 SwitchAllocator::wakeup()
 {
     arbitrate_inports(); // First stage of allocation
-    arbitrate_outports(); // Second stage of allocation
+
+    if (m_type == ISLIP_)
+        arbitrate_islip();
+    else if (m_type == WAVEFRONT_)
+        arbitrate_wavefront();
+    else
+        arbitrate_outports(); // Second stage of allocation
 
     clear_request_vector();
     check_for_wakeup();
 }
 
 /*
- * SA-I (or SA-i) loops through all input VCs at every input port,
+ * SA-I (or SA-i) loops through the occupied input VCs at every input port,
  * and selects one in a round robin manner.
  *    - For HEAD/HEAD_TAIL flits only selects an input VC whose output port
  *     has at least one free output VC.
@@ -114,48 +141,213 @@ SwitchAllocator::arbitrate_inports()
     // Select a VC from each input in a round robin manner
     // Independent arbiter at each input port
     for (int inport = 0; inport < m_num_inports; inport++) {
-        int invc = m_round_robin_invc[inport];
+        if (m_input_unit[inport]->get_occupied_vcs().none())
+            continue;
 
-        for (int invc_iter = 0; invc_iter < m_num_vcs; invc_iter++) {
+        place_requests(inport, m_type == SEPARABLE_);
+    }
+}
 
-            if (m_input_unit[inport]->need_stage(invc, SA_,
-                m_router->curCycle())) {
+/*
+ * Visits the occupied VCs of inport from its round robin pointer on, going
+ * round the mask with find-first-set, and places a request for the
+ * outport of each VC in SA stage allowed to send. The separable allocator
+ * stops at the first request. iSLIP and the wavefront allocator keep the
+ * first VC found for every outport.
+ */
 
-                // This flit is in SA stage
+void
+SwitchAllocator::place_requests(int inport, bool first_only)
+{
+    const BitMask &occupied = m_input_unit[inport]->get_occupied_vcs();
+    int start = m_round_robin_invc[inport];
+
+    for (int pass = 0; pass < 2; pass++) {
+        int end = (pass == 0) ? m_num_vcs : start;
+        for (int invc = occupied.findFirstIn((pass == 0) ? start : 0, end);
+             invc != -1; invc = occupied.findFirstIn(invc + 1, end)) {
+
+            if (!m_input_unit[inport]->need_stage(invc, SA_,
+                m_router->curCycle()))
+                continue;
+
+            // This flit is in SA stage
+
+            int  outport = m_input_unit[inport]->get_outport(invc);
+            int  outvc   = m_input_unit[inport]->get_outvc(invc);
+
+            // an earlier VC already requests this outport
+            if (m_port_requests[outport].test(inport))
+                continue;
+
+            // check if the flit in this InputVC is allowed to be sent
+            // send_allowed conditions described in that function.
+            if (!send_allowed(inport, invc, outport, outvc))
+                continue;
+
+            m_input_arbiter_activity++;
+            m_port_requests[outport].set(inport);
+            m_inport_requests[inport].set(outport);
+            m_requested_outports.set(outport);
+            m_requesting_inports.set(inport);
+            m_vc_winners[outport][inport]= invc;
+
+            if (first_only) {
+                // Update Round Robin pointer to the next VC
+                m_round_robin_invc[inport] = invc + 1;
+                if (m_round_robin_invc[inport] >= m_num_vcs)
+                    m_round_robin_invc[inport] = 0;
+
+                return; // got one vc winner for this port
+            }
+        }
+    }
+}
 
-                int  outport = m_input_unit[inport]->get_outport(invc);
-                int  outvc   = m_input_unit[inport]->get_outvc(invc);
+/*
+ * SA-II (or SA-o) loops through the requested output ports,
+ * and selects one input VC (that placed a request during SA-I)
+ * as the winner for this output port in a round robin manner.
+ */
 
-                // check if the flit in this InputVC is allowed to be sent
-                // send_allowed conditions described in that function.
-                bool make_request =
-                    send_allowed(inport, invc, outport, outvc);
+void
+SwitchAllocator::arbitrate_outports()
+{
+    // Now there are a set of input vc requests for output vcs.
+    // Again do round robin arbitration on these requests
+    // Independent arbiter at each output port
+    for (int outport = m_requested_outports.findFirstIn(0, m_num_outports);
+         outport != -1;
+         outport = m_requested_outports.findFirstIn(outport + 1,
+                                                    m_num_outports)) {
+
+        // first inport with a request from the round robin pointer on
+        int inport = m_port_requests[outport].findNext(
+            m_round_robin_inport[outport]);
+        assert(inport != -1);
+
+        // grant this outport to this inport
+        grant_inport(outport, inport, m_vc_winners[outport][inport]);
+
+        // Update Round Robin pointer
+        m_round_robin_inport[outport] = inport + 1;
+        if (m_round_robin_inport[outport] >= m_num_inports)
+            m_round_robin_inport[outport] = 0;
+    }
+}
 
-                if (make_request) {
-                    m_input_arbiter_activity++;
-                    m_port_requests[outport][inport] = true;
-                    m_vc_winners[outport][inport]= invc;
+/*
+ * iSLIP: in every iteration each output port with requests left grants the
+ * first requesting input port from its round robin pointer, and each input
+ * port accepts the first granting output port from its own pointer. The
+ * matched ports leave the requests and the next iteration matches the rest,
+ * until an iteration grants nothing. The pointers move one past the match
+ * only for the matches of the first iteration, which keeps them
+ * desynchronized.
+ */
 
-                    // Update Round Robin pointer to the next VC
-                    m_round_robin_invc[inport] = invc + 1;
-                    if (m_round_robin_invc[inport] >= m_num_vcs)
-                        m_round_robin_invc[inport] = 0;
+void
+SwitchAllocator::arbitrate_islip()
+{
+    for (int iter = 0; !m_requested_outports.none(); iter++) {
+        // Grant
+        for (int outport = m_requested_outports.findFirstIn(0,
+                 m_num_outports);
+             outport != -1;
+             outport = m_requested_outports.findFirstIn(outport + 1,
+                                                        m_num_outports)) {
+            int inport = m_port_requests[outport].findNext(
+                m_round_robin_inport[outport]);
+            assert(inport != -1);
+            m_islip_grants[inport].set(outport);
+            m_granted_inports.set(inport);
+        }
 
-                    break; // got one vc winner for this port
-                }
+        // Accept, every granted input port matches one output port
+        for (int inport = m_granted_inports.findFirstIn(0, m_num_inports);
+             inport != -1;
+             inport = m_granted_inports.findFirstIn(inport + 1,
+                                                    m_num_inports)) {
+            int outport = m_islip_grants[inport].findNext(
+                m_round_robin_outport[inport]);
+            assert(outport != -1);
+            m_islip_grants[inport].clearAll();
+
+            if (iter == 0) {
+                m_round_robin_inport[outport] = (inport + 1) % m_num_inports;
+                m_round_robin_outport[inport] =
+                    (outport + 1) % m_num_outports;
             }
 
-            invc++;
-            if (invc >= m_num_vcs)
-                invc = 0;
+            int invc = m_vc_winners[outport][inport];
+            remove_requests(inport, outport);
+            grant_inport(outport, inport, invc);
         }
+        m_granted_inports.clearAll();
     }
 }
 
 /*
- * SA-II (or SA-o) loops through all output ports,
- * and selects one input VC (that placed a request during SA-I)
- * as the winner for this output port in a round robin manner.
+ * Wavefront allocation: the cells (inport, outport) of the request matrix
+ * with outport = (inport + d) mod N share no row nor column, so the
+ * diagonals d are swept one after the other, starting from a priority
+ * diagonal that rotates every cycle, and a request is granted if neither
+ * its inport nor its outport was matched by an earlier diagonal.
+ */
+
+void
+SwitchAllocator::arbitrate_wavefront()
+{
+    int n = std::max(m_num_inports, m_num_outports);
+
+    for (int d = 0; d < n && !m_requested_outports.none(); d++) {
+        int diagonal = (m_wavefront_priority + d) % n;
+
+        for (int inport = m_requesting_inports.findFirstIn(0, m_num_inports);
+             inport != -1;
+             inport = m_requesting_inports.findFirstIn(inport + 1,
+                                                       m_num_inports)) {
+            int outport = (inport + diagonal) % n;
+            if (outport >= m_num_outports ||
+                !m_inport_requests[inport].test(outport))
+                continue;
+
+            int invc = m_vc_winners[outport][inport];
+            remove_requests(inport, outport);
+            grant_inport(outport, inport, invc);
+        }
+    }
+
+    m_wavefront_priority = (m_wavefront_priority + 1) % n;
+}
+
+// Take a matched inport and outport out of the requests left.
+void
+SwitchAllocator::remove_requests(int inport, int outport)
+{
+    BitMask &outports = m_inport_requests[inport];
+    for (int o = outports.findFirstIn(0, m_num_outports); o != -1;
+         o = outports.findFirstIn(o + 1, m_num_outports)) {
+        m_port_requests[o].clear(inport);
+        if (m_port_requests[o].none())
+            m_requested_outports.clear(o);
+    }
+    outports.clearAll();
+    m_requesting_inports.clear(inport);
+
+    BitMask &inports = m_port_requests[outport];
+    for (int i = inports.findFirstIn(0, m_num_inports); i != -1;
+         i = inports.findFirstIn(i + 1, m_num_inports)) {
+        m_inport_requests[i].clear(outport);
+        if (m_inport_requests[i].none())
+            m_requesting_inports.clear(i);
+    }
+    inports.clearAll();
+    m_requested_outports.clear(outport);
+}
+
+/*
+ * Sends the flit of invc at inport through outport.
  *      - For HEAD/HEAD_TAIL flits, performs simplified outvc allocation.
  *        (i.e., select a free VC from the output port).
  *      - For BODY/TAIL flits, decrement a credit in the output vc.
@@ -167,102 +359,78 @@ SwitchAllocator::arbitrate_inports()
  */
 
 void
-SwitchAllocator::arbitrate_outports()
+SwitchAllocator::grant_inport(int outport, int inport, int invc)
 {
-    // Now there are a set of input vc requests for output vcs.
-    // Again do round robin arbitration on these requests
-    // Independent arbiter at each output port
-    for (int outport = 0; outport < m_num_outports; outport++) {
-        int inport = m_round_robin_inport[outport];
-
-        for (int inport_iter = 0; inport_iter < m_num_inports;
-                 inport_iter++) {
-
-            // inport has a request this cycle for outport
-            if (m_port_requests[outport][inport]) {
-
-                // grant this outport to this inport
-                int invc = m_vc_winners[outport][inport];
-
-                int outvc = m_input_unit[inport]->get_outvc(invc);
-                if (outvc == -1) {
-                    // VC Allocation - select any free VC from outport
-                    outvc = vc_allocate(outport, inport, invc);
-                }
-
-                // remove flit from Input VC
-                flit *t_flit = m_input_unit[inport]->getTopFlit(invc);
-
-                DPRINTF(RubyNetwork, "SwitchAllocator at Router %d "
-                                     "granted outvc %d at outport %d "
-                                     "to invc %d at inport %d to flit %s at "
-                                     "time: %lld\n",
-                        m_router->get_id(), outvc,
-                        m_router->getPortDirectionName(
-                            m_output_unit[outport]->get_direction()),
-                        invc,
-                        m_router->getPortDirectionName(
-                            m_input_unit[inport]->get_direction()),
-                            *t_flit,
-                        m_router->curCycle());
-
-
-                // Update outport field in the flit since this is
-                // used by CrossbarSwitch code to send it out of
-                // correct outport.
-                // Note: post route compute in InputUnit,
-                // outport is updated in VC, but not in flit
-                t_flit->set_outport(outport);
-
-                // set outvc (i.e., invc for next hop) in flit
-                // (This was updated in VC by vc_allocate, but not in flit)
-                t_flit->set_vc(outvc);
-
-                // decrement credit in outvc
-                m_output_unit[outport]->decrement_credit(outvc);
-
-                // flit ready for Switch Traversal
-                t_flit->advance_stage(ST_, m_router->curCycle());
-                m_router->grant_switch(inport, t_flit);
-                m_output_arbiter_activity++;
-
-                if ((t_flit->get_type() == TAIL_) ||
-                    t_flit->get_type() == HEAD_TAIL_) {
-
-                    // This Input VC should now be empty
-                    assert(!(m_input_unit[inport]->isReady(invc,
-                        m_router->curCycle())));
-
-                    // Free this VC
-                    m_input_unit[inport]->set_vc_idle(invc,
-                        m_router->curCycle());
-
-                    // Send a credit back
-                    // along with the information that this VC is now idle
-                    m_input_unit[inport]->increment_credit(invc, true,
-                        m_router->curCycle());
-                } else {
-                    // Send a credit back
-                    // but do not indicate that the VC is idle
-                    m_input_unit[inport]->increment_credit(invc, false,
-                        m_router->curCycle());
-                }
-
-                // remove this request
-                m_port_requests[outport][inport] = false;
-
-                // Update Round Robin pointer
-                m_round_robin_inport[outport] = inport + 1;
-                if (m_round_robin_inport[outport] >= m_num_inports)
-                    m_round_robin_inport[outport] = 0;
-
-                break; // got a input winner for this outport
-            }
+    int outvc = m_input_unit[inport]->get_outvc(invc);
+    if (outvc == -1) {
+        // VC Allocation - select any free VC from outport
+        outvc = vc_allocate(outport, inport, invc);
+    }
 
-            inport++;
-            if (inport >= m_num_inports)
-                inport = 0;
-        }
+    // remove flit from Input VC
+    flit *t_flit = m_input_unit[inport]->getTopFlit(invc);
+
+    DPRINTF(RubyNetwork, "SwitchAllocator at Router %d "
+                         "granted outvc %d at outport %d "
+                         "to invc %d at inport %d to flit %s at "
+                         "time: %lld\n",
+            m_router->get_id(), outvc,
+            m_router->getPortDirectionName(
+                m_output_unit[outport]->get_direction()),
+            invc,
+            m_router->getPortDirectionName(
+                m_input_unit[inport]->get_direction()),
+                *t_flit,
+            m_router->curCycle());
+
+
+    // Update outport field in the flit since this is
+    // used by CrossbarSwitch code to send it out of
+    // correct outport.
+    // Note: post route compute in InputUnit,
+    // outport is updated in VC, but not in flit
+    t_flit->set_outport(outport);
+
+    // set outvc (i.e., invc for next hop) in flit
+    // (This was updated in VC by vc_allocate, but not in flit)
+    t_flit->set_vc(outvc);
+
+    // decrement credit in outvc
+    m_output_unit[outport]->decrement_credit(outvc);
+
+    // flit ready for Switch Traversal
+    t_flit->advance_stage(ST_, m_router->curCycle());
+    m_router->grant_switch(inport, t_flit);
+    m_output_arbiter_activity++;
+
+    if ((t_flit->get_type() == TAIL_) ||
+        t_flit->get_type() == HEAD_TAIL_) {
+
+        // This Input VC should now be empty
+        assert(!(m_input_unit[inport]->isReady(invc,
+            m_router->curCycle())));
+
+        // Free this VC
+        m_input_unit[inport]->set_vc_idle(invc,
+            m_router->curCycle());
+
+        // Send a credit back
+        // along with the information that this VC is now idle
+        m_input_unit[inport]->increment_credit(invc, true,
+            m_router->curCycle());
+    } else {
+        // Send a credit back
+        // but do not indicate that the VC is idle
+        m_input_unit[inport]->increment_credit(invc, false,
+            m_router->curCycle());
+    }
+
+    if (m_type != SEPARABLE_) {
+        // SA-I moved the pointer when the VC requested, here
+        // it moves only when the VC wins
+        m_round_robin_invc[inport] = invc + 1;
+        if (m_round_robin_invc[inport] >= m_num_vcs)
+            m_round_robin_invc[inport] = 0;
     }
 }
 
@@ -290,35 +458,29 @@ SwitchAllocator::send_allowed(int inport, int invc, int outport, int outvc)
     int vnet = get_vnet(invc);
     bool has_outvc = (outvc != -1);
     bool has_credit = false;
-    //add for Ring
-    //here add vc_ch, doubt: -> or .
-    int vc_ch = m_input_unit[inport]->peekTopFlit(invc)->get_route().vc_choice;
 
     if (!has_outvc) {
 
         // needs outvc
         // this is only true for HEAD and HEAD_TAIL flits.
 
-        if (m_router->get_net_ptr()->getTopology() == "Ring"){
-
-            if (m_output_unit[outport]->has_free_vc(vnet, vc_ch)) {
-
-                has_outvc = true;
-
-                // each VC has at least one buffer,
-                // so no need for additional credit check
-                has_credit = true;
-            }
+        bool free_vc;
+        if (m_ring) {
+            //add for Ring
+            int vc_ch = m_router->vc_choice(
+                m_input_unit[inport]->peekTopFlit(invc)->get_route(), outport);
+            free_vc = m_output_unit[outport]->has_free_vc(vnet, vc_ch);
         } else {
+            free_vc = m_output_unit[outport]->has_free_vc(vnet);
+        }
 
-            if (m_output_unit[outport]->has_free_vc(vnet)) {
+        if (free_vc) {
 
             has_outvc = true;
 
             // each VC has at least one buffer,
             // so no need for additional credit check
             has_credit = true;
-            }
         }
 
     } else {
@@ -339,8 +501,12 @@ SwitchAllocator::send_allowed(int inport, int invc, int outport, int outvc)
         // check if any other flit is ready for SA and for same output port
         // and was enqueued before this flit
         int vc_base = vnet*m_vc_per_vnet;
-        for (int vc_offset = 0; vc_offset < m_vc_per_vnet; vc_offset++) {
-            int temp_vc = vc_base + vc_offset;
+        const BitMask &occupied = m_input_unit[inport]->get_occupied_vcs();
+        for (int temp_vc = occupied.findFirstIn(vc_base,
+                 vc_base + m_vc_per_vnet);
+             temp_vc != -1;
+             temp_vc = occupied.findFirstIn(temp_vc + 1,
+                                            vc_base + m_vc_per_vnet)) {
             if (m_input_unit[inport]->need_stage(temp_vc, SA_,
                                                  m_router->curCycle()) &&
                (m_input_unit[inport]->get_outport(temp_vc) == outport) &&
@@ -358,14 +524,16 @@ SwitchAllocator::send_allowed(int inport, int invc, int outport, int outvc)
 int
 SwitchAllocator::vc_allocate(int outport, int inport, int invc)
 {
-    int vc_ch = m_input_unit[inport]->peekTopFlit(invc)->get_route().vc_choice;
     // Select a free VC from the output port
     //modified for Ring
     int outvc;
-    if (m_router->get_net_ptr()->getTopology() == "Ring")
+    if (m_ring) {
+        int vc_ch = m_router->vc_choice(
+            m_input_unit[inport]->peekTopFlit(invc)->get_route(), outport);
         outvc = m_output_unit[outport]->select_free_vc(get_vnet(invc), vc_ch);
-    else
+    } else {
         outvc = m_output_unit[outport]->select_free_vc(get_vnet(invc));
+    }
 
     // has to get a valid VC since it checked before performing SA
     assert(outvc != -1);
@@ -381,7 +549,9 @@ SwitchAllocator::check_for_wakeup()
     Cycles nextCycle = m_router->curCycle() + Cycles(1);
 
     for (int i = 0; i < m_num_inports; i++) {
-        for (int j = 0; j < m_num_vcs; j++) {
+        const BitMask &occupied = m_input_unit[i]->get_occupied_vcs();
+        for (int j = occupied.findFirstIn(0, m_num_vcs); j != -1;
+             j = occupied.findFirstIn(j + 1, m_num_vcs)) {
             if (m_input_unit[i]->need_stage(j, SA_, nextCycle)) {
                 m_router->schedule_wakeup(Cycles(1));
                 return;
@@ -404,11 +574,18 @@ SwitchAllocator::get_vnet(int invc)
 void
 SwitchAllocator::clear_request_vector()
 {
-    for (int i = 0; i < m_num_outports; i++) {
-        for (int j = 0; j < m_num_inports; j++) {
-            m_port_requests[i][j] = false;
-        }
+    for (int i = m_requested_outports.findFirstIn(0, m_num_outports);
+         i != -1; i = m_requested_outports.findFirstIn(i + 1,
+                                                       m_num_outports)) {
+        m_port_requests[i].clearAll();
+    }
+    for (int i = m_requesting_inports.findFirstIn(0, m_num_inports);
+         i != -1; i = m_requesting_inports.findFirstIn(i + 1,
+                                                       m_num_inports)) {
+        m_inport_requests[i].clearAll();
     }
+    m_requested_outports.clearAll();
+    m_requesting_inports.clearAll();
 }
 
 void
@@ -38,6 +38,7 @@
 #include <vector>
 
 #include "mem/ruby/common/Consumer.hh"
+#include "mem/ruby/network/garnet2.0/BitMask.hh"
 #include "mem/ruby/network/garnet2.0/CommonTypes.hh"
 
 class Router;
@@ -56,7 +57,10 @@ class SwitchAllocator : public Consumer
     void print(std::ostream& out) const {};
     void arbitrate_inports();
     void arbitrate_outports();
+    void arbitrate_islip();
+    void arbitrate_wavefront();
     bool send_allowed(int inport, int invc, int outport, int outvc);
+    bool is_ring() const { return m_ring; }
     int vc_allocate(int outport, int inport, int invc);
 
     inline double
@@ -73,15 +77,31 @@ class SwitchAllocator : public Consumer
     void resetStats();
 
   private:
+    void place_requests(int inport, bool first_only);
+    void remove_requests(int inport, int outport);
+    void grant_inport(int outport, int inport, int invc);
+
     int m_num_inports, m_num_outports;
     int m_num_vcs, m_vc_per_vnet;
+    SwitchAllocatorType m_type;
+    bool m_ring;
 
     double m_input_arbiter_activity, m_output_arbiter_activity;
 
     Router *m_router;
     std::vector<int> m_round_robin_invc;
     std::vector<int> m_round_robin_inport;
-    std::vector<std::vector<bool>> m_port_requests;
+    // iSLIP accept pointer of each inport
+    std::vector<int> m_round_robin_outport;
+    // rotating top priority diagonal of the wavefront allocator
+    int m_wavefront_priority;
+    std::vector<BitMask> m_port_requests; // inports requesting each outport
+    std::vector<BitMask> m_inport_requests; // outports requested by inport
+    BitMask m_requested_outports;
+    BitMask m_requesting_inports;
+    // iSLIP grants received by each inport in the current iteration
+    std::vector<BitMask> m_islip_grants;
+    BitMask m_granted_inports;
     std::vector<std::vector<int>> m_vc_winners; // a list for each outport
     std::vector<InputUnit *> m_input_unit;
     std::vector<OutputUnit *> m_output_unit;
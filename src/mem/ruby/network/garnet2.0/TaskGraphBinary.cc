@@ -0,0 +1,106 @@
+#include "mem/ruby/network/garnet2.0/TaskGraphBinary.hh"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+
+#include "base/logging.hh"
+
+TaskGraphBinary::TaskGraphBinary()
+    : head_task(NULL), task_id(NULL), task_proc(NULL), task_schedule(NULL),
+      task_mu(NULL), task_sigma(NULL), token_mu(NULL), token_sigma(NULL),
+      pkt_lambda(NULL), m_header(NULL), m_data(NULL), m_size(0)
+{
+    for (int i = 0; i < NUM_EDGE_FIELDS; i++)
+        edge_field[i] = NULL;
+}
+
+TaskGraphBinary::~TaskGraphBinary()
+{
+    if (m_data != NULL)
+        munmap(m_data, m_size);
+}
+
+bool
+TaskGraphBinary::isTaskGraphBinary(const std::string &filename)
+{
+    char magic[sizeof(TaskGraphBinaryHeader::magic)];
+    FILE *fp = fopen(filename.c_str(), "rb");
+    if (fp == NULL)
+        return false;
+    bool is_binary = fread(magic, sizeof(magic), 1, fp) == 1 &&
+        memcmp(magic, TASK_GRAPH_BINARY_MAGIC, sizeof(magic)) == 0;
+    fclose(fp);
+    return is_binary;
+}
+
+template <class T>
+const T *
+TaskGraphBinary::nextArray(size_t &offset, int num,
+    const std::string &filename)
+{
+    offset = (offset + 7) & ~size_t(7);
+    const T *array = (const T *)((const char *)m_data + offset);
+    offset += sizeof(T) * num;
+    if (offset > m_size)
+        fatal("Task graph binary %s is truncated !", filename);
+    return array;
+}
+
+void
+TaskGraphBinary::load(const std::string &filename)
+{
+    assert(m_data == NULL);
+
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        fatal("Error opening the %s task graph binary !", filename);
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_size < sizeof(TaskGraphBinaryHeader))
+        fatal("Task graph binary %s is too short !", filename);
+    m_size = st.st_size;
+
+    m_data = mmap(NULL, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (m_data == MAP_FAILED) {
+        m_data = NULL;
+        fatal("Cannot map the %s task graph binary !", filename);
+    }
+
+    m_header = (const TaskGraphBinaryHeader *)m_data;
+    if (memcmp(m_header->magic, TASK_GRAPH_BINARY_MAGIC,
+               sizeof(m_header->magic)) != 0)
+        fatal("%s is not a task graph binary !", filename);
+    if (m_header->version != TASK_GRAPH_BINARY_VERSION)
+        fatal("Task graph binary %s has version %d, expected %d !",
+            filename, m_header->version, TASK_GRAPH_BINARY_VERSION);
+    if (m_header->num_task <= 0 || m_header->num_edge <= 0 ||
+        m_header->num_head_task < 0 || m_header->num_proc <= 0)
+        fatal("Task graph binary %s has a corrupted header !", filename);
+
+    size_t offset = sizeof(TaskGraphBinaryHeader);
+    int num_task = m_header->num_task;
+    int num_edge = m_header->num_edge;
+
+    head_task = nextArray<int32_t>(offset, m_header->num_head_task,
+        filename);
+    task_id = nextArray<int32_t>(offset, num_task, filename);
+    task_proc = nextArray<int32_t>(offset, num_task, filename);
+    task_schedule = nextArray<int32_t>(offset, num_task, filename);
+    task_mu = nextArray<float>(offset, num_task, filename);
+    task_sigma = nextArray<float>(offset, num_task, filename);
+    for (int i = 0; i < NUM_EDGE_FIELDS; i++)
+        edge_field[i] = nextArray<int32_t>(offset, num_edge, filename);
+    token_mu = nextArray<float>(offset, num_edge, filename);
+    token_sigma = nextArray<float>(offset, num_edge, filename);
+    pkt_lambda = nextArray<float>(offset, num_edge, filename);
+
+    //the arrays are read in order, tell the kernel
+    madvise(m_data, m_size, MADV_SEQUENTIAL);
+}
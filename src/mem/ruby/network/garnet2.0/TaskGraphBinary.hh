@@ -0,0 +1,81 @@
+#ifndef __MEM_RUBY_NETWORK_GARNET2_0_TASK_GRAPH_BINARY_HH__
+#define __MEM_RUBY_NETWORK_GARNET2_0_TASK_GRAPH_BINARY_HH__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#define TASK_GRAPH_BINARY_MAGIC "GEM5TGB"
+#define TASK_GRAPH_BINARY_VERSION 1
+
+// Pre-compiled task graph of one application (.tgb), written from the .stp
+// file by my_scripts/stp2tgb.py. Everything is little endian, the header
+// is followed by these arrays, each one starting on an 8 byte boundary:
+//   int32 head_task[num_head_task]
+//   int32 task_id, task_proc, task_schedule [num_task]
+//   float task_mu, task_sigma [num_task]
+//   int32 edge id, src/dst task, src/dst proc, out/in memory address and
+//         size [num_edge] (one array per field, in EdgeField order)
+//   float token_mu, token_sigma, pkt_lambda [num_edge]
+struct TaskGraphBinaryHeader
+{
+    char magic[8];
+    uint32_t version;
+    int32_t num_proc;
+    int32_t num_task;
+    int32_t num_edge;
+    int32_t num_head_task;
+    uint32_t reserved;
+};
+
+// The file is mapped read only and the arrays are read in place.
+class TaskGraphBinary
+{
+  public:
+    enum EdgeField
+    {
+        EDGE_ID,
+        EDGE_SRC_TASK,
+        EDGE_DST_TASK,
+        EDGE_SRC_PROC,
+        EDGE_DST_PROC,
+        EDGE_OUT_MEM_ADDR,
+        EDGE_OUT_MEM_SIZE,
+        EDGE_IN_MEM_ADDR,
+        EDGE_IN_MEM_SIZE,
+        NUM_EDGE_FIELDS
+    };
+
+    TaskGraphBinary();
+    ~TaskGraphBinary();
+
+    // whether the file starts with the .tgb magic
+    static bool isTaskGraphBinary(const std::string &filename);
+    void load(const std::string &filename);
+
+    const TaskGraphBinaryHeader &getHeader() const { return *m_header; }
+
+    const int32_t *head_task;
+    const int32_t *task_id;
+    const int32_t *task_proc;
+    const int32_t *task_schedule;
+    const float *task_mu;
+    const float *task_sigma;
+    const int32_t *edge_field[NUM_EDGE_FIELDS];
+    const float *token_mu;
+    const float *token_sigma;
+    const float *pkt_lambda;
+
+  private:
+    TaskGraphBinary(const TaskGraphBinary& obj);
+    TaskGraphBinary& operator=(const TaskGraphBinary& obj);
+
+    template <class T>
+    const T *nextArray(size_t &offset, int num, const std::string &filename);
+
+    const TaskGraphBinaryHeader *m_header;
+    void *m_data;
+    size_t m_size;
+};
+
+#endif // __MEM_RUBY_NETWORK_GARNET2_0_TASK_GRAPH_BINARY_HH__
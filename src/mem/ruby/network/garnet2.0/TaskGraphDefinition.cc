@@ -1,60 +1,175 @@
 #include "mem/ruby/network/garnet2.0/TaskGraphDefinition.hh"
 
-static double tg_r_seed;
-static double tg_seed = 91648253;
+namespace
+{
+
+uint64_t
+splitmix64(uint64_t &x)
+{
+    uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+inline uint64_t
+rotl(uint64_t x, int k)
+{
+    return (x << k) | (x >> (64 - k));
+}
+
+// Ziggurat layers (Marsaglia & Tsang, with the tables laid out as in
+// Doornik's ZIGNOR): x[0] is V / f(R), x[1] = R, x[C] = 0, and r[i] is
+// the part of layer i that lies entirely under the density.
+struct ZigguratTables
+{
+    static const int normal_layers = 128;
+    static const int exp_layers = 256;
+
+    double normal_x[normal_layers + 1];
+    double normal_r[normal_layers];
+    double exp_x[exp_layers + 1];
+    double exp_r[exp_layers];
+
+    ZigguratTables()
+    {
+        const double nr = 3.442619855899;
+        const double nv = 9.91256303526217e-3;
+        double f = exp(-0.5 * nr * nr);
+        normal_x[0] = nv / f;
+        normal_x[1] = nr;
+        normal_x[normal_layers] = 0;
+        for (int i = 2; i < normal_layers; i++) {
+            normal_x[i] = sqrt(-2 * log(nv / normal_x[i - 1] + f));
+            f = exp(-0.5 * normal_x[i] * normal_x[i]);
+        }
+        for (int i = 0; i < normal_layers; i++)
+            normal_r[i] = normal_x[i + 1] / normal_x[i];
+
+        const double er = 7.69711747013104972;
+        const double ev = 3.949659822581572e-3;
+        f = exp(-er);
+        exp_x[0] = ev / f;
+        exp_x[1] = er;
+        exp_x[exp_layers] = 0;
+        for (int i = 2; i < exp_layers; i++) {
+            exp_x[i] = -log(ev / exp_x[i - 1] + f);
+            f = exp(-exp_x[i]);
+        }
+        for (int i = 0; i < exp_layers; i++)
+            exp_r[i] = exp_x[i + 1] / exp_x[i];
+    }
+};
+
+const ZigguratTables &
+zigguratTables()
+{
+    static const ZigguratTables tables;
+    return tables;
+}
+
+}
 
 void
-generate_seed()
+TaskGraphRNG::seed(uint64_t seed, int kind, int app_idx, int id)
 {
-    srand((unsigned)time(NULL));
-    tg_r_seed=rand()%10;
-        if (tg_r_seed==0)
-                tg_r_seed=1;
+    uint64_t x = seed;
+    x ^= splitmix64(x) + ((uint64_t)kind << 48);
+    x ^= splitmix64(x) + ((uint64_t)(uint32_t)app_idx << 32);
+    x ^= splitmix64(x) + (uint32_t)id;
+    for (int i = 0; i < 4; i++)
+        s[i] = splitmix64(x);
+}
 
+void
+TaskGraphRNG::serialize(const std::string &base, CheckpointOut &cp) const
+{
+    arrayParamOut(cp, base + ".rng", s, 4);
 }
 
-double
-tg_rnd()
+void
+TaskGraphRNG::unserialize(const std::string &base, CheckpointIn &cp)
 {
-        tg_r_seed=fmod(RAND_A*tg_r_seed,RAND_M);
-        double k=tg_r_seed*4.656612875e-10;
-        return(k);
+    arrayParamIn(cp, base + ".rng", s, 4);
+}
+
+uint64_t
+TaskGraphRNG::next()
+{
+    const uint64_t result = rotl(s[1] * 5, 7) * 9;
+    const uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl(s[3], 45);
+
+    return result;
 }
 
 double
-tg_drand() {
-        double &s = tg_seed;
-        s *= 1389796;
-        int q = (int)(s / 2147483647);
-        s -= (double)q * 2147483647;
-        return s / 2147483647;
+TaskGraphRNG::uniform()
+{
+    //53 bits, shifted by half a step so that 0 is never returned
+    return ((next() >> 11) + 0.5) * (1.0 / 9007199254740992.0);
 }
 
 double
-gen_normal_dist(double m, double s) {
+TaskGraphRNG::normal()
+{
+    const ZigguratTables &z = zigguratTables();
+    for (;;) {
+        uint64_t bits = next();
+        int i = bits & (ZigguratTables::normal_layers - 1);
+        double u = 2 * (((bits >> 11) + 0.5) *
+            (1.0 / 9007199254740992.0)) - 1;
 
-        double x1, x2, w, y1;
-        static double y2;
-        static int use_last = 0;
+        //inside the rectangle of the layer
+        if (fabs(u) < z.normal_r[i])
+            return u * z.normal_x[i];
 
-        if (use_last) {		        // use value from previous call
-                y1 = y2;
-                use_last = 0;
-        }
-        else {
-                do {
-                        x1 = 2.0 * tg_drand() - 1.0;
-                        x2 = 2.0 * tg_drand() - 1.0;
-                        w = x1 * x1 + x2 * x2;
-                } while ( w >= 1.0 );
-
-                w = sqrt( (-2.0 * log( w ) ) / w );
-                y1 = x1 * w;
-                y2 = x2 * w;
-                use_last = 1;
+        //base layer, sample from the tail beyond R
+        if (i == 0) {
+            double x, y;
+            do {
+                x = log(uniform()) / z.normal_x[1];
+                y = log(uniform());
+            } while (-2 * y < x * x);
+            return (u < 0) ? x - z.normal_x[1] : z.normal_x[1] - x;
         }
 
-        return ( m + y1 * s );
+        //in the wedge of the layer
+        double x = u * z.normal_x[i];
+        double f0 = exp(-0.5 * (z.normal_x[i] * z.normal_x[i] - x * x));
+        double f1 = exp(-0.5 *
+            (z.normal_x[i + 1] * z.normal_x[i + 1] - x * x));
+        if (f1 + uniform() * (f0 - f1) < 1.0)
+            return x;
+    }
 }
 
-double gen_exp_dis_time(double a) { return (-log(tg_rnd())/a); }
+double
+TaskGraphRNG::exponential()
+{
+    const ZigguratTables &z = zigguratTables();
+    for (;;) {
+        uint64_t bits = next();
+        int i = bits & (ZigguratTables::exp_layers - 1);
+        double u = ((bits >> 11) + 0.5) * (1.0 / 9007199254740992.0);
+
+        if (u < z.exp_r[i])
+            return u * z.exp_x[i];
+
+        //the tail of an exponential is an exponential again
+        if (i == 0)
+            return z.exp_x[1] - log(uniform());
+
+        double x = u * z.exp_x[i];
+        double f0 = exp(-(z.exp_x[i] - x));
+        double f1 = exp(-(z.exp_x[i + 1] - x));
+        if (f1 + uniform() * (f0 - f1) < 1.0)
+            return x;
+    }
+}
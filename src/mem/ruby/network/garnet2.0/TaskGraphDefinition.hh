@@ -2,27 +2,47 @@
 #define __MEM_RUBY_NETWORK_GARNET2_0_TASK_GRAPH_dEFINITION_HH__
 
 #include <cmath>
-
-#include "stdlib.h"
-#include "time.h"
-
-#define RAND_A 16807.0
-#define RAND_M 2147483647.0
-
-// generate double in (0, 1)
-void generate_seed();
-
-//generate uniform distribution random in(0,1)
-// random is stored in r_seed
-double tg_rnd();
-double tg_drand();
-
-
-// normal random variate generator
-// mean m, standard deviation s
-double gen_normal_dist(double m, double s);
-
-//generate exponantial variable with parameter a
-double gen_exp_dis_time(double a);
-
-#endif
\ No newline at end of file
+#include <cstdint>
+#include <string>
+
+#include "sim/serialize.hh"
+
+//kind of object a random stream belongs to, part of its seed
+enum TaskGraphStreamKind
+{
+    TG_TASK_STREAM = 1,
+    TG_EDGE_STREAM = 2,
+    TG_MAPPING_STREAM = 3
+};
+
+// xoshiro256** random stream. Every task and every edge owns one, seeded
+// from the network seed and its (app_idx, id), so its draws do not depend
+// on the order the NIs are woken up in.
+class TaskGraphRNG
+{
+  public:
+    TaskGraphRNG() { seed(0, 0, 0, 0); }
+
+    void seed(uint64_t seed, int kind, int app_idx, int id);
+
+    uint64_t next();
+    //uniform in (0, 1)
+    double uniform();
+    //standard normal and exponential (rate 1), Ziggurat method
+    double normal();
+    double exponential();
+
+    // normal random variate, mean m, standard deviation s
+    double normal(double m, double s) { return m + s * normal(); }
+    // exponential variate with rate a
+    double exponential(double a) { return exponential() / a; }
+
+    //the stream state under base in the current checkpoint section
+    void serialize(const std::string &base, CheckpointOut &cp) const;
+    void unserialize(const std::string &base, CheckpointIn &cp);
+
+  private:
+    uint64_t s[4];
+};
+
+#endif
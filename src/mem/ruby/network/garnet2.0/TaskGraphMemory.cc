@@ -0,0 +1,198 @@
+#include "mem/ruby/network/garnet2.0/TaskGraphMemory.hh"
+
+#include <algorithm>
+#include <cassert>
+
+#include "base/cast.hh"
+#include "base/logging.hh"
+#include "mem/ruby/network/garnet2.0/NetworkInterface.hh"
+#include "mem/request.hh"
+
+TaskGraphMemory::TaskGraphMemory(const std::string &name, SimObject *owner,
+    MasterID master_id, unsigned burst_size)
+    : m_name(name), m_port(name, owner, *this), m_master_id(master_id),
+      m_burst_size(burst_size), m_ni(NULL), m_core_idx(-1),
+      m_range_start(0), m_range_size(0), m_retry_pkt(NULL), m_in_flight(0)
+{
+    assert(burst_size > 0 && region_size % burst_size == 0);
+}
+
+void
+TaskGraphMemory::init()
+{
+    if (!m_port.isConnected())
+        fatal("%s is not connected to a memory controller !", m_name);
+    AddrRangeList ranges = m_port.getAddrRanges();
+    if (ranges.size() != 1)
+        fatal("%s needs a memory controller of one address range !",
+            m_name);
+    m_range_start = ranges.front().start();
+    m_range_size = ranges.front().size();
+    if (m_range_size < m_burst_size || m_range_size % m_burst_size != 0)
+        fatal("%s has a range of %d bytes, not a multiple of the %d byte "
+            "bursts !", m_name, m_range_size, m_burst_size);
+}
+
+void
+TaskGraphMemory::setCore(NetworkInterface *ni, int core_idx)
+{
+    m_ni = ni;
+    m_core_idx = core_idx;
+}
+
+int
+TaskGraphMemory::regionIndex(int app_idx, int task_id)
+{
+    std::pair<int, int> key(app_idx, task_id);
+    std::map<std::pair<int, int>, int>::iterator it =
+        m_region_index.find(key);
+    if (it != m_region_index.end())
+        return it->second;
+    int region = m_region_task.size();
+    m_region_index[key] = region;
+    m_region_task.push_back(key);
+    m_write_offset.push_back(0);
+    m_read_offset.push_back(0);
+    return region;
+}
+
+void
+TaskGraphMemory::access(int app_idx, int task_id, int thread,
+    uint64_t bytes, bool write)
+{
+    assert(m_ni != NULL);
+    if (bytes == 0)
+        return;
+
+    Access a;
+    a.thread = thread;
+    a.region = regionIndex(app_idx, task_id);
+    //the reads follow the writes through the region of the task
+    uint64_t &offset = write ? m_write_offset[a.region] :
+        m_read_offset[a.region];
+    a.offset = offset;
+    a.remaining = bytes;
+    a.write = write;
+    offset = (offset + bytes) % region_size;
+
+    m_accesses.push_back(a);
+    m_pending[thread]++;
+    //while a burst waits for the retry of the controller, the access
+    //waits behind it
+    if (m_retry_pkt == NULL)
+        sendAccesses();
+}
+
+void
+TaskGraphMemory::sendAccesses()
+{
+    assert(m_retry_pkt == NULL);
+    while (!m_accesses.empty()) {
+        Access &a = m_accesses.front();
+        Addr region_base = (uint64_t)a.region * region_size % m_range_size;
+        Addr addr = m_range_start +
+            (region_base + a.offset % region_size) % m_range_size;
+        unsigned size = std::min<uint64_t>(
+            m_burst_size - addr % m_burst_size, a.remaining);
+
+        RequestPtr req = std::make_shared<Request>(addr, size, 0,
+            m_master_id);
+        PacketPtr pkt = a.write ? Packet::createWrite(req) :
+            Packet::createRead(req);
+        pkt->allocate();
+        pkt->pushSenderState(new AccessState(a.thread));
+        m_pending[a.thread]++;
+        m_in_flight++;
+
+        a.offset += size;
+        a.remaining -= size;
+        if (a.remaining == 0) {
+            m_pending[a.thread]--;
+            m_accesses.pop_front();
+        }
+
+        if (!m_port.sendTimingReq(pkt)) {
+            m_retry_pkt = pkt;
+            return;
+        }
+    }
+}
+
+void
+TaskGraphMemory::recvResponse(PacketPtr pkt)
+{
+    AccessState *state = safe_cast<AccessState *>(pkt->popSenderState());
+    int thread = state->thread;
+    delete state;
+    delete pkt;
+
+    assert(m_in_flight > 0);
+    m_in_flight--;
+    if (--m_pending[thread] == 0) {
+        m_pending.erase(thread);
+        m_ni->dramAccessDone(m_core_idx, thread);
+    }
+}
+
+void
+TaskGraphMemory::recvRetry()
+{
+    //the refused burst goes first, the port may also retry with nothing
+    //left to send
+    if (m_retry_pkt != NULL) {
+        if (!m_port.sendTimingReq(m_retry_pkt))
+            return;
+        m_retry_pkt = NULL;
+    }
+    sendAccesses();
+}
+
+bool
+TaskGraphMemory::MemPort::recvTimingResp(PacketPtr pkt)
+{
+    m_mem.recvResponse(pkt);
+    return true;
+}
+
+void
+TaskGraphMemory::MemPort::recvReqRetry()
+{
+    m_mem.recvRetry();
+}
+
+void
+TaskGraphMemory::serialize(const std::string &base, CheckpointOut &cp) const
+{
+    assert(isDrained());
+    std::vector<int> app_idx, task_id;
+    for (int i = 0; i < m_region_task.size(); i++) {
+        app_idx.push_back(m_region_task[i].first);
+        task_id.push_back(m_region_task[i].second);
+    }
+    arrayParamOut(cp, base + ".region_app_idx", app_idx);
+    arrayParamOut(cp, base + ".region_task_id", task_id);
+    arrayParamOut(cp, base + ".write_offset", m_write_offset);
+    arrayParamOut(cp, base + ".read_offset", m_read_offset);
+}
+
+void
+TaskGraphMemory::unserialize(const std::string &base, CheckpointIn &cp)
+{
+    std::vector<int> app_idx, task_id;
+    arrayParamIn(cp, base + ".region_app_idx", app_idx);
+    arrayParamIn(cp, base + ".region_task_id", task_id);
+    arrayParamIn(cp, base + ".write_offset", m_write_offset);
+    arrayParamIn(cp, base + ".read_offset", m_read_offset);
+    if (task_id.size() != app_idx.size() ||
+        m_write_offset.size() != app_idx.size() ||
+        m_read_offset.size() != app_idx.size())
+        fatal("The checkpoint of %s is corrupted !", m_name);
+
+    m_region_index.clear();
+    m_region_task.clear();
+    for (int i = 0; i < app_idx.size(); i++) {
+        std::pair<int, int> key(app_idx[i], task_id[i]);
+        m_region_index[key] = i;
+        m_region_task.push_back(key);
+    }
+}
@@ -0,0 +1,113 @@
+#ifndef __MEM_RUBY_NETWORK_GARNET2_0_TASK_GRAPH_MEMORY_HH__
+#define __MEM_RUBY_NETWORK_GARNET2_0_TASK_GRAPH_MEMORY_HH__
+
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "mem/packet.hh"
+#include "mem/port.hh"
+#include "sim/serialize.hh"
+
+class NetworkInterface;
+
+// The memory controller (--task-graph-dram) behind a DDR core of the task
+// graph. A task of the core writes the tokens it consumes and reads the
+// tokens it produces, the accesses are split into bursts sent to the
+// controller through the ddr_port of the network, and the task ends with
+// the last response instead of after a drawn execution time. Every task
+// streams through a region of its own, so the row buffer hits, the bank
+// conflicts between the tasks and the refreshes all come from the
+// controller.
+class TaskGraphMemory
+{
+  public:
+    TaskGraphMemory(const std::string &name, SimObject *owner,
+        MasterID master_id, unsigned burst_size);
+
+    static const uint64_t region_size = 1 << 20;
+
+    Port &getPort() { return m_port; }
+    // once the port is bound
+    void init();
+    // the core served, core_idx is its index in the NI
+    void setCore(NetworkInterface *ni, int core_idx);
+
+    // bytes written or read for the task task_id of application app_idx
+    // running on thread, the NI hears from dramAccessDone once all the
+    // accesses of the thread are done
+    void access(int app_idx, int task_id, int thread, uint64_t bytes,
+        bool write);
+    // accesses of the thread not done yet
+    bool isPending(int thread) const { return m_pending.count(thread) > 0; }
+    // no access waiting or in flight
+    bool isDrained() const { return m_accesses.empty() && m_in_flight == 0; }
+
+    void serialize(const std::string &base, CheckpointOut &cp) const;
+    void unserialize(const std::string &base, CheckpointIn &cp);
+
+  private:
+    class MemPort : public MasterPort
+    {
+      public:
+        MemPort(const std::string &name, SimObject *owner,
+            TaskGraphMemory &mem)
+            : MasterPort(name, owner), m_mem(mem)
+        { }
+
+      protected:
+        bool recvTimingResp(PacketPtr pkt) override;
+        void recvReqRetry() override;
+
+      private:
+        TaskGraphMemory &m_mem;
+    };
+
+    struct AccessState : public Packet::SenderState
+    {
+        AccessState(int t) : thread(t) {}
+        int thread;
+    };
+
+    struct Access
+    {
+        int thread;
+        int region;
+        uint64_t offset;
+        uint64_t remaining;
+        bool write;
+    };
+
+    int regionIndex(int app_idx, int task_id);
+    // sends the queued accesses until the controller refuses a burst
+    void sendAccesses();
+    void recvRetry();
+    void recvResponse(PacketPtr pkt);
+
+    std::string m_name;
+    MemPort m_port;
+    MasterID m_master_id;
+    unsigned m_burst_size;
+    NetworkInterface *m_ni;
+    int m_core_idx;
+    Addr m_range_start;
+    uint64_t m_range_size;
+
+    //(app_idx, task_id) -> region, in the order of the first access
+    std::map<std::pair<int, int>, int> m_region_index;
+    std::vector<std::pair<int, int> > m_region_task;
+    std::vector<uint64_t> m_write_offset;
+    std::vector<uint64_t> m_read_offset;
+
+    std::deque<Access> m_accesses;
+    //refused by the controller, sent again on its retry
+    PacketPtr m_retry_pkt;
+    int m_in_flight;
+    //thread -> accesses queued and bursts in flight
+    std::map<int, int> m_pending;
+};
+
+#endif // __MEM_RUBY_NETWORK_GARNET2_0_TASK_GRAPH_MEMORY_HH__
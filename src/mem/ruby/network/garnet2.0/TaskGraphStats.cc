@@ -0,0 +1,310 @@
+#include "mem/ruby/network/garnet2.0/TaskGraphStats.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#include "base/logging.hh"
+
+RunningStats::RunningStats()
+    : m_count(0), m_mean(0), m_m2(0), m_min(0), m_max(0)
+{
+}
+
+void
+RunningStats::sample(double x)
+{
+    if (m_count == 0) {
+        m_min = x;
+        m_max = x;
+    } else {
+        m_min = std::min(m_min, x);
+        m_max = std::max(m_max, x);
+    }
+    m_count++;
+    double delta = x - m_mean;
+    m_mean += delta / m_count;
+    m_m2 += delta * (x - m_mean);
+}
+
+void
+RunningStats::merge(const RunningStats &other)
+{
+    if (other.m_count == 0)
+        return;
+    if (m_count == 0) {
+        *this = other;
+        return;
+    }
+    uint64_t count = m_count + other.m_count;
+    double delta = other.m_mean - m_mean;
+    m_mean += delta * other.m_count / count;
+    m_m2 += other.m_m2 +
+        delta * delta * ((double)m_count * other.m_count / count);
+    m_count = count;
+    m_min = std::min(m_min, other.m_min);
+    m_max = std::max(m_max, other.m_max);
+}
+
+double
+RunningStats::variance() const
+{
+    return (m_count < 2) ? 0 : m_m2 / (m_count - 1);
+}
+
+double
+RunningStats::stddev() const
+{
+    return sqrt(variance());
+}
+
+void
+RunningStats::serialize(const std::string &base, CheckpointOut &cp) const
+{
+    paramOut(cp, base + ".count", m_count);
+    paramOut(cp, base + ".mean", doubleToBits(m_mean));
+    paramOut(cp, base + ".m2", doubleToBits(m_m2));
+    paramOut(cp, base + ".min", doubleToBits(m_min));
+    paramOut(cp, base + ".max", doubleToBits(m_max));
+}
+
+void
+RunningStats::unserialize(const std::string &base, CheckpointIn &cp)
+{
+    uint64_t mean, m2, min, max;
+    paramIn(cp, base + ".count", m_count);
+    paramIn(cp, base + ".mean", mean);
+    paramIn(cp, base + ".m2", m2);
+    paramIn(cp, base + ".min", min);
+    paramIn(cp, base + ".max", max);
+    m_mean = bitsToDouble(mean);
+    m_m2 = bitsToDouble(m2);
+    m_min = bitsToDouble(min);
+    m_max = bitsToDouble(max);
+}
+
+QuantileSketch::QuantileSketch(double alpha)
+    : m_alpha(alpha), m_count(0), m_zero_count(0), m_min_key(0)
+{
+    assert(alpha > 0 && alpha < 1);
+    m_gamma = (1 + alpha) / (1 - alpha);
+    m_log_gamma = log(m_gamma);
+}
+
+int
+QuantileSketch::key(double x) const
+{
+    return (int)ceil(log(x) / m_log_gamma);
+}
+
+double
+QuantileSketch::value(int key) const
+{
+    //the middle of (gamma^(key-1), gamma^key] in relative terms
+    return 2 * pow(m_gamma, key) / (m_gamma + 1);
+}
+
+void
+QuantileSketch::grow(int key)
+{
+    if (m_buckets.empty()) {
+        m_min_key = key;
+        m_buckets.resize(1, 0);
+    } else if (key < m_min_key) {
+        m_buckets.insert(m_buckets.begin(), m_min_key - key, 0);
+        m_min_key = key;
+    } else if (key >= m_min_key + (int)m_buckets.size()) {
+        m_buckets.resize(key - m_min_key + 1, 0);
+    }
+}
+
+void
+QuantileSketch::sample(double x)
+{
+    assert(x >= 0);
+    m_count++;
+    //delays are whole cycles, anything below one shares the zero bucket
+    if (x < 1) {
+        m_zero_count++;
+        return;
+    }
+    int k = key(x);
+    grow(k);
+    m_buckets[k - m_min_key]++;
+}
+
+void
+QuantileSketch::merge(const QuantileSketch &other)
+{
+    if (other.m_alpha != m_alpha)
+        fatal("Cannot merge quantile sketches of different accuracy !");
+    if (!other.m_buckets.empty()) {
+        grow(other.m_min_key);
+        grow(other.m_min_key + (int)other.m_buckets.size() - 1);
+        for (int i = 0; i < other.m_buckets.size(); i++)
+            m_buckets[other.m_min_key - m_min_key + i] +=
+                other.m_buckets[i];
+    }
+    m_zero_count += other.m_zero_count;
+    m_count += other.m_count;
+}
+
+double
+QuantileSketch::quantile(double q) const
+{
+    assert(q >= 0 && q <= 1);
+    if (m_count == 0)
+        return 0;
+
+    uint64_t rank = (uint64_t)(q * (m_count - 1));
+    uint64_t seen = m_zero_count;
+    if (seen > rank)
+        return 0;
+    for (int i = 0; i < m_buckets.size(); i++) {
+        seen += m_buckets[i];
+        if (seen > rank)
+            return value(m_min_key + i);
+    }
+    return value(m_min_key + (int)m_buckets.size() - 1);
+}
+
+void
+QuantileSketch::serialize(const std::string &base, CheckpointOut &cp) const
+{
+    paramOut(cp, base + ".alpha", doubleToBits(m_alpha));
+    paramOut(cp, base + ".count", m_count);
+    paramOut(cp, base + ".zero_count", m_zero_count);
+    paramOut(cp, base + ".min_key", m_min_key);
+    arrayParamOut(cp, base + ".buckets", m_buckets);
+}
+
+void
+QuantileSketch::unserialize(const std::string &base, CheckpointIn &cp)
+{
+    uint64_t alpha;
+    paramIn(cp, base + ".alpha", alpha);
+    if (bitsToDouble(alpha) != m_alpha)
+        fatal("Cannot restore a quantile sketch of a different accuracy !");
+    paramIn(cp, base + ".count", m_count);
+    paramIn(cp, base + ".zero_count", m_zero_count);
+    paramIn(cp, base + ".min_key", m_min_key);
+    arrayParamIn(cp, base + ".buckets", m_buckets);
+}
+
+SteadyStateDetector::SteadyStateDetector(int num_batches)
+    : m_num_batches(num_batches), m_batch_size(1), m_partial_sum(0),
+      m_partial_count(0), m_count(0), m_ready(false), m_warmup_batches(0),
+      m_mean(0), m_half_width(0)
+{
+    assert(num_batches >= 4);
+}
+
+void
+SteadyStateDetector::sample(double x)
+{
+    m_count++;
+    m_partial_sum += x;
+    if (++m_partial_count < m_batch_size)
+        return;
+
+    m_batch_sum.push_back(m_partial_sum);
+    m_partial_sum = 0;
+    m_partial_count = 0;
+    if (m_batch_sum.size() == 2 * m_num_batches) {
+        for (int i = 0; i < m_num_batches; i++)
+            m_batch_sum[i] = m_batch_sum[2 * i] + m_batch_sum[2 * i + 1];
+        m_batch_sum.resize(m_num_batches);
+        m_batch_size *= 2;
+    }
+    analyze();
+}
+
+void
+SteadyStateDetector::analyze()
+{
+    int k = m_batch_sum.size();
+    m_ready = false;
+    if (k < m_num_batches)
+        return;
+
+    //MSER: with the batch means y, drop the first d minimizing
+    //sum_{j>d} (y_j - mean)^2 / (k - d)^2, from suffix sums
+    double sum = 0, sum_sq = 0;
+    double best = 0;
+    int best_d = k - 2;
+    for (int d = k - 1; d >= 0; d--) {
+        double y = m_batch_sum[d] / m_batch_size;
+        sum += y;
+        sum_sq += y * y;
+        int n = k - d;
+        if (n < 2)
+            continue;
+        double mser = std::max(sum_sq - sum * sum / n, 0.0) / n / n;
+        if (d == k - 2 || mser <= best) {
+            best = mser;
+            best_d = d;
+        }
+    }
+    m_warmup_batches = best_d;
+    //a cut in the second half means the run is still warming up
+    if (best_d > k / 2)
+        return;
+
+    int n = k - best_d;
+    RunningStats batches;
+    for (int j = best_d; j < k; j++)
+        batches.sample(m_batch_sum[j] / m_batch_size);
+    m_mean = batches.mean();
+
+    //Student t quantile of 0.975 for n - 1 degrees of freedom
+    //(Cornish-Fisher expansion, good to 1e-3 from 5 degrees on)
+    const double z = 1.959964;
+    double df = n - 1;
+    double t = z + (z * z * z + z) / (4 * df) +
+        (5 * pow(z, 5) + 16 * z * z * z + 3 * z) / (96 * df * df);
+    m_half_width = t * batches.stddev() / sqrt((double)n);
+    m_ready = true;
+}
+
+bool
+SteadyStateDetector::converged(double precision) const
+{
+    return m_ready && m_half_width <= precision * fabs(m_mean);
+}
+
+void
+SteadyStateDetector::serialize(const std::string &base,
+    CheckpointOut &cp) const
+{
+    std::vector<uint64_t> batch_sum(m_batch_sum.size());
+    for (int i = 0; i < m_batch_sum.size(); i++)
+        batch_sum[i] = doubleToBits(m_batch_sum[i]);
+    paramOut(cp, base + ".num_batches", m_num_batches);
+    paramOut(cp, base + ".batch_size", m_batch_size);
+    arrayParamOut(cp, base + ".batch_sum", batch_sum);
+    paramOut(cp, base + ".partial_sum", doubleToBits(m_partial_sum));
+    paramOut(cp, base + ".partial_count", m_partial_count);
+    paramOut(cp, base + ".count", m_count);
+}
+
+void
+SteadyStateDetector::unserialize(const std::string &base, CheckpointIn &cp)
+{
+    int num_batches;
+    paramIn(cp, base + ".num_batches", num_batches);
+    if (num_batches != m_num_batches)
+        fatal("Cannot restore a steady state detector of %d batches into "
+            "one of %d !", num_batches, m_num_batches);
+    std::vector<uint64_t> batch_sum;
+    uint64_t partial_sum;
+    paramIn(cp, base + ".batch_size", m_batch_size);
+    arrayParamIn(cp, base + ".batch_sum", batch_sum);
+    paramIn(cp, base + ".partial_sum", partial_sum);
+    paramIn(cp, base + ".partial_count", m_partial_count);
+    paramIn(cp, base + ".count", m_count);
+    m_batch_sum.resize(batch_sum.size());
+    for (int i = 0; i < batch_sum.size(); i++)
+        m_batch_sum[i] = bitsToDouble(batch_sum[i]);
+    m_partial_sum = bitsToDouble(partial_sum);
+    analyze();
+}
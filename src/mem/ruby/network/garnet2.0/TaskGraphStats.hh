@@ -0,0 +1,145 @@
+#ifndef __MEM_RUBY_NETWORK_GARNET2_0_TASK_GRAPH_STATS_HH__
+#define __MEM_RUBY_NETWORK_GARNET2_0_TASK_GRAPH_STATS_HH__
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "sim/serialize.hh"
+
+// Doubles go to a checkpoint as their bit pattern, the text form would
+// round them.
+inline uint64_t
+doubleToBits(double x)
+{
+    uint64_t bits;
+    memcpy(&bits, &x, sizeof(bits));
+    return bits;
+}
+
+inline double
+bitsToDouble(uint64_t bits)
+{
+    double x;
+    memcpy(&x, &bits, sizeof(x));
+    return x;
+}
+
+// Count, mean, variance, min and max of a stream of samples in constant
+// memory (Welford's update). Two of them merge as if all the samples had
+// been added to one (Chan et al.).
+class RunningStats
+{
+  public:
+    RunningStats();
+
+    void sample(double x);
+    void merge(const RunningStats &other);
+
+    uint64_t count() const { return m_count; }
+    double mean() const { return m_mean; }
+    //sample variance, 0 below two samples
+    double variance() const;
+    double stddev() const;
+    double min() const { return m_min; }
+    double max() const { return m_max; }
+
+    void serialize(const std::string &base, CheckpointOut &cp) const;
+    void unserialize(const std::string &base, CheckpointIn &cp);
+
+  private:
+    uint64_t m_count;
+    double m_mean;
+    //sum of the squared distances to the mean
+    double m_m2;
+    double m_min;
+    double m_max;
+};
+
+// Quantiles of a stream of non negative samples within a relative error
+// alpha (DDSketch). Sample x is counted in the bucket ceil(log_gamma(x)),
+// gamma = (1 + alpha) / (1 - alpha), so the memory only grows with the
+// log of the sample range. Sketches of the same alpha merge by adding
+// their buckets.
+class QuantileSketch
+{
+  public:
+    explicit QuantileSketch(double alpha = 0.01);
+
+    void sample(double x);
+    void merge(const QuantileSketch &other);
+
+    uint64_t count() const { return m_count; }
+    //q in [0, 1], 0 if there is no sample
+    double quantile(double q) const;
+
+    //restored only into a sketch of the same alpha
+    void serialize(const std::string &base, CheckpointOut &cp) const;
+    void unserialize(const std::string &base, CheckpointIn &cp);
+
+  private:
+    int key(double x) const;
+    double value(int key) const;
+    void grow(int key);
+
+    double m_alpha;
+    double m_gamma;
+    double m_log_gamma;
+    uint64_t m_count;
+    //samples too small to have a bucket
+    uint64_t m_zero_count;
+    //m_buckets[i] counts the key m_min_key + i
+    int m_min_key;
+    std::vector<uint64_t> m_buckets;
+};
+
+// Steady state of a stream of samples, e.g. the iteration delays of an
+// application. The samples are grouped in batches whose count stays
+// between num_batches and 2 * num_batches: when the batches are full two
+// neighbours merge and the batch size doubles. The leading batches that
+// only carry the warm-up are cut with MSER (the cut minimizing the
+// variance of the mean of what is left, searched in the first half), and
+// the rest gives the batch means estimate of the mean with its 95%
+// confidence interval.
+class SteadyStateDetector
+{
+  public:
+    explicit SteadyStateDetector(int num_batches = 32);
+
+    void sample(double x);
+
+    uint64_t count() const { return m_count; }
+    //false until there are num_batches batches and the warm-up cut
+    //falls in their first half
+    bool ready() const { return m_ready; }
+    //samples cut as warm-up
+    uint64_t warmup() const { return m_warmup_batches * m_batch_size; }
+    //mean and confidence half width of the samples after the warm-up
+    double mean() const { return m_mean; }
+    double halfWidth() const { return m_half_width; }
+    //the half width is at most precision times the mean
+    bool converged(double precision) const;
+
+    void serialize(const std::string &base, CheckpointOut &cp) const;
+    void unserialize(const std::string &base, CheckpointIn &cp);
+
+  private:
+    void analyze();
+
+    int m_num_batches;
+    uint64_t m_batch_size;
+    //sums of the complete batches
+    std::vector<double> m_batch_sum;
+    double m_partial_sum;
+    uint64_t m_partial_count;
+    uint64_t m_count;
+
+    //from the last analyze()
+    bool m_ready;
+    int m_warmup_batches;
+    double m_mean;
+    double m_half_width;
+};
+
+#endif // __MEM_RUBY_NETWORK_GARNET2_0_TASK_GRAPH_STATS_HH__
@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include "mem/ruby/network/garnet2.0/TaskGraphStats.hh"
+
+// sim/serialize.cc needs the whole simulator, the checkpoints are not
+// exercised here
+bool
+CheckpointIn::find(const std::string &section, const std::string &entry,
+    std::string &value)
+{
+    return false;
+}
+
+const std::string &
+Serializable::currentSection()
+{
+    static std::string section;
+    return section;
+}
+
+TEST(SteadyStateDetectorTest, NotReadyBeforeAllBatches)
+{
+    SteadyStateDetector detector(4);
+    for (int i = 0; i < 3; i++)
+        detector.sample(1);
+    EXPECT_EQ(3, detector.count());
+    EXPECT_FALSE(detector.ready());
+    EXPECT_FALSE(detector.converged(1));
+
+    detector.sample(1);
+    EXPECT_TRUE(detector.ready());
+    EXPECT_EQ(1, detector.mean());
+    EXPECT_EQ(0, detector.halfWidth());
+    EXPECT_TRUE(detector.converged(0.01));
+}
+
+// once there are twice num_batches batches, neighbours merge: 1, 3, 1, 3
+// ... becomes batches of mean 2
+TEST(SteadyStateDetectorTest, BatchesMerge)
+{
+    SteadyStateDetector detector(4);
+    for (int i = 0; i < 7; i++)
+        detector.sample(i % 2 ? 3 : 1);
+    EXPECT_TRUE(detector.ready());
+    EXPECT_GT(detector.halfWidth(), 0);
+
+    detector.sample(3);
+    EXPECT_EQ(8, detector.count());
+    EXPECT_TRUE(detector.ready());
+    EXPECT_EQ(2, detector.mean());
+    EXPECT_EQ(0, detector.halfWidth());
+
+    // the next batch only counts once its two samples are in
+    detector.sample(100);
+    EXPECT_EQ(2, detector.mean());
+    detector.sample(100);
+    EXPECT_GT(detector.mean(), 2);
+}
+
+// the warm-up is counted in batches, which double with the merge
+TEST(SteadyStateDetectorTest, WarmupInBatches)
+{
+    SteadyStateDetector detector(4);
+    detector.sample(10);
+    for (int i = 0; i < 6; i++)
+        detector.sample(0);
+    EXPECT_TRUE(detector.ready());
+    EXPECT_EQ(1, detector.warmup());
+    EXPECT_EQ(0, detector.mean());
+
+    // batch means 5, 0, 0, 0
+    detector.sample(0);
+    EXPECT_TRUE(detector.ready());
+    EXPECT_EQ(2, detector.warmup());
+    EXPECT_EQ(0, detector.mean());
+}
+
+TEST(SteadyStateDetectorTest, MserCutsTransient)
+{
+    std::mt19937 rng(1);
+    SteadyStateDetector detector(32);
+    for (int i = 0; i < 64; i++)
+        detector.sample(100);
+    for (int i = 0; i < 192; i++)
+        detector.sample(10 + (double)rng() / rng.max());
+
+    ASSERT_TRUE(detector.ready());
+    EXPECT_EQ(256, detector.count());
+    // the whole transient goes, and no more than the first half
+    EXPECT_GE(detector.warmup(), 64);
+    EXPECT_LE(detector.warmup(), 128);
+    EXPECT_NEAR(10.5, detector.mean(), 0.1);
+}
+
+// a stream still rising has its cut in the second half
+TEST(SteadyStateDetectorTest, TrendNotReady)
+{
+    SteadyStateDetector detector(8);
+    for (int i = 0; i < 64; i++)
+        detector.sample(i);
+    EXPECT_FALSE(detector.ready());
+    EXPECT_FALSE(detector.converged(1));
+}
+
+TEST(SteadyStateDetectorTest, ConvergesOnStationaryStream)
+{
+    std::mt19937 rng(1);
+    SteadyStateDetector detector(32);
+    for (int i = 0; i < 100000; i++)
+        detector.sample((double)rng() / rng.max());
+
+    ASSERT_TRUE(detector.ready());
+    EXPECT_LT(detector.warmup(), detector.count() / 2);
+    EXPECT_NEAR(0.5, detector.mean(), 0.01);
+    EXPECT_GT(detector.halfWidth(), 0);
+    EXPECT_LT(detector.halfWidth(), 0.01);
+    EXPECT_TRUE(detector.converged(0.02));
+    EXPECT_FALSE(detector.converged(1e-6));
+}
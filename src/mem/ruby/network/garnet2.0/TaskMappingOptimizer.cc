@@ -0,0 +1,355 @@
+#include "mem/ruby/network/garnet2.0/TaskMappingOptimizer.hh"
+
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <thread>
+
+#include "base/logging.hh"
+#include "mem/ruby/network/garnet2.0/TaskGraphBinary.hh"
+#include "mem/ruby/network/garnet2.0/TaskGraphDefinition.hh"
+
+void
+TaskMappingOptimizer::addCore(int core_id, int node_id,
+    const std::string &name, int threads, bool pinned)
+{
+    assert(m_apps.empty());
+    if (m_core_index.count(core_id))
+        fatal("Core %d is defined twice !", core_id);
+    int idx = m_core_id.size();
+    m_core_index[core_id] = idx;
+    m_core_id.push_back(core_id);
+    m_core_node.push_back(node_id);
+
+    int group = -1;
+    if (!pinned) {
+        std::string kind = name.substr(0, name.find('-'));
+        std::string key = kind + "/" + std::to_string(threads);
+        std::map<std::string, int>::iterator it = m_group_index.find(key);
+        if (it == m_group_index.end()) {
+            group = m_groups.size();
+            m_group_index[key] = group;
+            m_groups.push_back(std::vector<int>());
+        } else {
+            group = it->second;
+        }
+        m_groups[group].push_back(idx);
+    }
+    m_core_group.push_back(group);
+}
+
+void
+TaskMappingOptimizer::setNodeHops(const std::vector<std::vector<int> > &hops)
+{
+    m_hops = hops;
+}
+
+int
+TaskMappingOptimizer::coreIndex(int core_id,
+    const std::string &filename) const
+{
+    std::map<int, int>::const_iterator it = m_core_index.find(core_id);
+    if (it == m_core_index.end())
+        fatal("%s maps a task to core %d, which is not in the "
+            "architecture file !", filename, core_id);
+    return it->second;
+}
+
+void
+TaskMappingOptimizer::readTextApplication(MappingApplication &app)
+{
+    FILE *fp = fopen(app.filename.c_str(), "r");
+    if (fp == NULL)
+        fatal("Error opening the %s.stp file!", app.filename);
+
+    //the same layout GarnetNetwork::loadTextApplication reads
+    char ts[1000];
+    for (int i = 0; i < 15; i++)
+        fgets(ts, 1000, fp);
+
+    int trace_type, num_task, num_edge, num_head_task;
+    if (fscanf(fp, "%d %d %d %d %d", &trace_type, &app.num_proc,
+               &num_task, &num_edge, &num_head_task) != 5 ||
+        trace_type != 0 || num_task <= 0 || num_edge <= 0)
+        fatal("%s is not a task graph file !", app.filename);
+
+    app.head_task.resize(num_head_task);
+    for (int i = 0; i < num_head_task; i++)
+        fscanf(fp, "%d", &app.head_task[i]);
+
+    app.tasks.resize(num_task);
+    for (int i = 0; i < num_task; i++) {
+        MappingTask &t = app.tasks[i];
+        if (fscanf(fp, "%d %d %d %f %f", &t.id, &t.proc, &t.schedule,
+                   &t.mu, &t.sigma) != 5)
+            fatal("%s is truncated !", app.filename);
+    }
+
+    app.edges.resize(num_edge);
+    for (int i = 0; i < num_edge; i++) {
+        MappingEdge &e = app.edges[i];
+        for (int f = 0; f < 9; f++)
+            if (fscanf(fp, "%d", &e.v[f]) != 1)
+                fatal("%s is truncated !", app.filename);
+        for (int f = 0; f < 3; f++)
+            if (fscanf(fp, "%f", &e.d[f]) != 1)
+                fatal("%s is truncated !", app.filename);
+    }
+    fclose(fp);
+}
+
+void
+TaskMappingOptimizer::readBinaryApplication(MappingApplication &app)
+{
+    TaskGraphBinary tgb;
+    tgb.load(app.filename);
+    const TaskGraphBinaryHeader &h = tgb.getHeader();
+
+    app.num_proc = h.num_proc;
+    app.head_task.assign(tgb.head_task, tgb.head_task + h.num_head_task);
+    app.tasks.resize(h.num_task);
+    for (int i = 0; i < h.num_task; i++) {
+        MappingTask &t = app.tasks[i];
+        t.id = tgb.task_id[i];
+        t.proc = tgb.task_proc[i];
+        t.schedule = tgb.task_schedule[i];
+        t.mu = tgb.task_mu[i];
+        t.sigma = tgb.task_sigma[i];
+    }
+    app.edges.resize(h.num_edge);
+    for (int i = 0; i < h.num_edge; i++) {
+        MappingEdge &e = app.edges[i];
+        for (int f = 0; f < TaskGraphBinary::NUM_EDGE_FIELDS; f++)
+            e.v[f] = tgb.edge_field[f][i];
+        e.d[0] = tgb.token_mu[i];
+        e.d[1] = tgb.token_sigma[i];
+        e.d[2] = tgb.pkt_lambda[i];
+    }
+}
+
+void
+TaskMappingOptimizer::addApplication(const std::string &filename,
+    int iterations)
+{
+    m_apps.push_back(MappingApplication());
+    MappingApplication &app = m_apps.back();
+    app.filename = filename;
+    app.iterations = iterations;
+    if (TaskGraphBinary::isTaskGraphBinary(filename))
+        readBinaryApplication(app);
+    else
+        readTextApplication(app);
+
+    int num_cores = m_core_id.size();
+    if (m_traffic.empty())
+        m_traffic.assign(num_cores, std::vector<double>(num_cores, 0));
+    for (int i = 0; i < app.tasks.size(); i++)
+        coreIndex(app.tasks[i].proc, filename);
+    for (int i = 0; i < app.edges.size(); i++) {
+        const MappingEdge &e = app.edges[i];
+        int src = coreIndex(e.v[TaskGraphBinary::EDGE_SRC_PROC], filename);
+        int dst = coreIndex(e.v[TaskGraphBinary::EDGE_DST_PROC], filename);
+        m_traffic[src][dst] += (double)e.d[0] * iterations;
+    }
+}
+
+double
+TaskMappingOptimizer::cost(const std::vector<int> &place) const
+{
+    double sum = 0;
+    for (int i = 0; i < place.size(); i++)
+        for (int j = 0; j < place.size(); j++)
+            if (m_traffic[i][j] != 0)
+                sum += m_traffic[i][j] * hops(place[i], place[j]);
+    return sum;
+}
+
+double
+TaskMappingOptimizer::cost(const std::vector<int> &place, int a, int b) const
+{
+    double sum = 0;
+    for (int j = 0; j < place.size(); j++)
+        sum += m_traffic[a][j] * hops(place[a], place[j]) +
+            m_traffic[b][j] * hops(place[b], place[j]);
+    for (int i = 0; i < place.size(); i++) {
+        if (i == a || i == b)
+            continue;
+        sum += m_traffic[i][a] * hops(place[i], place[a]) +
+            m_traffic[i][b] * hops(place[i], place[b]);
+    }
+    return sum;
+}
+
+void
+TaskMappingOptimizer::anneal(int thread, int num_moves, uint32_t seed)
+{
+    TaskGraphRNG rng;
+    rng.seed(seed, TG_MAPPING_STREAM, 0, thread);
+
+    int num_cores = m_core_id.size();
+    std::vector<int> place(num_cores);
+    for (int i = 0; i < num_cores; i++)
+        place[i] = i;
+    //the first thread starts from the mapping of the files, the others
+    //from a shuffle of every group
+    if (thread > 0) {
+        for (int g = 0; g < m_groups.size(); g++) {
+            const std::vector<int> &group = m_groups[g];
+            for (int i = group.size() - 1; i > 0; i--) {
+                int j = rng.next() % (i + 1);
+                std::swap(place[group[i]], place[group[j]]);
+            }
+        }
+    }
+
+    double current = cost(place);
+    m_thread_cost[thread] = current;
+    m_thread_place[thread] = place;
+    if (m_movable.empty() || num_moves == 0)
+        return;
+
+    //a swap of two cores of the same group
+    auto pick = [&](int &a, int &b) {
+        a = m_movable[rng.next() % m_movable.size()];
+        const std::vector<int> &group = m_groups[m_core_group[a]];
+        b = group[rng.next() % (group.size() - 1)];
+        if (b == a)
+            b = group.back();
+    };
+    auto delta = [&](int a, int b) {
+        double before = cost(place, a, b);
+        std::swap(place[a], place[b]);
+        double after = cost(place, a, b);
+        std::swap(place[a], place[b]);
+        return after - before;
+    };
+
+    //start where an average uphill swap is taken half of the time and
+    //cool down a thousand times over the moves
+    const int num_samples = 100;
+    double uphill = 0;
+    int num_uphill = 0;
+    for (int i = 0; i < num_samples; i++) {
+        int a, b;
+        pick(a, b);
+        double d = delta(a, b);
+        if (d > 0) {
+            uphill += d;
+            num_uphill++;
+        }
+    }
+    if (num_uphill == 0)
+        return;
+    double temperature = uphill / num_uphill / log(2.0);
+    double cooling = pow(1e-3, 1.0 / num_moves);
+
+    for (int m = 0; m < num_moves; m++) {
+        int a, b;
+        pick(a, b);
+        double d = delta(a, b);
+        if (d <= 0 || rng.uniform() < exp(-d / temperature)) {
+            std::swap(place[a], place[b]);
+            current += d;
+            if (current < m_thread_cost[thread]) {
+                //recomputed, the deltas add up rounding errors
+                current = cost(place);
+                m_thread_cost[thread] = current;
+                m_thread_place[thread] = place;
+            }
+        }
+        temperature *= cooling;
+    }
+}
+
+void
+TaskMappingOptimizer::search(int num_threads, int num_moves, uint32_t seed)
+{
+    assert(num_threads >= 1);
+    int num_cores = m_core_id.size();
+    if (m_traffic.empty())
+        m_traffic.assign(num_cores, std::vector<double>(num_cores, 0));
+    for (int i = 0; i < num_cores; i++)
+        if (m_core_node[i] >= m_hops.size())
+            fatal("Core %d is on node %d, which has no router !",
+                m_core_id[i], m_core_node[i]);
+
+    m_movable.clear();
+    for (int i = 0; i < num_cores; i++)
+        if (m_core_group[i] >= 0 && m_groups[m_core_group[i]].size() > 1)
+            m_movable.push_back(i);
+
+    std::vector<int> identity(num_cores);
+    for (int i = 0; i < num_cores; i++)
+        identity[i] = i;
+    m_initial_cost = cost(identity);
+
+    m_thread_cost.assign(num_threads, 0);
+    m_thread_place.assign(num_threads, std::vector<int>());
+    std::vector<std::thread> threads;
+    for (int t = 1; t < num_threads; t++)
+        threads.push_back(std::thread(&TaskMappingOptimizer::anneal, this,
+            t, num_moves, seed));
+    anneal(0, num_moves, seed);
+    for (int t = 0; t < threads.size(); t++)
+        threads[t].join();
+
+    //the lowest thread wins a tie, the result does not depend on timing
+    int best = 0;
+    for (int t = 1; t < num_threads; t++)
+        if (m_thread_cost[t] < m_thread_cost[best])
+            best = t;
+    m_best_cost = m_thread_cost[best];
+    m_best_place = m_thread_place[best];
+}
+
+int
+TaskMappingOptimizer::getMappedCore(int core_id) const
+{
+    std::map<int, int>::const_iterator it = m_core_index.find(core_id);
+    if (it == m_core_index.end() || m_best_place.empty())
+        return core_id;
+    return m_core_id[m_best_place[it->second]];
+}
+
+void
+TaskMappingOptimizer::writeApplication(int k, std::ostream &os) const
+{
+    const MappingApplication &app = m_apps[k];
+
+    //15 header lines, as the generator writes them
+    os << "/********************************************************\n";
+    os << "*\n";
+    os << "* File Name:      \t" << app.filename << "\n";
+    os << "* Tool:           \tgem5 task mapping search\n";
+    os << "* Mapping Cost:   \t" << m_initial_cost << " -> "
+       << m_best_cost << "\n";
+    os << "* Number of Tasks:\t" << app.tasks.size() << "\n";
+    os << "* Number of Edges:\t" << app.edges.size() << "\n";
+    for (int i = 0; i < 7; i++)
+        os << "*\n";
+    os << "********************************************************/\n";
+
+    os << 0 << "\t" << app.num_proc << "\t" << app.tasks.size() << "\t"
+       << app.edges.size() << "\n";
+    os << app.head_task.size();
+    for (int i = 0; i < app.head_task.size(); i++)
+        os << "\t" << app.head_task[i];
+    os << "\n";
+
+    for (int i = 0; i < app.tasks.size(); i++) {
+        const MappingTask &t = app.tasks[i];
+        os << t.id << "\t" << getMappedCore(t.proc) << "\t" << t.schedule
+           << "\t" << t.mu << "\t" << t.sigma << "\n";
+    }
+    for (int i = 0; i < app.edges.size(); i++) {
+        const MappingEdge &e = app.edges[i];
+        for (int f = 0; f < 9; f++) {
+            int v = e.v[f];
+            if (f == TaskGraphBinary::EDGE_SRC_PROC ||
+                f == TaskGraphBinary::EDGE_DST_PROC)
+                v = getMappedCore(v);
+            os << v << "\t";
+        }
+        os << e.d[0] << "\t" << e.d[1] << "\t" << e.d[2] << "\n";
+    }
+}
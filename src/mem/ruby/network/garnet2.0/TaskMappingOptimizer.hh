@@ -0,0 +1,113 @@
+#ifndef __MEM_RUBY_NETWORK_GARNET2_0_TASK_MAPPING_OPTIMIZER_HH__
+#define __MEM_RUBY_NETWORK_GARNET2_0_TASK_MAPPING_OPTIMIZER_HH__
+
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// Search of the task to core mapping of the task graph applications,
+// inside the simulator instead of one gem5 run per candidate. A candidate
+// moves all the tasks of a core to another core of the same kind (core
+// name up to the '-', e.g. PE or DDR) and the same number of threads, so
+// the load of every core and the schedule of its tasks do not change.
+// Its cost is the hop weighted traffic: for every edge, the mean token
+// size times the iterations of its application times the hops between
+// the routers of the two cores. Every thread anneals its own permutation
+// from its own random stream, the best one wins, so a search only depends
+// on the seed and the number of threads.
+class TaskMappingOptimizer
+{
+  public:
+    TaskMappingOptimizer() {}
+
+    // a pinned core keeps its tasks
+    void addCore(int core_id, int node_id, const std::string &name,
+        int threads, bool pinned);
+    // hops[n1][n2] between the routers of the nodes n1 and n2
+    void setNodeHops(const std::vector<std::vector<int> > &hops);
+    // an application (.stp or .tgb) run for iterations iterations
+    void addApplication(const std::string &filename, int iterations);
+
+    // num_moves swaps of simulated annealing on each of num_threads
+    // threads
+    void search(int num_threads, int num_moves, uint32_t seed);
+
+    double getInitialCost() const { return m_initial_cost; }
+    double getBestCost() const { return m_best_cost; }
+    // the core running the tasks of core_id in the best mapping
+    int getMappedCore(int core_id) const;
+    // application k remapped to the best mapping, in the .stp format
+    void writeApplication(int k, std::ostream &os) const;
+
+    // hop weighted traffic of the cores placed by place, in core indices
+    // (the order of addCore), and the part of it from and to the cores a
+    // and b: a swap of a and b changes both by the same amount
+    double cost(const std::vector<int> &place) const;
+    double cost(const std::vector<int> &place, int a, int b) const;
+
+  private:
+    struct MappingTask
+    {
+        int id;
+        int proc;
+        int schedule;
+        float mu;
+        float sigma;
+    };
+
+    struct MappingEdge
+    {
+        //the int fields in TaskGraphBinary::EdgeField order
+        int v[9];
+        //token size mu and sigma, pkt interval lambda
+        float d[3];
+    };
+
+    struct MappingApplication
+    {
+        std::string filename;
+        int iterations;
+        int num_proc;
+        std::vector<int> head_task;
+        std::vector<MappingTask> tasks;
+        std::vector<MappingEdge> edges;
+    };
+
+    void readTextApplication(MappingApplication &app);
+    void readBinaryApplication(MappingApplication &app);
+    int coreIndex(int core_id, const std::string &filename) const;
+
+    int
+    hops(int slot1, int slot2) const
+    {
+        return m_hops[m_core_node[slot1]][m_core_node[slot2]];
+    }
+    void anneal(int thread, int num_moves, uint32_t seed);
+
+    std::vector<int> m_core_id;
+    std::map<int, int> m_core_index;
+    std::vector<int> m_core_node;
+    //cores that may trade their tasks, by kind and number of threads
+    std::vector<int> m_core_group;
+    std::vector<std::vector<int> > m_groups;
+    //cores of the groups of two or more
+    std::vector<int> m_movable;
+    std::map<std::string, int> m_group_index;
+    std::vector<std::vector<int> > m_hops;
+
+    std::vector<MappingApplication> m_apps;
+    //m_traffic[i][j], from core index i to core index j
+    std::vector<std::vector<double> > m_traffic;
+
+    //per thread: best cost and placement, place[i] is the core index
+    //running the tasks of core index i
+    std::vector<double> m_thread_cost;
+    std::vector<std::vector<int> > m_thread_place;
+    std::vector<int> m_best_place;
+    double m_initial_cost;
+    double m_best_cost;
+};
+
+#endif // __MEM_RUBY_NETWORK_GARNET2_0_TASK_MAPPING_OPTIMIZER_HH__
@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "mem/ruby/network/garnet2.0/TaskMappingOptimizer.hh"
+#include "sim/serialize.hh"
+
+// sim/serialize.cc needs the whole simulator, the checkpoints are not
+// exercised here
+bool
+CheckpointIn::find(const std::string &section, const std::string &entry,
+    std::string &value)
+{
+    return false;
+}
+
+const std::string &
+Serializable::currentSection()
+{
+    static std::string section;
+    return section;
+}
+
+// 8 cores on a 2x4 mesh, core i on node i, and an application whose edges
+// go between them in both directions, to the same core and with different
+// token sizes
+static const char application[] =
+    "*\n*\n*\n*\n*\n*\n*\n*\n*\n*\n*\n*\n*\n*\n*\n"
+    "0 8 8 10\n"
+    "1 0\n"
+    "0 0 0 10 0\n1 1 0 10 0\n2 2 0 10 0\n3 3 0 10 0\n"
+    "4 4 0 10 0\n5 5 0 10 0\n6 6 0 10 0\n7 7 0 10 0\n"
+    "0 0 1 0 1 0 -1 0 10 100 0 0.1\n"
+    "1 1 0 1 0 0 -1 0 10 30 0 0.1\n"
+    "2 1 2 1 2 0 -1 0 10 250 0 0.1\n"
+    "3 2 7 2 7 0 -1 0 10 40 0 0.1\n"
+    "4 7 3 7 3 0 -1 0 10 75 0 0.1\n"
+    "5 3 4 3 4 0 -1 0 10 10 0 0.1\n"
+    "6 4 6 4 6 0 -1 0 10 500 0 0.1\n"
+    "7 6 5 6 5 0 -1 0 10 60 0 0.1\n"
+    "8 5 0 5 0 0 -1 0 10 20 0 0.1\n"
+    "9 5 5 5 5 0 -1 0 10 90 0 0.1\n";
+
+class TaskMappingOptimizerTest : public testing::Test
+{
+  protected:
+    void
+    SetUp() override
+    {
+        for (int i = 0; i < 8; i++)
+            optimizer.addCore(i, i, "PE-" + std::to_string(i), 1, false);
+        std::vector<std::vector<int> > hops(8, std::vector<int>(8));
+        for (int i = 0; i < 8; i++)
+            for (int j = 0; j < 8; j++)
+                hops[i][j] = abs(i / 4 - j / 4) + abs(i % 4 - j % 4);
+        optimizer.setNodeHops(hops);
+
+        char filename[] = "mapping-XXXXXX";
+        int fd = mkstemp(filename);
+        ASSERT_NE(-1, fd);
+        ssize_t size = write(fd, application, sizeof(application) - 1);
+        ASSERT_EQ(sizeof(application) - 1, size);
+        close(fd);
+        optimizer.addApplication(filename, 10);
+        unlink(filename);
+    }
+
+    TaskMappingOptimizer optimizer;
+};
+
+TEST_F(TaskMappingOptimizerTest, FullCost)
+{
+    std::vector<int> place = { 0, 1, 2, 3, 4, 5, 6, 7 };
+    // token size times iterations times hops, edge by edge
+    double expected = (100 * 1 + 30 * 1 + 250 * 1 + 40 * 2 + 75 * 1 +
+                       10 * 4 + 500 * 2 + 60 * 1 + 20 * 2 + 90 * 0) * 10;
+    EXPECT_DOUBLE_EQ(expected, optimizer.cost(place));
+
+    // cores 0 and 1 trade their nodes, the hops between them stay
+    std::swap(place[0], place[1]);
+    expected += (250 * (2 - 1) + 20 * (1 - 2)) * 10;
+    EXPECT_DOUBLE_EQ(expected, optimizer.cost(place));
+}
+
+// the annealing only computes the traffic of the two swapped cores, its
+// change must be the change of the full cost
+TEST_F(TaskMappingOptimizerTest, IncrementalCostOfSwap)
+{
+    std::mt19937 rng(1);
+    std::vector<int> place = { 0, 1, 2, 3, 4, 5, 6, 7 };
+    for (int n = 0; n < 1000; n++) {
+        std::shuffle(place.begin(), place.end(), rng);
+        int a = rng() % 8;
+        int b = (a + 1 + rng() % 7) % 8;
+
+        double full = optimizer.cost(place);
+        double part = optimizer.cost(place, a, b);
+        std::vector<int> swapped = place;
+        std::swap(swapped[a], swapped[b]);
+
+        EXPECT_NEAR(optimizer.cost(swapped) - full,
+                    optimizer.cost(swapped, a, b) - part, 1e-6 * full);
+        EXPECT_LE(part, full);
+    }
+}
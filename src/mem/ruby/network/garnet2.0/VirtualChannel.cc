@@ -33,11 +33,10 @@
 
 #include "mem/ruby/network/garnet2.0/VirtualChannel.hh"
 
-VirtualChannel::VirtualChannel(int id)
-    : m_enqueue_time(INFINITE_)
+VirtualChannel::VirtualChannel(int id, int buffer_depth)
+    : m_input_buffer(buffer_depth), m_enqueue_time(INFINITE_)
 {
     m_id = id;
-    m_input_buffer = new flitBuffer();
     m_vc_state.first = IDLE_;
     m_vc_state.second = Cycles(0);
     m_output_vc = -1;
@@ -46,7 +45,6 @@ VirtualChannel::VirtualChannel(int id)
 
 VirtualChannel::~VirtualChannel()
 {
-    delete m_input_buffer;
 }
 
 void
@@ -70,9 +68,9 @@ VirtualChannel::set_active(Cycles curTime)
 bool
 VirtualChannel::need_stage(flit_stage stage, Cycles time)
 {
-    if (m_input_buffer->isReady(time)) {
+    if (m_input_buffer.isReady(time)) {
         assert(m_vc_state.first == ACTIVE_ && m_vc_state.second <= time);
-        flit *t_flit = m_input_buffer->peekTopFlit();
+        flit *t_flit = m_input_buffer.peekTopFlit();
         return(t_flit->is_stage(stage, time));
     }
     return false;
@@ -81,5 +79,5 @@ VirtualChannel::need_stage(flit_stage stage, Cycles time)
 uint32_t
 VirtualChannel::functionalWrite(Packet *pkt)
 {
-    return m_input_buffer->functionalWrite(pkt);
+    return m_input_buffer.functionalWrite(pkt);
 }
@@ -42,7 +42,8 @@
 class VirtualChannel
 {
   public:
-    VirtualChannel(int id);
+    // the input buffer holds buffer_depth flits, the credits of the VC
+    VirtualChannel(int id, int buffer_depth);
     ~VirtualChannel();
 
     bool need_stage(flit_stage stage, Cycles time);
@@ -59,13 +60,16 @@ class VirtualChannel
 
     inline bool isReady(Cycles curTime)
     {
-        return m_input_buffer->isReady(curTime);
+        return m_input_buffer.isReady(curTime);
     }
 
+    inline bool isEmpty() { return m_input_buffer.isEmpty(); }
+    inline int getSize() { return m_input_buffer.getSize(); }
+
     inline void
     insertFlit(flit *t_flit)
     {
-        m_input_buffer->insert(t_flit);
+        m_input_buffer.insert(t_flit);
     }
 
     inline void
@@ -78,20 +82,20 @@ class VirtualChannel
     inline flit*
     peekTopFlit()
     {
-        return m_input_buffer->peekTopFlit();
+        return m_input_buffer.peekTopFlit();
     }
 
     inline flit*
     getTopFlit()
     {
-        return m_input_buffer->getTopFlit();
+        return m_input_buffer.getTopFlit();
     }
 
     uint32_t functionalWrite(Packet *pkt);
 
   private:
     int m_id;
-    flitBuffer *m_input_buffer;
+    flitBuffer m_input_buffer;
     std::pair<VC_state_type, Cycles> m_vc_state;
     int m_output_port;
     Cycles m_enqueue_time;
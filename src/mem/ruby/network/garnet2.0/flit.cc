@@ -34,7 +34,7 @@
 #include "mem/ruby/network/garnet2.0/flit.hh"
 
 // Constructor for the flit
-flit::flit(int id, int  vc, int vnet, RouteInfo route, int size,
+flit::flit(int id, int  vc, int vnet, const RouteInfo &route, int size,
     MsgPtr msg_ptr, Cycles curTime)
 {
     m_size = size;
@@ -46,6 +46,8 @@ flit::flit(int id, int  vc, int vnet, RouteInfo route, int size,
     m_vnet = vnet;
     m_vc = vc;
     m_route = route;
+    m_lookahead_outport = -1;
+    m_smart_hops = 0;
     m_stage.first = I_;
     m_stage.second = m_time;
 
@@ -61,8 +63,8 @@ flit::flit(int id, int  vc, int vnet, RouteInfo route, int size,
         m_type = BODY_;
 }
 
-flit::flit(int id, int  vc, int vnet, RouteInfo route, int size,
-    MsgPtr msg_ptr, Cycles curTime, TGInfo tg)
+flit::flit(int id, int  vc, int vnet, const RouteInfo &route, int size,
+    MsgPtr msg_ptr, Cycles curTime, const TGInfo &tg)
 {
     m_size = size;
     m_msg_ptr = msg_ptr;
@@ -73,6 +75,8 @@ flit::flit(int id, int  vc, int vnet, RouteInfo route, int size,
     m_vnet = vnet;
     m_vc = vc;
     m_route = route;
+    m_lookahead_outport = -1;
+    m_smart_hops = 0;
     m_stage.first = I_;
     m_stage.second = m_time;
     m_tg_info = tg;
@@ -89,6 +93,106 @@ flit::flit(int id, int  vc, int vnet, RouteInfo route, int size,
         m_type = BODY_;
 }
 
+SlabPool &
+flit::pool()
+{
+    //never destroyed, flits may still be freed during teardown
+    static SlabPool *p = new SlabPool(sizeof(flit));
+    return *p;
+}
+
+void *
+flit::operator new(size_t size)
+{
+    //a derived class without its own pool
+    if (size != sizeof(flit))
+        return ::operator new(size);
+    return pool().alloc();
+}
+
+void
+flit::operator delete(void *p, size_t size)
+{
+    if (size != sizeof(flit))
+        ::operator delete(p);
+    else
+        pool().free(p);
+}
+
+// fields of a flit in a checkpoint
+static const int num_checkpoint_fields = 27;
+
+void
+flit::serializeList(CheckpointOut &cp, const std::string &base,
+                    const std::vector<flit *> &flits)
+{
+    std::vector<int64_t> fields;
+    fields.reserve(flits.size() * num_checkpoint_fields);
+    for (int i = 0; i < flits.size(); i++) {
+        const flit *f = flits[i];
+        assert(f->m_msg_ptr == nullptr);
+        int64_t v[num_checkpoint_fields] = {
+            f->m_id, f->m_vnet, f->m_vc, f->m_size, f->m_type,
+            f->m_route.vnet, f->m_route.src_ni, f->m_route.src_router,
+            f->m_route.dest_ni, f->m_route.dest_router,
+            f->m_route.hops_traversed, f->m_route.vc_choice,
+            (int64_t)f->m_enqueue_time, (int64_t)f->m_dequeue_time,
+            (int64_t)f->m_time, (int64_t)f->src_delay,
+            f->m_outport, f->m_lookahead_outport, f->m_smart_hops,
+            f->m_stage.first, (int64_t)f->m_stage.second,
+            f->m_tg_info.src_task, f->m_tg_info.dest_task,
+            f->m_tg_info.edge_id, f->m_tg_info.token_id,
+            f->m_tg_info.token_length_in_pkt, f->m_tg_info.app_idx
+        };
+        fields.insert(fields.end(), v, v + num_checkpoint_fields);
+    }
+    arrayParamOut(cp, base + ".flits", fields);
+}
+
+void
+flit::unserializeList(CheckpointIn &cp, const std::string &base,
+                      std::vector<flit *> &flits)
+{
+    std::vector<int64_t> fields;
+    arrayParamIn(cp, base + ".flits", fields);
+    if (fields.size() % num_checkpoint_fields != 0)
+        fatal("Corrupted flit list %s in the checkpoint !", base);
+
+    assert(flits.empty());
+    for (int i = 0; i < fields.size(); i += num_checkpoint_fields) {
+        const int64_t *v = &fields[i];
+        flit *f = new flit();
+        f->m_id = v[0];
+        f->m_vnet = v[1];
+        f->m_vc = v[2];
+        f->m_size = v[3];
+        f->m_type = (flit_type)v[4];
+        f->m_route.vnet = v[5];
+        f->m_route.src_ni = v[6];
+        f->m_route.src_router = v[7];
+        f->m_route.dest_ni = v[8];
+        f->m_route.dest_router = v[9];
+        f->m_route.hops_traversed = v[10];
+        f->m_route.vc_choice = v[11];
+        f->m_enqueue_time = Cycles(v[12]);
+        f->m_dequeue_time = Cycles(v[13]);
+        f->m_time = Cycles(v[14]);
+        f->src_delay = Cycles(v[15]);
+        f->m_outport = v[16];
+        f->m_lookahead_outport = v[17];
+        f->m_smart_hops = v[18];
+        f->m_stage.first = (flit_stage)v[19];
+        f->m_stage.second = Cycles(v[20]);
+        f->m_tg_info.src_task = v[21];
+        f->m_tg_info.dest_task = v[22];
+        f->m_tg_info.edge_id = v[23];
+        f->m_tg_info.token_id = v[24];
+        f->m_tg_info.token_length_in_pkt = v[25];
+        f->m_tg_info.app_idx = v[26];
+        flits.push_back(f);
+    }
+}
+
 // Flit can be printed out for debugging purposes
 void
 flit::print(std::ostream& out) const
@@ -36,22 +36,28 @@
 
 #include <cassert>
 #include <iostream>
+#include <string>
+#include <vector>
 
 #include "base/types.hh"
 #include "mem/ruby/network/garnet2.0/CommonTypes.hh"
+#include "mem/ruby/network/garnet2.0/SlabPool.hh"
 #include "mem/ruby/slicc_interface/Message.hh"
+#include "sim/serialize.hh"
 
 class flit
 {
   public:
     flit() {}
-    flit(int id, int vc, int vnet, RouteInfo route, int size,
+    flit(int id, int vc, int vnet, const RouteInfo &route, int size,
          MsgPtr msg_ptr, Cycles curTime);
 
-    flit(int id, int vc, int vnet, RouteInfo route, int size,
-         MsgPtr msg_ptr, Cycles curTime, TGInfo tg);
+    flit(int id, int vc, int vnet, const RouteInfo &route, int size,
+         MsgPtr msg_ptr, Cycles curTime, const TGInfo &tg);
 
     int get_outport() {return m_outport; }
+    // outport at the next router, computed on the link, -1 if none
+    int get_lookahead_outport() { return m_lookahead_outport; }
     int get_size() { return m_size; }
     Cycles get_enqueue_time() { return m_enqueue_time; }
     Cycles get_dequeue_time() { return m_dequeue_time; }
@@ -59,24 +65,28 @@ class flit
     Cycles get_time() { return m_time; }
     int get_vnet() { return m_vnet; }
     int get_vc() { return m_vc; }
-    RouteInfo get_route() { return m_route; }
+    const RouteInfo &get_route() const { return m_route; }
     MsgPtr& get_msg_ptr() { return m_msg_ptr; }
     flit_type get_type() { return m_type; }
     std::pair<flit_stage, Cycles> get_stage() { return m_stage; }
     Cycles get_src_delay() { return src_delay; }
-    TGInfo get_tg_info() { return m_tg_info; }
+    const TGInfo &get_tg_info() const { return m_tg_info; }
 
     void set_outport(int port) { m_outport = port; }
+    void set_lookahead_outport(int port) { m_lookahead_outport = port; }
     void set_time(Cycles time) { m_time = time; }
     void set_vc(int vc) { m_vc = vc; }
-    void set_route(RouteInfo route) { m_route = route; }
+    void set_route(const RouteInfo &route) { m_route = route; }
     void set_src_delay(Cycles delay) { src_delay = delay; }
     void set_dequeue_time(Cycles time) { m_dequeue_time = time; }
     void set_enqueue_time(Cycles time) { m_enqueue_time = time; }
-    void set_tg_info(TGInfo tg) { m_tg_info = tg; }
+    void set_tg_info(const TGInfo &tg) { m_tg_info = tg; }
     void set_num_flits(int num_flits) { m_size = num_flits; }
 
     void increment_hops() { m_route.hops_traversed++; }
+    // routers crossed without stopping (SMART)
+    int get_smart_hops() { return m_smart_hops; }
+    void increment_smart_hops() { m_smart_hops++; }
     void print(std::ostream& out) const;
 
     bool
@@ -106,6 +116,18 @@ class flit
 
     bool functionalWrite(Packet *pkt);
 
+    // flits are recycled through a slab pool, new and delete as usual
+    static void *operator new(size_t size);
+    static void operator delete(void *p, size_t size);
+    static const SlabPool &getPool() { return pool(); }
+
+    // task graph flits of a buffer under base in the current checkpoint
+    // section, they carry no protocol message
+    static void serializeList(CheckpointOut &cp, const std::string &base,
+                              const std::vector<flit *> &flits);
+    static void unserializeList(CheckpointIn &cp, const std::string &base,
+                                std::vector<flit *> &flits);
+
   protected:
     int m_id;
     int m_vnet;
@@ -116,10 +138,15 @@ class flit
     flit_type m_type;
     MsgPtr m_msg_ptr;
     int m_outport;
+    int m_lookahead_outport;
+    int m_smart_hops;
     Cycles src_delay;
     std::pair<flit_stage, Cycles> m_stage;
     //Task graph related information
     TGInfo m_tg_info;
+
+  private:
+    static SlabPool &pool();
 };
 
 inline std::ostream&
@@ -130,11 +157,4 @@ operator<<(std::ostream& out, const flit& obj)
     return out;
 }
 
-
-struct generator_buffer_type
-{
-    int time_to_generate_flit;
-    flit *flit_to_generate;
-};
-
 #endif // __MEM_RUBY_NETWORK_GARNET2_0_FLIT_HH__
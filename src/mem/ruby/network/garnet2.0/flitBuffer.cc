@@ -33,26 +33,40 @@
 
 #include "mem/ruby/network/garnet2.0/flitBuffer.hh"
 
+// ring size for a buffer of n flits
+static unsigned int
+ringSize(int n)
+{
+    unsigned int size = 4;
+    while (size < (unsigned int)n)
+        size <<= 1;
+    return size;
+}
+
 flitBuffer::flitBuffer()
+    : m_ring(ringSize(1)), m_head(0), m_count(0)
 {
+    m_mask = m_ring.size() - 1;
     max_size = INFINITE_;
 }
 
 flitBuffer::flitBuffer(int maximum_size)
+    : m_ring(ringSize(maximum_size)), m_head(0), m_count(0)
 {
+    m_mask = m_ring.size() - 1;
     max_size = maximum_size;
 }
 
 bool
 flitBuffer::isEmpty()
 {
-    return (m_buffer.size() == 0);
+    return (m_count == 0);
 }
 
 bool
 flitBuffer::isReady(Cycles curTime)
 {
-    if (m_buffer.size() != 0 ) {
+    if (m_count != 0) {
         flit *t_flit = peekTopFlit();
         if (t_flit->get_time() <= curTime)
             return true;
@@ -63,13 +77,13 @@ flitBuffer::isReady(Cycles curTime)
 void
 flitBuffer::print(std::ostream& out) const
 {
-    out << "[flitBuffer: " << m_buffer.size() << "] " << std::endl;
+    out << "[flitBuffer: " << m_count << "] " << std::endl;
 }
 
 bool
 flitBuffer::isFull()
 {
-    return (m_buffer.size() >= max_size);
+    return (m_count >= max_size);
 }
 
 void
@@ -78,13 +92,38 @@ flitBuffer::setMaxSize(int maximum)
     max_size = maximum;
 }
 
+void
+flitBuffer::grow()
+{
+    std::vector<flit *> ring(m_ring.size() * 2);
+    for (unsigned int i = 0; i < m_count; i++)
+        ring[i] = m_ring[(m_head + i) & m_mask];
+    m_ring.swap(ring);
+    m_head = 0;
+    m_mask = m_ring.size() - 1;
+}
+
+// The flit at the tail is earlier than the one before it, move it back
+// until the ring is sorted again.
+void
+flitBuffer::sortTail()
+{
+    unsigned int i = (m_head + m_count - 1) & m_mask;
+    flit *flt = m_ring[i];
+    while (i != m_head && flit::greater(m_ring[(i - 1) & m_mask], flt)) {
+        m_ring[i] = m_ring[(i - 1) & m_mask];
+        i = (i - 1) & m_mask;
+    }
+    m_ring[i] = flt;
+}
+
 uint32_t
 flitBuffer::functionalWrite(Packet *pkt)
 {
     uint32_t num_functional_writes = 0;
 
-    for (unsigned int i = 0; i < m_buffer.size(); ++i) {
-        if (m_buffer[i]->functionalWrite(pkt)) {
+    for (unsigned int i = 0; i < m_count; ++i) {
+        if (m_ring[(m_head + i) & m_mask]->functionalWrite(pkt)) {
             num_functional_writes++;
         }
     }
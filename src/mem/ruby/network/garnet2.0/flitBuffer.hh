@@ -34,13 +34,19 @@
 #ifndef __MEM_RUBY_NETWORK_GARNET2_0_FLITBUFFER_HH__
 #define __MEM_RUBY_NETWORK_GARNET2_0_FLITBUFFER_HH__
 
-#include <algorithm>
+#include <cassert>
 #include <iostream>
 #include <vector>
 
 #include "mem/ruby/network/garnet2.0/CommonTypes.hh"
 #include "mem/ruby/network/garnet2.0/flit.hh"
 
+// The flits are kept sorted by flit::greater (time, then id) in a ring of
+// power of two size. Almost every buffer receives its flits in time order,
+// so insert() appends at the tail and getTopFlit() pops the head, both
+// O(1). A flit that arrives out of order is moved back to its place. The
+// ring doubles when it is full, buffers bounded by credits (the input VCs)
+// are sized to their depth up front and never grow.
 class flitBuffer
 {
   public:
@@ -52,34 +58,47 @@ class flitBuffer
     void print(std::ostream& out) const;
     bool isFull();
     void setMaxSize(int maximum);
-    int getSize() const { return m_buffer.size(); }
+    int getSize() const { return m_count; }
 
     flit *
     getTopFlit()
     {
-        flit *f = m_buffer.front();
-        std::pop_heap(m_buffer.begin(), m_buffer.end(), flit::greater);
-        m_buffer.pop_back();
+        assert(m_count > 0);
+        flit *f = m_ring[m_head];
+        m_head = (m_head + 1) & m_mask;
+        m_count--;
         return f;
     }
 
     flit *
     peekTopFlit()
     {
-        return m_buffer.front();
+        assert(m_count > 0);
+        return m_ring[m_head];
     }
 
     void
     insert(flit *flt)
     {
-        m_buffer.push_back(flt);
-        std::push_heap(m_buffer.begin(), m_buffer.end(), flit::greater);
+        if (m_count == m_ring.size())
+            grow();
+        unsigned int tail = (m_head + m_count) & m_mask;
+        m_ring[tail] = flt;
+        m_count++;
+        if (m_count > 1 && flit::greater(m_ring[(tail - 1) & m_mask], flt))
+            sortTail();
     }
 
     uint32_t functionalWrite(Packet *pkt);
 
   private:
-    std::vector<flit *> m_buffer;
+    void grow();
+    void sortTail();
+
+    std::vector<flit *> m_ring;
+    unsigned int m_head;
+    unsigned int m_count;
+    unsigned int m_mask;
     int max_size;
 };
 
@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "mem/ruby/network/garnet2.0/flitBuffer.hh"
+
+// flit.cc brings in the protocol messages and the checkpoints, the
+// buffers only need the ordering of the flits
+bool
+flit::functionalWrite(Packet *pkt)
+{
+    return false;
+}
+
+class TestFlit : public flit
+{
+  public:
+    TestFlit(int id, Cycles time)
+    {
+        m_id = id;
+        m_time = time;
+    }
+};
+
+static std::vector<flit *>
+popAll(flitBuffer &buffer)
+{
+    std::vector<flit *> flits;
+    while (!buffer.isEmpty())
+        flits.push_back(buffer.getTopFlit());
+    return flits;
+}
+
+TEST(FlitBufferTest, InOrder)
+{
+    TestFlit a(0, Cycles(1)), b(1, Cycles(2)), c(2, Cycles(3));
+    flitBuffer buffer;
+    buffer.insert(&a);
+    buffer.insert(&b);
+    buffer.insert(&c);
+    EXPECT_EQ(3, buffer.getSize());
+
+    EXPECT_FALSE(buffer.isReady(Cycles(0)));
+    EXPECT_TRUE(buffer.isReady(Cycles(1)));
+    EXPECT_EQ(&a, buffer.peekTopFlit());
+
+    std::vector<flit *> expected = { &a, &b, &c };
+    EXPECT_EQ(expected, popAll(buffer));
+    EXPECT_FALSE(buffer.isReady(Cycles(10)));
+}
+
+TEST(FlitBufferTest, OutOfOrder)
+{
+    TestFlit a(0, Cycles(5)), b(1, Cycles(3)), c(2, Cycles(4)),
+        d(3, Cycles(1));
+    flitBuffer buffer;
+    buffer.insert(&a);
+    buffer.insert(&b);
+    buffer.insert(&c);
+    buffer.insert(&d);
+
+    std::vector<flit *> expected = { &d, &b, &c, &a };
+    EXPECT_EQ(expected, popAll(buffer));
+}
+
+TEST(FlitBufferTest, TiesById)
+{
+    TestFlit a(3, Cycles(2)), b(1, Cycles(2)), c(2, Cycles(2));
+    flitBuffer buffer;
+    buffer.insert(&a);
+    buffer.insert(&b);
+    buffer.insert(&c);
+
+    std::vector<flit *> expected = { &b, &c, &a };
+    EXPECT_EQ(expected, popAll(buffer));
+}
+
+// flits of the same time and id (the credits all have id 0) pop in the
+// order they came in
+TEST(FlitBufferTest, EqualFlitsInInsertionOrder)
+{
+    TestFlit a(0, Cycles(2)), b(0, Cycles(2)), c(0, Cycles(1)),
+        d(0, Cycles(2));
+    flitBuffer buffer;
+    buffer.insert(&a);
+    buffer.insert(&b);
+    buffer.insert(&c);
+    buffer.insert(&d);
+
+    std::vector<flit *> expected = { &c, &a, &b, &d };
+    EXPECT_EQ(expected, popAll(buffer));
+}
+
+// the ring wraps around and then doubles, a late flit is still moved
+// back across the end of the ring
+TEST(FlitBufferTest, GrowAcrossWrap)
+{
+    std::vector<TestFlit> flits;
+    for (int i = 0; i < 20; i++)
+        flits.push_back(TestFlit(i, Cycles(10 + i)));
+    TestFlit late(100, Cycles(0));
+
+    flitBuffer buffer;
+    buffer.insert(&flits[0]);
+    buffer.insert(&flits[1]);
+    buffer.insert(&flits[2]);
+    EXPECT_EQ(&flits[0], buffer.getTopFlit());
+    EXPECT_EQ(&flits[1], buffer.getTopFlit());
+    for (int i = 3; i < 20; i++)
+        buffer.insert(&flits[i]);
+    buffer.insert(&late);
+    EXPECT_EQ(19, buffer.getSize());
+
+    std::vector<flit *> expected = { &late };
+    for (int i = 2; i < 20; i++)
+        expected.push_back(&flits[i]);
+    EXPECT_EQ(expected, popAll(buffer));
+}
+
+TEST(FlitBufferTest, MaxSize)
+{
+    std::vector<TestFlit> flits;
+    for (int i = 0; i < 6; i++)
+        flits.push_back(TestFlit(i, Cycles(i)));
+
+    flitBuffer buffer(5);
+    for (int i = 0; i < 5; i++) {
+        EXPECT_FALSE(buffer.isFull());
+        buffer.insert(&flits[i]);
+    }
+    EXPECT_TRUE(buffer.isFull());
+
+    buffer.setMaxSize(6);
+    EXPECT_FALSE(buffer.isFull());
+    buffer.insert(&flits[5]);
+    EXPECT_TRUE(buffer.isFull());
+    EXPECT_EQ(&flits[0], buffer.getTopFlit());
+    EXPECT_FALSE(buffer.isFull());
+}